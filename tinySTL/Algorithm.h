@@ -0,0 +1,985 @@
+#ifndef _ALGORITHM_H_
+#define _ALGORITHM_H_
+
+#include "Functional.h"
+#include "Iterator.h"
+#include "Simd.h"
+#include "Utility.h"
+
+#include <cstring>
+#include <functional>
+#include <new>
+#include <type_traits>
+
+namespace tinySTL {
+
+	/*
+	** Every algorithm here first asks segmented_iterator_traits whether its
+	** range is made of contiguous segments (a deque range is). If so, it runs
+	** once per segment on the local pointers, so the inner loops are plain
+	** pointer loops the compiler can unroll and vectorise; the per-element
+	** bucket checks of the segmented iterator are paid once per segment.
+	**
+	** A flat range is then handled by its iterator_category. Raw pointers
+	** to integers or to float/double go to the vector kernels of Simd.h
+	** (SSE2, or AVX2 where the CPU has it) for find, count, min_element,
+	** max_element, mismatch, equal and fill; copy is already a memmove.
+	** Other iterators take the plain loops, and a random access range
+	** gets the cheaper loop where one exists.
+	*/
+
+	//********** [for_each] ******************************
+	namespace Detail {
+		// f goes by reference, so one function object sees the whole range
+		template<class InputIterator, class Function>
+		void for_each_aux(InputIterator first, InputIterator last, Function& f, std::false_type) {
+			for (; first != last; ++first) {
+				f(*first);
+			}
+		}
+		template<class SegmentedIterator, class Function>
+		void for_each_aux(SegmentedIterator first, SegmentedIterator last, Function& f, std::true_type) {
+			typedef segmented_iterator_traits<SegmentedIterator> traits;
+			typename traits::segment_iterator sfirst = traits::segment(first), slast = traits::segment(last);
+			if (sfirst == slast) {
+				for_each_aux(traits::local(first), traits::local(last), f, std::false_type());
+				return;
+			}
+			for_each_aux(traits::local(first), traits::end(sfirst), f, std::false_type());
+			for (++sfirst; sfirst != slast; ++sfirst) {
+				for_each_aux(traits::begin(sfirst), traits::end(sfirst), f, std::false_type());
+			}
+			for_each_aux(traits::begin(slast), traits::local(last), f, std::false_type());
+		}
+	}// namespace Detail
+
+	template<class InputIterator, class Function>
+	Function for_each(InputIterator first, InputIterator last, Function f) {
+		typedef typename segmented_iterator_traits<InputIterator>::is_segmented_iterator segmented;
+		Detail::for_each_aux(first, last, f, segmented());
+		return f;
+	}
+
+	//********** [fill] **********************************
+	template<class ForwardIterator, class T>
+	void fill(ForwardIterator first, ForwardIterator last, const T& value);
+
+	namespace Detail {
+		template<class ForwardIterator, class T>
+		void fill_flat(ForwardIterator first, ForwardIterator last, const T& value, forward_iterator_tag) {
+			for (; first != last; ++first) {
+				*first = value;
+			}
+		}
+		template<class E, class T>
+		void fill_ptr(E *first, E *last, const T& value, std::false_type) {
+			fill_flat(first, last, value, forward_iterator_tag());
+		}
+		// the value is converted once, as each assignment would
+		template<class E, class T>
+		void fill_ptr(E *first, E *last, const T& value, std::true_type) {
+			const E x = static_cast<E>(value);
+			if (sizeof(E) == 1) {
+				if (first != last) memset(first, static_cast<unsigned char>(x), last - first);
+			}
+			else {
+				simd_fill(first, static_cast<size_t>(last - first), x);
+			}
+		}
+		template<class E, class T>
+		void fill_flat(E *first, E *last, const T& value, random_access_iterator_tag) {
+			typedef std::integral_constant<bool, simd_element<E>::value && !std::is_const<E>::value
+				&& std::is_arithmetic<T>::value> vectorise;
+			fill_ptr(first, last, value, vectorise());
+		}
+		// any other contiguous iterator takes the pointer path on its addresses
+		template<class ContiguousIterator, class T>
+		void fill_flat(ContiguousIterator first, ContiguousIterator last, const T& value, contiguous_iterator_tag) {
+			typedef decltype(tinySTL::to_address(first)) pointer;
+			pointer p = tinySTL::to_address(first);
+			fill_flat(p, p + (last - first), value, random_access_iterator_tag());
+		}
+
+		template<class ForwardIterator, class T>
+		void fill_aux(ForwardIterator first, ForwardIterator last, const T& value, std::false_type) {
+			fill_flat(first, last, value, typename iterator_traits<ForwardIterator>::iterator_category());
+		}
+		template<class SegmentedIterator, class T>
+		void fill_aux(SegmentedIterator first, SegmentedIterator last, const T& value, std::true_type) {
+			typedef segmented_iterator_traits<SegmentedIterator> traits;
+			typename traits::segment_iterator sfirst = traits::segment(first), slast = traits::segment(last);
+			if (sfirst == slast) {
+				tinySTL::fill(traits::local(first), traits::local(last), value);
+				return;
+			}
+			tinySTL::fill(traits::local(first), traits::end(sfirst), value);
+			for (++sfirst; sfirst != slast; ++sfirst) {
+				tinySTL::fill(traits::begin(sfirst), traits::end(sfirst), value);
+			}
+			tinySTL::fill(traits::begin(slast), traits::local(last), value);
+		}
+	}// namespace Detail
+
+	template<class ForwardIterator, class T>
+	void fill(ForwardIterator first, ForwardIterator last, const T& value) {
+		typedef typename segmented_iterator_traits<ForwardIterator>::is_segmented_iterator segmented;
+		Detail::fill_aux(first, last, value, segmented());
+	}
+
+	//********** [find] **********************************
+	template<class InputIterator, class T>
+	InputIterator find(InputIterator first, InputIterator last, const T& value);
+
+	namespace Detail {
+		/*
+		** An integer value is looked for among integer elements the way ==
+		** would compare them: an element equals value exactly when it equals
+		** value converted to the element type, and that conversion still
+		** equals value. Any other value is only vectorised among elements of
+		** its own type.
+		*/
+		template<class E, class T, class U = typename std::remove_cv<E>::type>
+		struct simd_find_value : std::integral_constant<bool, simd_element<E>::value
+			&& (std::is_same<U, T>::value || (std::is_integral<U>::value && std::is_integral<T>::value
+				&& !std::is_same<U, bool>::value && !std::is_same<T, bool>::value))> {};
+
+		// the element type's own copy of value; false if no element can equal value
+		template<class U, class T>
+		bool simd_key(const T& value, U& key) {
+			typedef typename std::common_type<U, T>::type common;
+			key = static_cast<U>(value);
+			return static_cast<common>(key) == static_cast<common>(value);
+		}
+
+		template<class InputIterator, class T>
+		InputIterator find_flat(InputIterator first, InputIterator last, const T& value, input_iterator_tag) {
+			for (; first != last; ++first) {
+				if (*first == value) break;
+			}
+			return first;
+		}
+		// four compares per check of the trip count
+		template<class RandomAccessIterator, class T>
+		RandomAccessIterator find_flat(RandomAccessIterator first, RandomAccessIterator last, const T& value, random_access_iterator_tag) {
+			for (typename iterator_traits<RandomAccessIterator>::difference_type trips = (last - first) / 4; trips > 0; --trips) {
+				if (*first == value) return first;
+				++first;
+				if (*first == value) return first;
+				++first;
+				if (*first == value) return first;
+				++first;
+				if (*first == value) return first;
+				++first;
+			}
+			return find_flat(first, last, value, input_iterator_tag());
+		}
+		template<class E, class T>
+		E *find_ptr(E *first, E *last, const T& value, std::false_type) {
+			return find_flat<E*>(first, last, value, random_access_iterator_tag());
+		}
+		template<class E, class T>
+		E *find_ptr(E *first, E *last, const T& value, std::true_type) {
+			typedef typename std::remove_cv<E>::type U;
+			U key;
+			if (!simd_key(value, key)) return last;
+			return first + simd_find(static_cast<const U *>(first), static_cast<size_t>(last - first), key);
+		}
+		template<class E, class T>
+		E *find_flat(E *first, E *last, const T& value, random_access_iterator_tag) {
+			return find_ptr(first, last, value, simd_find_value<E, T>());
+		}
+		template<class ContiguousIterator, class T>
+		ContiguousIterator find_flat(ContiguousIterator first, ContiguousIterator last, const T& value, contiguous_iterator_tag) {
+			typedef decltype(tinySTL::to_address(first)) pointer;
+			pointer p = tinySTL::to_address(first);
+			return first + (find_flat(p, p + (last - first), value, random_access_iterator_tag()) - p);
+		}
+
+		template<class InputIterator, class T>
+		InputIterator find_aux(InputIterator first, InputIterator last, const T& value, std::false_type) {
+			return find_flat(first, last, value, typename iterator_traits<InputIterator>::iterator_category());
+		}
+		template<class SegmentedIterator, class T>
+		SegmentedIterator find_aux(SegmentedIterator first, SegmentedIterator last, const T& value, std::true_type) {
+			typedef segmented_iterator_traits<SegmentedIterator> traits;
+			typename traits::segment_iterator sfirst = traits::segment(first), slast = traits::segment(last);
+			if (sfirst == slast) {
+				return traits::compose(sfirst, tinySTL::find(traits::local(first), traits::local(last), value));
+			}
+			typename traits::local_iterator lend = traits::end(sfirst);
+			typename traits::local_iterator it = tinySTL::find(traits::local(first), lend, value);
+			if (it != lend) return traits::compose(sfirst, it);
+			for (++sfirst; sfirst != slast; ++sfirst) {
+				lend = traits::end(sfirst);
+				it = tinySTL::find(traits::begin(sfirst), lend, value);
+				if (it != lend) return traits::compose(sfirst, it);
+			}
+			return traits::compose(slast, tinySTL::find(traits::begin(slast), traits::local(last), value));
+		}
+	}// namespace Detail
+
+	template<class InputIterator, class T>
+	InputIterator find(InputIterator first, InputIterator last, const T& value) {
+		typedef typename segmented_iterator_traits<InputIterator>::is_segmented_iterator segmented;
+		return Detail::find_aux(first, last, value, segmented());
+	}
+
+	//********** [count] *********************************
+	template<class InputIterator, class T>
+	typename iterator_traits<InputIterator>::difference_type count(InputIterator first, InputIterator last, const T& value);
+
+	namespace Detail {
+		template<class InputIterator, class T>
+		typename iterator_traits<InputIterator>::difference_type count_flat(InputIterator first, InputIterator last,
+			const T& value, input_iterator_tag) {
+			typename iterator_traits<InputIterator>::difference_type n = 0;
+			for (; first != last; ++first) {
+				if (*first == value) ++n;
+			}
+			return n;
+		}
+		template<class E, class T>
+		ptrdiff_t count_ptr(E *first, E *last, const T& value, std::false_type) {
+			return count_flat(first, last, value, input_iterator_tag());
+		}
+		template<class E, class T>
+		ptrdiff_t count_ptr(E *first, E *last, const T& value, std::true_type) {
+			typedef typename std::remove_cv<E>::type U;
+			U key;
+			if (!simd_key(value, key)) return 0;
+			return simd_count(static_cast<const U *>(first), static_cast<size_t>(last - first), key);
+		}
+		template<class E, class T>
+		ptrdiff_t count_flat(E *first, E *last, const T& value, random_access_iterator_tag) {
+			return count_ptr(first, last, value, simd_find_value<E, T>());
+		}
+		template<class ContiguousIterator, class T>
+		ptrdiff_t count_flat(ContiguousIterator first, ContiguousIterator last, const T& value, contiguous_iterator_tag) {
+			typedef decltype(tinySTL::to_address(first)) pointer;
+			pointer p = tinySTL::to_address(first);
+			return count_flat(p, p + (last - first), value, random_access_iterator_tag());
+		}
+
+		template<class InputIterator, class T>
+		typename iterator_traits<InputIterator>::difference_type count_aux(InputIterator first, InputIterator last,
+			const T& value, std::false_type) {
+			return count_flat(first, last, value, typename iterator_traits<InputIterator>::iterator_category());
+		}
+		template<class SegmentedIterator, class T>
+		typename iterator_traits<SegmentedIterator>::difference_type count_aux(SegmentedIterator first, SegmentedIterator last,
+			const T& value, std::true_type) {
+			typedef segmented_iterator_traits<SegmentedIterator> traits;
+			typename traits::segment_iterator sfirst = traits::segment(first), slast = traits::segment(last);
+			if (sfirst == slast) {
+				return tinySTL::count(traits::local(first), traits::local(last), value);
+			}
+			typename iterator_traits<SegmentedIterator>::difference_type n = tinySTL::count(traits::local(first), traits::end(sfirst), value);
+			for (++sfirst; sfirst != slast; ++sfirst) {
+				n += tinySTL::count(traits::begin(sfirst), traits::end(sfirst), value);
+			}
+			return n + tinySTL::count(traits::begin(slast), traits::local(last), value);
+		}
+	}// namespace Detail
+
+	template<class InputIterator, class T>
+	typename iterator_traits<InputIterator>::difference_type count(InputIterator first, InputIterator last, const T& value) {
+		typedef typename segmented_iterator_traits<InputIterator>::is_segmented_iterator segmented;
+		return Detail::count_aux(first, last, value, segmented());
+	}
+
+	//********** [min_element, max_element] **************
+	/*
+	** One implementation for both, told apart by Max (false_type for min).
+	** The best element so far is replaced only by a strictly better one, so
+	** both return the first of equal candidates.
+	*/
+	namespace Detail {
+		struct less_op {
+			template<class T, class U>
+			bool operator()(const T& x, const U& y) const { return x < y; }
+		};
+
+		template<class Compare, class T, class U>
+		bool beats(Compare& comp, const T& x, const U& best, std::false_type) { return comp(x, best); }
+		template<class Compare, class T, class U>
+		bool beats(Compare& comp, const T& x, const U& best, std::true_type) { return comp(best, x); }
+
+		// integers under plain <: the kernels find the value with vector compares, then its first place
+		template<class Compare, class E, class U = typename std::remove_cv<E>::type>
+		struct simd_extreme_compare : std::integral_constant<bool, simd_element<E>::value && std::is_integral<U>::value
+			&& (std::is_same<Compare, less_op>::value || std::is_same<Compare, less<U> >::value
+				|| std::is_same<Compare, std::less<U> >::value)> {};
+
+		template<class ForwardIterator, class Compare, class Max>
+		ForwardIterator extreme_flat(ForwardIterator first, ForwardIterator last, Compare& comp, Max, forward_iterator_tag) {
+			if (first == last) return last;
+			ForwardIterator best = first;
+			while (++first != last) {
+				if (beats(comp, *first, *best, Max())) best = first;
+			}
+			return best;
+		}
+		template<class E, class Compare, class Max>
+		E *extreme_ptr(E *first, E *last, Compare& comp, Max, std::false_type) {
+			return extreme_flat(first, last, comp, Max(), forward_iterator_tag());
+		}
+		template<class E, class Compare, class Max>
+		E *extreme_ptr(E *first, E *last, Compare&, Max, std::true_type) {
+			typedef typename std::remove_cv<E>::type U;
+			if (first == last) return last;
+			return first + simd_extreme<U, Max::value>(static_cast<const U *>(first), static_cast<size_t>(last - first));
+		}
+		template<class E, class Compare, class Max>
+		E *extreme_flat(E *first, E *last, Compare& comp, Max, random_access_iterator_tag) {
+			return extreme_ptr(first, last, comp, Max(), simd_extreme_compare<Compare, E>());
+		}
+		template<class ContiguousIterator, class Compare, class Max>
+		ContiguousIterator extreme_flat(ContiguousIterator first, ContiguousIterator last, Compare& comp, Max, contiguous_iterator_tag) {
+			typedef decltype(tinySTL::to_address(first)) pointer;
+			pointer p = tinySTL::to_address(first);
+			return first + (extreme_flat(p, p + (last - first), comp, Max(), random_access_iterator_tag()) - p);
+		}
+
+		template<class ForwardIterator, class Compare, class Max>
+		ForwardIterator extreme_aux(ForwardIterator first, ForwardIterator last, Compare& comp, Max, std::false_type) {
+			return extreme_flat(first, last, comp, Max(), typename iterator_traits<ForwardIterator>::iterator_category());
+		}
+		// the best of one piece of a segmented range against the best so far (last while there is none)
+		template<class SegmentedIterator, class Compare, class Max>
+		void extreme_piece(SegmentedIterator& best, SegmentedIterator last,
+			typename segmented_iterator_traits<SegmentedIterator>::segment_iterator seg,
+			typename segmented_iterator_traits<SegmentedIterator>::local_iterator first,
+			typename segmented_iterator_traits<SegmentedIterator>::local_iterator llast, Compare& comp, Max) {
+			typename segmented_iterator_traits<SegmentedIterator>::local_iterator it = extreme_aux(first, llast, comp, Max(), std::false_type());
+			if (it != llast && (best == last || beats(comp, *it, *best, Max()))) {
+				best = segmented_iterator_traits<SegmentedIterator>::compose(seg, it);
+			}
+		}
+		template<class SegmentedIterator, class Compare, class Max>
+		SegmentedIterator extreme_aux(SegmentedIterator first, SegmentedIterator last, Compare& comp, Max, std::true_type) {
+			typedef segmented_iterator_traits<SegmentedIterator> traits;
+			typename traits::segment_iterator sfirst = traits::segment(first), slast = traits::segment(last);
+			if (sfirst == slast) {
+				return traits::compose(sfirst, extreme_aux(traits::local(first), traits::local(last), comp, Max(), std::false_type()));
+			}
+			SegmentedIterator best = last;
+			extreme_piece(best, last, sfirst, traits::local(first), traits::end(sfirst), comp, Max());
+			for (++sfirst; sfirst != slast; ++sfirst) {
+				extreme_piece(best, last, sfirst, traits::begin(sfirst), traits::end(sfirst), comp, Max());
+			}
+			extreme_piece(best, last, slast, traits::begin(slast), traits::local(last), comp, Max());
+			return best;
+		}
+	}// namespace Detail
+
+	template<class ForwardIterator, class Compare>
+	ForwardIterator min_element(ForwardIterator first, ForwardIterator last, Compare comp) {
+		typedef typename segmented_iterator_traits<ForwardIterator>::is_segmented_iterator segmented;
+		return Detail::extreme_aux(first, last, comp, std::false_type(), segmented());
+	}
+	template<class ForwardIterator>
+	ForwardIterator min_element(ForwardIterator first, ForwardIterator last) {
+		return tinySTL::min_element(first, last, Detail::less_op());
+	}
+	template<class ForwardIterator, class Compare>
+	ForwardIterator max_element(ForwardIterator first, ForwardIterator last, Compare comp) {
+		typedef typename segmented_iterator_traits<ForwardIterator>::is_segmented_iterator segmented;
+		return Detail::extreme_aux(first, last, comp, std::true_type(), segmented());
+	}
+	template<class ForwardIterator>
+	ForwardIterator max_element(ForwardIterator first, ForwardIterator last) {
+		return tinySTL::max_element(first, last, Detail::less_op());
+	}
+
+	//********** [mismatch, equal] ***********************
+	template<class InputIterator1, class InputIterator2, class BinaryPredicate>
+	pair<InputIterator1, InputIterator2> mismatch(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, BinaryPredicate pred);
+
+	namespace Detail {
+		struct equal_op {
+			template<class T, class U>
+			bool operator()(const T& x, const U& y) const { return x == y; }
+		};
+
+		template<class Pred, class U>
+		struct simd_equal_pred : std::integral_constant<bool, std::is_same<Pred, equal_op>::value
+			|| std::is_same<Pred, equal_to<U> >::value || std::is_same<Pred, equal_to<> >::value
+			|| std::is_same<Pred, std::equal_to<U> >::value> {};
+
+		template<class InputIterator1, class InputIterator2, class BinaryPredicate>
+		pair<InputIterator1, InputIterator2> mismatch_flat(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2,
+			BinaryPredicate& pred, input_iterator_tag) {
+			while (first1 != last1 && pred(*first1, *first2)) {
+				++first1;
+				++first2;
+			}
+			return pair<InputIterator1, InputIterator2>(first1, first2);
+		}
+		template<class E1, class InputIterator2, class BinaryPredicate>
+		pair<E1*, InputIterator2> mismatch_ptr(E1 *first1, E1 *last1, InputIterator2 first2, BinaryPredicate& pred, std::false_type) {
+			return mismatch_flat(first1, last1, first2, pred, input_iterator_tag());
+		}
+		template<class E1, class E2, class BinaryPredicate>
+		pair<E1*, E2*> mismatch_ptr(E1 *first1, E1 *last1, E2 *first2, BinaryPredicate&, std::true_type) {
+			typedef typename std::remove_cv<E1>::type U;
+			size_t n = simd_mismatch(static_cast<const U *>(first1), static_cast<const U *>(first2), static_cast<size_t>(last1 - first1));
+			return pair<E1*, E2*>(first1 + n, first2 + n);
+		}
+		// both sides pointers to one element type, compared with ==
+		template<class E1, class InputIterator2, class BinaryPredicate>
+		pair<E1*, InputIterator2> mismatch_flat(E1 *first1, E1 *last1, InputIterator2 first2, BinaryPredicate& pred, random_access_iterator_tag) {
+			typedef typename std::remove_cv<E1>::type U;
+			typedef std::integral_constant<bool, std::is_pointer<InputIterator2>::value && simd_element<E1>::value
+				&& simd_element<typename std::remove_pointer<InputIterator2>::type>::value
+				&& std::is_same<U, typename std::remove_cv<typename std::remove_pointer<InputIterator2>::type>::type>::value
+				&& simd_equal_pred<BinaryPredicate, U>::value> vectorise;
+			return mismatch_ptr(first1, last1, first2, pred, vectorise());
+		}
+		// the second side is taken to its addresses too when it is contiguous
+		template<class ContiguousIterator, class InputIterator2, class BinaryPredicate>
+		pair<ContiguousIterator, InputIterator2> mismatch_contiguous(ContiguousIterator first1, ContiguousIterator last1,
+			InputIterator2 first2, BinaryPredicate& pred, std::false_type) {
+			typedef decltype(tinySTL::to_address(first1)) pointer;
+			pointer p = tinySTL::to_address(first1);
+			pair<pointer, InputIterator2> r = mismatch_flat(p, p + (last1 - first1), first2, pred, random_access_iterator_tag());
+			return pair<ContiguousIterator, InputIterator2>(first1 + (r.first - p), r.second);
+		}
+		template<class ContiguousIterator1, class ContiguousIterator2, class BinaryPredicate>
+		pair<ContiguousIterator1, ContiguousIterator2> mismatch_contiguous(ContiguousIterator1 first1, ContiguousIterator1 last1,
+			ContiguousIterator2 first2, BinaryPredicate& pred, std::true_type) {
+			typedef decltype(tinySTL::to_address(first1)) pointer1;
+			typedef decltype(tinySTL::to_address(first2)) pointer2;
+			pointer1 p1 = tinySTL::to_address(first1);
+			pointer2 p2 = tinySTL::to_address(first2);
+			pair<pointer1, pointer2> r = mismatch_flat(p1, p1 + (last1 - first1), p2, pred, random_access_iterator_tag());
+			return pair<ContiguousIterator1, ContiguousIterator2>(first1 + (r.first - p1), first2 + (r.second - p2));
+		}
+		template<class ContiguousIterator, class InputIterator2, class BinaryPredicate>
+		pair<ContiguousIterator, InputIterator2> mismatch_flat(ContiguousIterator first1, ContiguousIterator last1, InputIterator2 first2,
+			BinaryPredicate& pred, contiguous_iterator_tag) {
+			return mismatch_contiguous(first1, last1, first2, pred, is_contiguous_iterator<InputIterator2>());
+		}
+
+		template<class InputIterator1, class InputIterator2, class BinaryPredicate>
+		pair<InputIterator1, InputIterator2> mismatch_aux(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2,
+			BinaryPredicate& pred, std::false_type) {
+			return mismatch_flat(first1, last1, first2, pred, typename iterator_traits<InputIterator1>::iterator_category());
+		}
+		// the first range is walked segment by segment; the second just follows
+		template<class SegmentedIterator, class InputIterator2, class BinaryPredicate>
+		pair<SegmentedIterator, InputIterator2> mismatch_aux(SegmentedIterator first1, SegmentedIterator last1, InputIterator2 first2,
+			BinaryPredicate& pred, std::true_type) {
+			typedef segmented_iterator_traits<SegmentedIterator> traits;
+			typedef pair<SegmentedIterator, InputIterator2> result;
+			typename traits::segment_iterator sfirst = traits::segment(first1), slast = traits::segment(last1);
+			if (sfirst == slast) {
+				pair<typename traits::local_iterator, InputIterator2> r = tinySTL::mismatch(traits::local(first1), traits::local(last1), first2, pred);
+				return result(traits::compose(sfirst, r.first), r.second);
+			}
+			typename traits::local_iterator lend = traits::end(sfirst);
+			pair<typename traits::local_iterator, InputIterator2> r = tinySTL::mismatch(traits::local(first1), lend, first2, pred);
+			if (r.first != lend) return result(traits::compose(sfirst, r.first), r.second);
+			for (++sfirst; sfirst != slast; ++sfirst) {
+				lend = traits::end(sfirst);
+				r = tinySTL::mismatch(traits::begin(sfirst), lend, r.second, pred);
+				if (r.first != lend) return result(traits::compose(sfirst, r.first), r.second);
+			}
+			r = tinySTL::mismatch(traits::begin(slast), traits::local(last1), r.second, pred);
+			return result(traits::compose(slast, r.first), r.second);
+		}
+
+		// with both lengths known the shorter one bounds the three iterator version
+		template<class RandomAccessIterator1, class RandomAccessIterator2, class BinaryPredicate>
+		pair<RandomAccessIterator1, RandomAccessIterator2> mismatch_bounded(RandomAccessIterator1 first1, RandomAccessIterator1 last1,
+			RandomAccessIterator2 first2, RandomAccessIterator2 last2, BinaryPredicate& pred, random_access_iterator_tag, random_access_iterator_tag) {
+			if (last2 - first2 < last1 - first1) {
+				last1 = first1 + (last2 - first2);
+			}
+			return tinySTL::mismatch(first1, last1, first2, pred);
+		}
+		template<class InputIterator1, class InputIterator2, class BinaryPredicate>
+		pair<InputIterator1, InputIterator2> mismatch_bounded(InputIterator1 first1, InputIterator1 last1,
+			InputIterator2 first2, InputIterator2 last2, BinaryPredicate& pred, input_iterator_tag, input_iterator_tag) {
+			while (first1 != last1 && first2 != last2 && pred(*first1, *first2)) {
+				++first1;
+				++first2;
+			}
+			return pair<InputIterator1, InputIterator2>(first1, first2);
+		}
+	}// namespace Detail
+
+	template<class InputIterator1, class InputIterator2, class BinaryPredicate>
+	pair<InputIterator1, InputIterator2> mismatch(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, BinaryPredicate pred) {
+		typedef typename segmented_iterator_traits<InputIterator1>::is_segmented_iterator segmented;
+		return Detail::mismatch_aux(first1, last1, first2, pred, segmented());
+	}
+	template<class InputIterator1, class InputIterator2>
+	pair<InputIterator1, InputIterator2> mismatch(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2) {
+		return tinySTL::mismatch(first1, last1, first2, Detail::equal_op());
+	}
+	template<class InputIterator1, class InputIterator2, class BinaryPredicate>
+	pair<InputIterator1, InputIterator2> mismatch(InputIterator1 first1, InputIterator1 last1,
+		InputIterator2 first2, InputIterator2 last2, BinaryPredicate pred) {
+		return Detail::mismatch_bounded(first1, last1, first2, last2, pred,
+			typename iterator_traits<InputIterator1>::iterator_category(), typename iterator_traits<InputIterator2>::iterator_category());
+	}
+	template<class InputIterator1, class InputIterator2>
+	pair<InputIterator1, InputIterator2> mismatch(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2) {
+		return tinySTL::mismatch(first1, last1, first2, last2, Detail::equal_op());
+	}
+
+	template<class InputIterator1, class InputIterator2, class BinaryPredicate>
+	bool equal(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, BinaryPredicate pred) {
+		return tinySTL::mismatch(first1, last1, first2, pred).first == last1;
+	}
+	template<class InputIterator1, class InputIterator2>
+	bool equal(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2) {
+		return tinySTL::equal(first1, last1, first2, Detail::equal_op());
+	}
+
+	namespace Detail {
+		// ranges of different lengths are not equal, and random access ones say so up front
+		template<class RandomAccessIterator1, class RandomAccessIterator2, class BinaryPredicate>
+		bool equal_bounded(RandomAccessIterator1 first1, RandomAccessIterator1 last1, RandomAccessIterator2 first2, RandomAccessIterator2 last2,
+			BinaryPredicate& pred, random_access_iterator_tag, random_access_iterator_tag) {
+			if (last1 - first1 != last2 - first2) return false;
+			return tinySTL::equal(first1, last1, first2, pred);
+		}
+		template<class InputIterator1, class InputIterator2, class BinaryPredicate>
+		bool equal_bounded(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2,
+			BinaryPredicate& pred, input_iterator_tag, input_iterator_tag) {
+			pair<InputIterator1, InputIterator2> r = mismatch_bounded(first1, last1, first2, last2, pred, input_iterator_tag(), input_iterator_tag());
+			return r.first == last1 && r.second == last2;
+		}
+	}// namespace Detail
+
+	template<class InputIterator1, class InputIterator2, class BinaryPredicate>
+	bool equal(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2, BinaryPredicate pred) {
+		return Detail::equal_bounded(first1, last1, first2, last2, pred,
+			typename iterator_traits<InputIterator1>::iterator_category(), typename iterator_traits<InputIterator2>::iterator_category());
+	}
+	template<class InputIterator1, class InputIterator2>
+	bool equal(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2) {
+		return tinySTL::equal(first1, last1, first2, last2, Detail::equal_op());
+	}
+
+	//********** [accumulate] ****************************
+	template<class InputIterator, class T, class BinaryOperation>
+	T accumulate(InputIterator first, InputIterator last, T init, BinaryOperation op);
+
+	namespace Detail {
+		struct plus_op {
+			template<class T, class U>
+			T operator()(const T& x, const U& y) const { return x + y; }
+		};
+
+		template<class InputIterator, class T, class BinaryOperation>
+		T accumulate_aux(InputIterator first, InputIterator last, T init, BinaryOperation op, std::false_type) {
+			for (; first != last; ++first) {
+				init = op(init, *first);
+			}
+			return init;
+		}
+		template<class SegmentedIterator, class T, class BinaryOperation>
+		T accumulate_aux(SegmentedIterator first, SegmentedIterator last, T init, BinaryOperation op, std::true_type) {
+			typedef segmented_iterator_traits<SegmentedIterator> traits;
+			typename traits::segment_iterator sfirst = traits::segment(first), slast = traits::segment(last);
+			if (sfirst == slast) {
+				return tinySTL::accumulate(traits::local(first), traits::local(last), init, op);
+			}
+			init = tinySTL::accumulate(traits::local(first), traits::end(sfirst), init, op);
+			for (++sfirst; sfirst != slast; ++sfirst) {
+				init = tinySTL::accumulate(traits::begin(sfirst), traits::end(sfirst), init, op);
+			}
+			return tinySTL::accumulate(traits::begin(slast), traits::local(last), init, op);
+		}
+	}// namespace Detail
+
+	template<class InputIterator, class T, class BinaryOperation>
+	T accumulate(InputIterator first, InputIterator last, T init, BinaryOperation op) {
+		typedef typename segmented_iterator_traits<InputIterator>::is_segmented_iterator segmented;
+		return Detail::accumulate_aux(first, last, init, op, segmented());
+	}
+	template<class InputIterator, class T>
+	T accumulate(InputIterator first, InputIterator last, T init) {
+		return tinySTL::accumulate(first, last, init, Detail::plus_op());
+	}
+
+	//********** [reduce] ********************************
+	// accumulate whose op may be applied in any grouping and order, which lets the parallel overloads split the range
+	template<class InputIterator, class T, class BinaryOperation>
+	T reduce(InputIterator first, InputIterator last, T init, BinaryOperation op) {
+		return tinySTL::accumulate(first, last, init, op);
+	}
+	template<class InputIterator, class T>
+	T reduce(InputIterator first, InputIterator last, T init) {
+		return tinySTL::accumulate(first, last, init, Detail::plus_op());
+	}
+	template<class InputIterator>
+	typename iterator_traits<InputIterator>::value_type reduce(InputIterator first, InputIterator last) {
+		typedef typename iterator_traits<InputIterator>::value_type value_type;
+		return tinySTL::accumulate(first, last, value_type(), Detail::plus_op());
+	}
+
+	//********** [transform] *****************************
+	template<class InputIterator, class OutputIterator, class UnaryOperation>
+	OutputIterator transform(InputIterator first, InputIterator last, OutputIterator result, UnaryOperation op) {
+		for (; first != last; ++first, ++result) {
+			*result = op(*first);
+		}
+		return result;
+	}
+	template<class InputIterator1, class InputIterator2, class OutputIterator, class BinaryOperation>
+	OutputIterator transform(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2,
+		OutputIterator result, BinaryOperation op) {
+		for (; first1 != last1; ++first1, ++first2, ++result) {
+			*result = op(*first1, *first2);
+		}
+		return result;
+	}
+
+	//********** [copy] **********************************
+	/*
+	** Both ends are split: a segmented source is copied segment by segment,
+	** and each source piece is cut at the bucket ends of a segmented
+	** destination. Pointer pieces of one trivially copyable type end up in
+	** memmove, and so do contiguous iterators, taken to their addresses.
+	*/
+	template<class InputIterator, class OutputIterator>
+	OutputIterator copy(InputIterator first, InputIterator last, OutputIterator result);
+
+	namespace Detail {
+		template<class T>
+		T *copy_flat(const T *first, const T *last, T *result, std::true_type) {
+			size_t n = last - first;
+			if (n != 0) memmove(static_cast<void*>(result), first, n * sizeof(T));
+			return result + n;
+		}
+		template<class InputIterator, class OutputIterator>
+		OutputIterator copy_flat(InputIterator first, InputIterator last, OutputIterator result, std::false_type) {
+			for (; first != last; ++first, ++result) {
+				*result = *first;
+			}
+			return result;
+		}
+		template<class T>
+		T *copy_flat(T *first, T *last, T *result) {
+			return copy_flat(static_cast<const T *>(first), static_cast<const T *>(last), result,
+				std::is_trivially_copy_assignable<T>());
+		}
+		template<class T>
+		T *copy_flat(const T *first, const T *last, T *result) {
+			return copy_flat(first, last, result, std::is_trivially_copy_assignable<T>());
+		}
+		template<class InputIterator, class OutputIterator>
+		OutputIterator copy_flat(InputIterator first, InputIterator last, OutputIterator result);
+
+		template<class InputIterator, class OutputIterator>
+		OutputIterator copy_contiguous(InputIterator first, InputIterator last, OutputIterator result, std::false_type) {
+			return copy_flat(first, last, result, std::false_type());
+		}
+		template<class ContiguousIterator1, class ContiguousIterator2>
+		ContiguousIterator2 copy_contiguous(ContiguousIterator1 first, ContiguousIterator1 last, ContiguousIterator2 result, std::true_type) {
+			typedef decltype(tinySTL::to_address(first)) pointer1;
+			typedef decltype(tinySTL::to_address(result)) pointer2;
+			pointer1 p1 = tinySTL::to_address(first);
+			pointer2 p2 = tinySTL::to_address(result);
+			return result + (copy_flat(p1, p1 + (last - first), p2) - p2);
+		}
+		// two raw pointers that get here differ in element type and are copied one by one
+		template<class InputIterator, class OutputIterator>
+		OutputIterator copy_flat(InputIterator first, InputIterator last, OutputIterator result) {
+			typedef std::integral_constant<bool, is_contiguous_iterator<InputIterator>::value && is_contiguous_iterator<OutputIterator>::value
+				&& !(std::is_pointer<InputIterator>::value && std::is_pointer<OutputIterator>::value)> unwrap;
+			return copy_contiguous(first, last, result, unwrap());
+		}
+
+		// destination side: only worth splitting when the source can say how long it is
+		template<class InputIterator, class OutputIterator>
+		OutputIterator copy_out(InputIterator first, InputIterator last, OutputIterator result, std::false_type) {
+			return copy_flat(first, last, result);
+		}
+		template<class RandomAccessIterator, class SegmentedIterator>
+		SegmentedIterator copy_out(RandomAccessIterator first, RandomAccessIterator last, SegmentedIterator result, std::true_type) {
+			typedef segmented_iterator_traits<SegmentedIterator> traits;
+			typename traits::segment_iterator seg = traits::segment(result);
+			typename traits::local_iterator local = traits::local(result);
+			while (first != last) {
+				if (local == traits::end(seg)) {
+					++seg;
+					local = traits::begin(seg);
+				}
+				ptrdiff_t n = last - first, room = traits::end(seg) - local;
+				if (room < n) n = room;
+				local = copy_flat(first, first + n, local);
+				first += n;
+			}
+			return traits::compose(seg, local);
+		}
+		template<class InputIterator, class OutputIterator>
+		OutputIterator copy_in(InputIterator first, InputIterator last, OutputIterator result, std::false_type) {
+			typedef typename std::integral_constant<bool,
+				segmented_iterator_traits<OutputIterator>::is_segmented_iterator::value &&
+				std::is_convertible<typename iterator_traits<InputIterator>::iterator_category, random_access_iterator_tag>::value> split;
+			return copy_out(first, last, result, split());
+		}
+		template<class SegmentedIterator, class OutputIterator>
+		OutputIterator copy_in(SegmentedIterator first, SegmentedIterator last, OutputIterator result, std::true_type) {
+			typedef segmented_iterator_traits<SegmentedIterator> traits;
+			typename traits::segment_iterator sfirst = traits::segment(first), slast = traits::segment(last);
+			if (sfirst == slast) {
+				return tinySTL::copy(traits::local(first), traits::local(last), result);
+			}
+			result = tinySTL::copy(traits::local(first), traits::end(sfirst), result);
+			for (++sfirst; sfirst != slast; ++sfirst) {
+				result = tinySTL::copy(traits::begin(sfirst), traits::end(sfirst), result);
+			}
+			return tinySTL::copy(traits::begin(slast), traits::local(last), result);
+		}
+	}// namespace Detail
+
+	template<class InputIterator, class OutputIterator>
+	OutputIterator copy(InputIterator first, InputIterator last, OutputIterator result) {
+		typedef typename segmented_iterator_traits<InputIterator>::is_segmented_iterator segmented;
+		return Detail::copy_in(first, last, result, segmented());
+	}
+
+	//********** [sort] **********************************
+	/*
+	** Introsort: quicksort on the median of three, with the recursion depth
+	** capped at 2 log n, past which the piece is heap sorted; pieces of at
+	** most INSERTION_SORT_MAX elements are left for one insertion sort pass
+	** over the whole range at the end. The helpers take the comparator by
+	** reference so the parallel sort of Execution.h can share one.
+	*/
+	namespace Detail {
+		enum EInsertionSort{ INSERTION_SORT_MAX = 16 };
+
+		// tinySTL::swap copies, which sorting a range of strings could not afford
+		template<class ForwardIterator>
+		void move_swap(ForwardIterator a, ForwardIterator b) {
+			typename iterator_traits<ForwardIterator>::value_type temp(std::move(*a));
+			*a = std::move(*b);
+			*b = std::move(temp);
+		}
+
+		// stable: an element only moves past the ones it is less than
+		template<class RandomAccessIterator, class Compare>
+		void insertion_sort(RandomAccessIterator first, RandomAccessIterator last, Compare& comp) {
+			if (first == last) return;
+			for (RandomAccessIterator i = first + 1; i != last; ++i) {
+				typename iterator_traits<RandomAccessIterator>::value_type x(std::move(*i));
+				RandomAccessIterator hole = i;
+				for (; hole != first && comp(x, *(hole - 1)); --hole) {
+					*hole = std::move(*(hole - 1));
+				}
+				*hole = std::move(x);
+			}
+		}
+
+		template<class RandomAccessIterator, class Distance, class Compare>
+		void sift_down(RandomAccessIterator first, Distance hole, Distance n, Compare& comp) {
+			typename iterator_traits<RandomAccessIterator>::value_type x(std::move(first[hole]));
+			for (Distance child = 2 * hole + 1; child < n; child = 2 * hole + 1) {
+				if (child + 1 < n && comp(first[child], first[child + 1])) ++child;
+				if (!comp(x, first[child])) break;
+				first[hole] = std::move(first[child]);
+				hole = child;
+			}
+			first[hole] = std::move(x);
+		}
+		template<class RandomAccessIterator, class Compare>
+		void heap_sort(RandomAccessIterator first, RandomAccessIterator last, Compare& comp) {
+			typedef typename iterator_traits<RandomAccessIterator>::difference_type difference_type;
+			difference_type n = last - first;
+			for (difference_type i = n / 2; i-- > 0;) {
+				sift_down(first, i, n, comp);
+			}
+			while (n > 1) {
+				--n;
+				move_swap(first, first + n);
+				sift_down(first, difference_type(0), n, comp);
+			}
+		}
+
+		// moves the median of *a, *b, *c to first; none of them is first
+		template<class RandomAccessIterator, class Compare>
+		void median_to_first(RandomAccessIterator first, RandomAccessIterator a,
+			RandomAccessIterator b, RandomAccessIterator c, Compare& comp) {
+			if (comp(*a, *b)) {
+				if (comp(*b, *c)) move_swap(first, b);
+				else if (comp(*a, *c)) move_swap(first, c);
+				else move_swap(first, a);
+			}
+			else if (comp(*a, *c)) move_swap(first, a);
+			else if (comp(*b, *c)) move_swap(first, c);
+			else move_swap(first, b);
+		}
+		/*
+		** Partitions [first + 1, last) around the median of three, kept at
+		** first, and returns where the part not less than it starts. The
+		** other two of the three stay in the range on either side of the
+		** pivot, so neither scan needs a bounds check. last - first > 3.
+		*/
+		template<class RandomAccessIterator, class Compare>
+		RandomAccessIterator partition_pivot(RandomAccessIterator first, RandomAccessIterator last, Compare& comp) {
+			median_to_first(first, first + 1, first + (last - first) / 2, last - 1, comp);
+			RandomAccessIterator lo = first + 1, hi = last;
+			for (;;) {
+				while (comp(*lo, *first)) ++lo;
+				--hi;
+				while (comp(*first, *hi)) --hi;
+				if (!(lo < hi)) return lo;
+				move_swap(lo, hi);
+				++lo;
+			}
+		}
+
+		inline size_t sort_depth(ptrdiff_t n) {
+			size_t depth = 0;
+			for (; n > 1; n >>= 1) depth += 2;
+			return depth;
+		}
+		template<class RandomAccessIterator, class Compare>
+		void introsort_loop(RandomAccessIterator first, RandomAccessIterator last, size_t depth, Compare& comp) {
+			while (last - first > INSERTION_SORT_MAX) {
+				if (depth == 0) {
+					heap_sort(first, last, comp);
+					return;
+				}
+				--depth;
+				RandomAccessIterator cut = partition_pivot(first, last, comp);
+				introsort_loop(cut, last, depth, comp);
+				last = cut;
+			}
+		}
+		template<class RandomAccessIterator, class Compare>
+		void sort_aux(RandomAccessIterator first, RandomAccessIterator last, Compare& comp) {
+			introsort_loop(first, last, sort_depth(last - first), comp);
+			insertion_sort(first, last, comp);
+		}
+	}// namespace Detail
+
+	template<class RandomAccessIterator, class Compare>
+	void sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+		Detail::sort_aux(first, last, comp);
+	}
+	template<class RandomAccessIterator>
+	void sort(RandomAccessIterator first, RandomAccessIterator last) {
+		tinySTL::sort(first, last, less<typename iterator_traits<RandomAccessIterator>::value_type>());
+	}
+
+	//********** [stable_sort] ***************************
+	/*
+	** Merge sort through a buffer as long as the range: the elements are
+	** moved into the buffer and sorted back into the range, each level of
+	** merges moving them from one to the other, so no level copies them
+	** back. Runs of at most INSERTION_SORT_MAX are insertion sorted.
+	*/
+	namespace Detail {
+		// raw memory holding elements moved out of a range; they are destroyed with it
+		template<class T>
+		class temporary_buffer {
+			private:
+				T *data_;
+				size_t size_;
+			public:
+				template<class InputIterator>
+				temporary_buffer(InputIterator first, size_t n)
+					:data_(static_cast<T*>(::operator new(n * sizeof(T)))), size_(0) {
+					try {
+						for (; size_ != n; ++size_, ++first) {
+							::new (static_cast<void*>(data_ + size_)) T(std::move(*first));
+						}
+					}
+					catch (...) {
+						release();
+						throw;
+					}
+				}
+				temporary_buffer(const temporary_buffer&) = delete;
+				temporary_buffer& operator = (const temporary_buffer&) = delete;
+				~temporary_buffer() { release(); }
+
+				T *data() const { return data_; }
+			private:
+				void release() {
+					for (; size_ != 0; --size_) {
+						data_[size_ - 1].~T();
+					}
+					::operator delete(data_);
+				}
+		};
+
+		// stable: on a tie the element of the first range goes first
+		template<class InputIterator1, class InputIterator2, class OutputIterator, class Compare>
+		OutputIterator merge_move(InputIterator1 first1, InputIterator1 last1,
+			InputIterator2 first2, InputIterator2 last2, OutputIterator result, Compare& comp) {
+			for (; first1 != last1 && first2 != last2; ++result) {
+				if (comp(*first2, *first1)) {
+					*result = std::move(*first2);
+					++first2;
+				}
+				else {
+					*result = std::move(*first1);
+					++first1;
+				}
+			}
+			for (; first1 != last1; ++first1, ++result) {
+				*result = std::move(*first1);
+			}
+			for (; first2 != last2; ++first2, ++result) {
+				*result = std::move(*first2);
+			}
+			return result;
+		}
+
+		// sorts [first, last) into itself, or into buf when toBuf; buf is as long as the range
+		template<class RandomAccessIterator1, class RandomAccessIterator2, class Compare>
+		void merge_sort(RandomAccessIterator1 first, RandomAccessIterator1 last,
+			RandomAccessIterator2 buf, Compare& comp, bool toBuf) {
+			typename iterator_traits<RandomAccessIterator1>::difference_type n = last - first, half = n / 2;
+			if (n <= INSERTION_SORT_MAX) {
+				insertion_sort(first, last, comp);
+				if (toBuf) {
+					for (; first != last; ++first, ++buf) {
+						*buf = std::move(*first);
+					}
+				}
+				return;
+			}
+			// each half ends up on the other side, so that merging brings it back
+			merge_sort(first, first + half, buf, comp, !toBuf);
+			merge_sort(first + half, last, buf + half, comp, !toBuf);
+			if (toBuf) {
+				merge_move(first, first + half, first + half, last, buf, comp);
+			}
+			else {
+				merge_move(buf, buf + half, buf + half, buf + n, first, comp);
+			}
+		}
+
+		template<class RandomAccessIterator, class Compare>
+		void stable_sort_aux(RandomAccessIterator first, RandomAccessIterator last, Compare& comp) {
+			typedef typename iterator_traits<RandomAccessIterator>::value_type value_type;
+			if (last - first <= INSERTION_SORT_MAX) {
+				insertion_sort(first, last, comp);
+				return;
+			}
+			temporary_buffer<value_type> buf(first, last - first);
+			// the buffer holds the elements now; the range is the scratch space the result lands in
+			merge_sort(buf.data(), buf.data() + (last - first), first, comp, true);
+		}
+	}// namespace Detail
+
+	template<class RandomAccessIterator, class Compare>
+	void stable_sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+		Detail::stable_sort_aux(first, last, comp);
+	}
+	template<class RandomAccessIterator>
+	void stable_sort(RandomAccessIterator first, RandomAccessIterator last) {
+		tinySTL::stable_sort(first, last, less<typename iterator_traits<RandomAccessIterator>::value_type>());
+	}
+} // namespace tinySTL
+
+#endif // _ALGORITHM_H_
@@ -0,0 +1,7 @@
+#include "Alloc.h"
+
+namespace tinySTL {
+
+	template class basic_alloc<size_class_table<> >;
+
+} // namespace tinySTL
@@ -1,44 +1,874 @@
 #ifndef _ALLOC_H_
 #define _ALLOC_H_
 
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+#include "AllocProfile.h"
+#include "ChunkSource.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 namespace tinySTL {
 
-	class alloc {
+	namespace Detail {
+		constexpr size_t LOG2(size_t n) {
+			return n <= 1 ? 0 : 1 + LOG2(n >> 1);
+		}
+
+		// index of the highest set bit, n != 0
+		inline size_t floor_log2(size_t n) {
+#if defined(_MSC_VER)
+			unsigned long r;
+#if defined(_WIN64)
+			_BitScanReverse64(&r, n);
+#else
+			_BitScanReverse(&r, n);
+#endif
+			return r;
+#else
+			return sizeof(unsigned long long) * 8 - 1 - __builtin_clzll(n);
+#endif
+		}
+	}
+
+	/*
+	** Size classes of basic_alloc. Requests up to SMALL_BYTES are rounded up to
+	** a multiple of ALIGN; above that every power of two is split into four
+	** geometric steps (160, 192, 224, 256, 320, ...) up to MAX_BYTES, so a pool
+	** covering several KB needs only a few dozen free lists. Every class size is
+	** a multiple of ALIGN and every block is ALIGN-aligned, which makes 16/32/64
+	** byte tables usable for SIMD payloads.
+	*/
+	template<size_t Align = 8, size_t SmallBytes = 128, size_t MaxBytes = 4096>
+	struct size_class_table {
+		enum EAlign{ ALIGN = Align };
+		enum ESmallBytes{ SMALL_BYTES = SmallBytes };
+		enum EMaxBytes{ MAX_BYTES = MaxBytes };
+		enum ENClasses{ NCLASSES = SmallBytes / Align + 4 * (Detail::LOG2(MaxBytes) - Detail::LOG2(SmallBytes)) };
+
+		static_assert(Align >= sizeof(void *) && (Align & (Align - 1)) == 0,
+			"ALIGN must be a power of two that can hold a pointer");
+		static_assert((SmallBytes & (SmallBytes - 1)) == 0 && SmallBytes >= 4 * Align,
+			"SMALL_BYTES must be a power of two of at least four ALIGN steps");
+		static_assert((MaxBytes & (MaxBytes - 1)) == 0 && MaxBytes >= SmallBytes,
+			"MAX_BYTES must be a power of two not below SMALL_BYTES");
+
+		// bytes <= MAX_BYTES; 0 bytes is the smallest class, so allocate(0) and deallocate(p, 0) agree
+		static size_t index(size_t bytes) {
+			if (bytes <= SmallBytes) {
+				return (bytes - (bytes != 0)) / Align;
+			}
+			size_t lg = Detail::floor_log2(bytes - 1);
+			size_t quarter = ((bytes - 1) >> (lg - 2)) & 3;
+			return SmallBytes / Align + (lg - Detail::LOG2(SmallBytes)) * 4 + quarter;
+		}
+		static size_t class_size(size_t index) {
+			if (index < SmallBytes / Align) {
+				return (index + 1) * Align;
+			}
+			size_t step = index - SmallBytes / Align;
+			size_t lg = Detail::LOG2(SmallBytes) + step / 4;
+			return (5 + step % 4) << (lg - 2);
+		}
+	};
+
+	/*
+	** Small-object pool. Every thread owns a cache of the size-class free lists,
+	** so allocate/deallocate touch no shared state on the fast path. The shared
+	** central pool (free_list, start_free, end_free, heap_size) is only entered,
+	** under central_lock, to refill an empty thread list or to drain an overlong
+	** one, and always moves a whole batch of blocks at a time.
+	**
+	** The batch of each size class adapts per thread: it starts at MIN_OBJS and
+	** doubles up to MAX_OBJS (or BATCH_BYTES worth of blocks) every time the list
+	** runs dry, and a thread list is drained once it holds more than two batches.
+	** Hot classes therefore rarely go back to the central pool while cold classes
+	** strand only a few blocks.
+	**
+	** Chunks come from ChunkSource (see ChunkSource.h): malloc by default, or
+	** mmap_chunk_source for huge-page backed pools. Every chunk starts with a
+	** chunk_header so the pool can find chunks whose blocks have all come back
+	** to the central lists and hand them back to the source, either on an
+	** explicit trim() or automatically once the central lists hold more than
+	** set_trim_threshold() bytes.
+	**
+	** profile() and dump() report the pool counters. With TINYSTL_ALLOC_PROFILE
+	** (see AllocProfile.h) every thread also counts its allocations and frees
+	** and samples the stack of one allocation per set_sample_interval() bytes;
+	** those counters reach the central pool whenever the thread does.
+	*/
+	template<class SizeClasses, class ChunkSource = malloc_chunk_source>
+	class basic_alloc {
+		public:
+			typedef SizeClasses size_class_type;
+			typedef ChunkSource chunk_source_type;
 		private:
-			enum EAlign{ ALIGN = 8 };
-			enum EMaxBytes{ MAX_BYTES = 128 };
-			enum ENFreeLists{ NFREELISTS = (EMaxBytes::MAX_BYTES / EAlign::ALIGN) };
-			enum ENObjs{ NOBJS = 20 };
+			enum EAlign{ ALIGN = SizeClasses::ALIGN };
+			enum EMaxBytes{ MAX_BYTES = SizeClasses::MAX_BYTES };
+			enum ENFreeLists{ NFREELISTS = SizeClasses::NCLASSES };
+			enum ENObjs{ MIN_OBJS = 4, MAX_OBJS = 128 };
+			enum EBatchBytes{ BATCH_BYTES = 64 * 1024 };
+		public:
+			// refill/drain counters of one size class, see stats()
+			struct free_list_stats {
+				size_t bytes;			// block size of the class
+				size_t refills;			// times a thread list ran dry
+				size_t chunk_refills;	// refills that had to carve new blocks with chunck_alloc
+				size_t objs_refilled;	// blocks handed to thread caches
+				size_t drains;			// times a thread list overflowed
+				size_t objs_drained;	// blocks returned by thread caches
+				size_t last_batch;		// batch size of the latest refill
+				size_t allocs;			// TINYSTL_ALLOC_PROFILE only
+				size_t frees;			// TINYSTL_ALLOC_PROFILE only
+			};
+			// snapshot of the whole pool, see profile()
+			struct alloc_profile {
+				size_t heap_size;			// bytes of the chunks currently held
+				size_t peak_heap_size;
+				size_t chunk_mallocs;		// chunks taken from ChunkSource
+				size_t chunck_alloc_calls;	// refills that reached chunck_alloc
+				size_t large_allocs;		// requests above MAX_BYTES, TINYSTL_ALLOC_PROFILE only
+				size_t large_frees;			// TINYSTL_ALLOC_PROFILE only
+				size_t bytes_live;			// requested bytes not yet freed, TINYSTL_ALLOC_PROFILE only
+				free_list_stats classes[ENFreeLists::NFREELISTS];
+			};
 		private:
 			union obj {
 				union obj* next;
 				char client[1];
 			};
 
+			// prefix of every chunk, linked into chunks
+			struct chunk_header {
+				chunk_header* next;
+				size_t size;		// bytes from the header to the end of the chunk
+				void* raw;			// pointer returned by ChunkSource::allocate
+				size_t raw_size;	// size to give back to ChunkSource::deallocate
+			};
+
+			/*
+			** Per-thread free lists, zero-initialised; returned to the central pool
+			** on thread exit. The profiling counters are there in every build, so
+			** the layout of cache does not depend on TINYSTL_ALLOC_PROFILE; only a
+			** profiled build updates them.
+			*/
+			struct thread_cache {
+				obj* free_list[ENFreeLists::NFREELISTS];
+				size_t length[ENFreeLists::NFREELISTS];
+				size_t batch[ENFreeLists::NFREELISTS];	// next refill size, 0 until first refill
+				size_t allocs[ENFreeLists::NFREELISTS];
+				size_t frees[ENFreeLists::NFREELISTS];
+				size_t large_allocs;
+				size_t large_frees;
+				size_t large_bytes;			// net, wraps when frees run ahead
+				ptrdiff_t sample_countdown;	// bytes until the next sample
+
+				~thread_cache();
+			};
+
+			static thread_local thread_cache cache;
 			static obj* free_list[ENFreeLists::NFREELISTS];
+			static std::mutex central_lock;
+			static free_list_stats list_stats[ENFreeLists::NFREELISTS];
 		private:
 			static char *start_free;
 			static char *end_free;
 			static size_t heap_size;
+			static size_t chunk_mallocs;
+			static chunk_header *chunks;
+			static size_t nchunks;
+			static size_t central_free;	// bytes held by the central free lists
+			static size_t trim_threshold;
+			static size_t trim_trigger;
+			static size_t peak_heap_size;
+			static size_t chunck_alloc_calls;
+#if TINYSTL_ALLOC_PROFILE
+			static size_t large_allocs;
+			static size_t large_frees;
+			static size_t large_bytes;
+			static std::atomic<size_t> sample_interval;
+			static Detail::alloc_sample_table samples;
+#endif
 		private:
 			static size_t ROUND_UP(size_t bytes) {
-				return ((bytes + EAlign::ALIGN - 1) & ~(EAlign::ALIGN - 1));
+				return SizeClasses::class_size(SizeClasses::index(bytes));
 			}
 			static size_t FREELIST_INDEX(size_t bytes) {
-				return (((bytes)+EAlign::ALIGN - 1) / EAlign::ALIGN - 1);
+				return SizeClasses::index(bytes);
 			}
+			static size_t CHUNK_HEADER() {
+				return (sizeof(chunk_header) + EAlign::ALIGN - 1) & ~size_t(EAlign::ALIGN - 1);
+			}
+			// malloc alone cannot honour ALIGN, so large blocks (and chunks of a less aligned source) are over-allocated
+			static bool OVER_ALIGNED() {
+				return EAlign::ALIGN > alignof(std::max_align_t);
+			}
+			static size_t CHUNK_SLACK() {
+				return EAlign::ALIGN > size_t(ChunkSource::ALIGNMENT) ? size_t(EAlign::ALIGN) : 0;
+			}
+			static void *large_allocate(size_t bytes);
+			static void large_deallocate(void *ptr);
+			static void push_free(char *p, size_t bytes);
 			static void *refill(size_t bytes);
 			static void *chunck_alloc(size_t size, size_t& nobjs);
+			static void drain(thread_cache& tc, size_t index, size_t nobjs);
+			static size_t release_free_chunks();
+#if TINYSTL_ALLOC_PROFILE
+			static void note_allocate(thread_cache& tc, void *ptr, size_t bytes, size_t index);
+			static void note_deallocate(thread_cache& tc, void *ptr, size_t bytes, size_t index);
+			static void take_sample(thread_cache& tc, void *ptr, size_t bytes);
+			static void flush_profile(thread_cache& tc);
+#endif
 
 		public:
 			static void *allocate(size_t bytes);
 			static void deallocate(void *ptr, size_t bytes);
 			static void *reallocate(void *ptr, size_t old_sz, size_t new_sz);
+			static bool resize_in_place(void *ptr, size_t old_sz, size_t new_sz);
+
+			static size_t size_classes() { return ENFreeLists::NFREELISTS; }
+			static free_list_stats stats(size_t index);
+			static size_t heap_bytes();
+			static size_t chunk_malloc_calls();
+
+			static size_t trim();
+			static void set_trim_threshold(size_t bytes);
+
+			static alloc_profile profile();
+			static void dump(FILE *out);
+			static void set_sample_interval(size_t bytes);
 	};
 
+	// the pool behind allocator<T>: 8-byte alignment, classes up to 4 KB
+	typedef basic_alloc<size_class_table<> > alloc;
+
+	template<class SizeClasses, class ChunkSource>
+	inline void *basic_alloc<SizeClasses, ChunkSource>::allocate(size_t bytes) {
+		if (bytes > EMaxBytes::MAX_BYTES) {
+			void *result = large_allocate(bytes);
+#if TINYSTL_ALLOC_PROFILE
+			note_allocate(cache, result, bytes, ENFreeLists::NFREELISTS);
+#endif
+			return result;
+		}
+		thread_cache& tc = cache;
+		size_t index = FREELIST_INDEX(bytes);
+		obj *list = tc.free_list[index];
+		if (list) {
+			tc.free_list[index] = list->next;
+			--tc.length[index];
+		}
+		else {
+			list = static_cast<obj *>(refill(ROUND_UP(bytes)));
+		}
+#if TINYSTL_ALLOC_PROFILE
+		note_allocate(tc, list, bytes, index);
+#endif
+		return list;
+	}
+
+	template<class SizeClasses, class ChunkSource>
+	inline void basic_alloc<SizeClasses, ChunkSource>::deallocate(void *ptr, size_t bytes) {
+		if (bytes > EMaxBytes::MAX_BYTES) {
+#if TINYSTL_ALLOC_PROFILE
+			note_deallocate(cache, ptr, bytes, ENFreeLists::NFREELISTS);
+#endif
+			large_deallocate(ptr);
+			return;
+		}
+		thread_cache& tc = cache;
+		size_t index = FREELIST_INDEX(bytes);
+#if TINYSTL_ALLOC_PROFILE
+		note_deallocate(tc, ptr, bytes, index);
+#endif
+		obj *node = static_cast<obj *>(ptr);
+		node->next = tc.free_list[index];
+		tc.free_list[index] = node;
+		size_t batch = tc.batch[index] ? tc.batch[index] : size_t(ENObjs::MIN_OBJS);
+		if (++tc.length[index] > 2 * batch) {
+			drain(tc, index, batch);
+		}
+	}
+
+	template<class SizeClasses, class ChunkSource>
+	thread_local typename basic_alloc<SizeClasses, ChunkSource>::thread_cache basic_alloc<SizeClasses, ChunkSource>::cache;
+	template<class SizeClasses, class ChunkSource>
+	typename basic_alloc<SizeClasses, ChunkSource>::obj *basic_alloc<SizeClasses, ChunkSource>::free_list[basic_alloc<SizeClasses, ChunkSource>::ENFreeLists::NFREELISTS] = { 0 };
+	template<class SizeClasses, class ChunkSource>
+	std::mutex basic_alloc<SizeClasses, ChunkSource>::central_lock;
+	template<class SizeClasses, class ChunkSource>
+	typename basic_alloc<SizeClasses, ChunkSource>::free_list_stats basic_alloc<SizeClasses, ChunkSource>::list_stats[basic_alloc<SizeClasses, ChunkSource>::ENFreeLists::NFREELISTS] = {};
+
+	template<class SizeClasses, class ChunkSource>
+	char *basic_alloc<SizeClasses, ChunkSource>::start_free = 0;
+	template<class SizeClasses, class ChunkSource>
+	char *basic_alloc<SizeClasses, ChunkSource>::end_free = 0;
+	template<class SizeClasses, class ChunkSource>
+	size_t basic_alloc<SizeClasses, ChunkSource>::heap_size = 0;
+	template<class SizeClasses, class ChunkSource>
+	size_t basic_alloc<SizeClasses, ChunkSource>::chunk_mallocs = 0;
+	template<class SizeClasses, class ChunkSource>
+	typename basic_alloc<SizeClasses, ChunkSource>::chunk_header *basic_alloc<SizeClasses, ChunkSource>::chunks = 0;
+	template<class SizeClasses, class ChunkSource>
+	size_t basic_alloc<SizeClasses, ChunkSource>::nchunks = 0;
+	template<class SizeClasses, class ChunkSource>
+	size_t basic_alloc<SizeClasses, ChunkSource>::central_free = 0;
+	template<class SizeClasses, class ChunkSource>
+	size_t basic_alloc<SizeClasses, ChunkSource>::trim_threshold = 0;
+	template<class SizeClasses, class ChunkSource>
+	size_t basic_alloc<SizeClasses, ChunkSource>::trim_trigger = 0;
+	template<class SizeClasses, class ChunkSource>
+	size_t basic_alloc<SizeClasses, ChunkSource>::peak_heap_size = 0;
+	template<class SizeClasses, class ChunkSource>
+	size_t basic_alloc<SizeClasses, ChunkSource>::chunck_alloc_calls = 0;
+#if TINYSTL_ALLOC_PROFILE
+	template<class SizeClasses, class ChunkSource>
+	size_t basic_alloc<SizeClasses, ChunkSource>::large_allocs = 0;
+	template<class SizeClasses, class ChunkSource>
+	size_t basic_alloc<SizeClasses, ChunkSource>::large_frees = 0;
+	template<class SizeClasses, class ChunkSource>
+	size_t basic_alloc<SizeClasses, ChunkSource>::large_bytes = 0;
+	template<class SizeClasses, class ChunkSource>
+	std::atomic<size_t> basic_alloc<SizeClasses, ChunkSource>::sample_interval(0);
+	template<class SizeClasses, class ChunkSource>
+	Detail::alloc_sample_table basic_alloc<SizeClasses, ChunkSource>::samples;
+#endif
+
+	namespace Detail {
+		inline int compare_chunks(const void *a, const void *b) {
+			uintptr_t x = reinterpret_cast<uintptr_t>(*static_cast<void *const *>(a));
+			uintptr_t y = reinterpret_cast<uintptr_t>(*static_cast<void *const *>(b));
+			return x < y ? -1 : (x > y ? 1 : 0);
+		}
+
+		// index of the chunk that contains p, in an address-sorted array
+		template<class Chunk>
+		size_t find_chunk(Chunk *const *sorted, size_t n, const void *p) {
+			uintptr_t addr = reinterpret_cast<uintptr_t>(p);
+			size_t lo = 0, hi = n;
+			while (hi - lo > 1) {
+				size_t mid = lo + (hi - lo) / 2;
+				if (reinterpret_cast<uintptr_t>(sorted[mid]) <= addr) lo = mid;
+				else hi = mid;
+			}
+			return lo;
+		}
+	}
+
+	template<class SizeClasses, class ChunkSource>
+	basic_alloc<SizeClasses, ChunkSource>::thread_cache::~thread_cache() {
+		for (size_t i = 0; i != ENFreeLists::NFREELISTS; ++i) {
+			if (length[i] != 0) {
+				drain(*this, i, length[i]);
+			}
+		}
+#if TINYSTL_ALLOC_PROFILE
+		std::lock_guard<std::mutex> guard(central_lock);
+		flush_profile(*this);
+#endif
+	}
+
+	template<class SizeClasses, class ChunkSource>
+	void *basic_alloc<SizeClasses, ChunkSource>::large_allocate(size_t bytes) {
+		if (!OVER_ALIGNED()) {
+			void *result = malloc(bytes);
+			if (result == 0) throw std::bad_alloc();
+			return result;
+		}
+		// keep the malloc pointer in the word just below the aligned block
+		char *raw = static_cast<char *>(malloc(bytes + EAlign::ALIGN));
+		if (raw == 0) throw std::bad_alloc();
+		char *result = reinterpret_cast<char *>(
+			(reinterpret_cast<uintptr_t>(raw) + EAlign::ALIGN) & ~uintptr_t(EAlign::ALIGN - 1));
+		reinterpret_cast<void **>(result)[-1] = raw;
+		return result;
+	}
+
+	template<class SizeClasses, class ChunkSource>
+	void basic_alloc<SizeClasses, ChunkSource>::large_deallocate(void *ptr) {
+		if (!OVER_ALIGNED()) {
+			free(ptr);
+		}
+		else if (ptr) {
+			free(static_cast<void **>(ptr)[-1]);
+		}
+	}
+
+	// put [p, p + bytes) on the central lists, split over as many classes as needed;
+	// called with central_lock held, bytes is a multiple of ALIGN
+	template<class SizeClasses, class ChunkSource>
+	void basic_alloc<SizeClasses, ChunkSource>::push_free(char *p, size_t bytes) {
+		while (bytes != 0) {
+			size_t index = FREELIST_INDEX(bytes < EMaxBytes::MAX_BYTES ? bytes : size_t(EMaxBytes::MAX_BYTES));
+			size_t size = SizeClasses::class_size(index);
+			if (size > bytes) size = SizeClasses::class_size(--index);
+			obj *node = reinterpret_cast<obj *>(p);
+			node->next = free_list[index];
+			free_list[index] = node;
+			central_free += size;
+			p += size;
+			bytes -= size;
+		}
+	}
+
+	// move the first nobjs blocks of a thread list back to the central list
+	template<class SizeClasses, class ChunkSource>
+	void basic_alloc<SizeClasses, ChunkSource>::drain(thread_cache& tc, size_t index, size_t nobjs) {
+		obj *first = tc.free_list[index];
+		obj *last = first;
+		for (size_t i = 1; i < nobjs; ++i) {
+			last = last->next;
+		}
+		tc.free_list[index] = last->next;
+		tc.length[index] -= nobjs;
+
+		std::lock_guard<std::mutex> guard(central_lock);
+		last->next = free_list[index];
+		free_list[index] = first;
+		central_free += nobjs * SizeClasses::class_size(index);
+#if TINYSTL_ALLOC_PROFILE
+		flush_profile(tc);
+#endif
+		++list_stats[index].drains;
+		list_stats[index].objs_drained += nobjs;
+		if (trim_threshold != 0 && central_free > trim_trigger) {
+			release_free_chunks();
+			// do not rescan until another threshold's worth has come back
+			trim_trigger = central_free + trim_threshold;
+		}
+	}
+
+	// hand one block of bytes to the caller and keep the rest of a batch in the thread cache
+	template<class SizeClasses, class ChunkSource>
+	void *basic_alloc<SizeClasses, ChunkSource>::refill(size_t bytes) {
+		thread_cache& tc = cache;
+		size_t index = FREELIST_INDEX(bytes);
+		// the list ran dry: take the current batch and double the next one
+		size_t max_objs = EBatchBytes::BATCH_BYTES / bytes;
+		if (max_objs > ENObjs::MAX_OBJS) max_objs = ENObjs::MAX_OBJS;
+		if (max_objs < 2) max_objs = 2;
+		size_t nobjs = tc.batch[index] ? tc.batch[index] : size_t(ENObjs::MIN_OBJS);
+		if (nobjs > max_objs) nobjs = max_objs;
+		tc.batch[index] = 2 * nobjs < max_objs ? 2 * nobjs : max_objs;
+		obj *result = 0;
+		{
+			std::lock_guard<std::mutex> guard(central_lock);
+#if TINYSTL_ALLOC_PROFILE
+			flush_profile(tc);
+#endif
+			free_list_stats& st = list_stats[index];
+			++st.refills;
+			st.last_batch = nobjs;
+			obj *list = free_list[index];
+			if (list) {
+				obj *last = list;
+				size_t n = 1;
+				for (; n < nobjs && last->next; ++n) {
+					last = last->next;
+				}
+				free_list[index] = last->next;
+				last->next = 0;
+				nobjs = n;
+				central_free -= n * bytes;
+				result = list;
+			}
+			else {
+				++st.chunk_refills;
+				++chunck_alloc_calls;
+				char *chunk = static_cast<char *>(chunck_alloc(bytes, nobjs));
+				// carve the chunk into a list while still exclusive to this thread
+				result = reinterpret_cast<obj *>(chunk);
+				obj *cur = result;
+				for (size_t i = 1; i != nobjs; ++i) {
+					obj *next = reinterpret_cast<obj *>(chunk + i * bytes);
+					cur->next = next;
+					cur = next;
+				}
+				cur->next = 0;
+			}
+			st.objs_refilled += nobjs;
+		}
+
+		obj *rest = result->next;
+		if (rest) {
+			obj *last = rest;
+			while (last->next) last = last->next;
+			last->next = tc.free_list[index];
+			tc.free_list[index] = rest;
+			tc.length[index] += nobjs - 1;
+		}
+		return result;
+	}
+
+	// called with central_lock held
+	template<class SizeClasses, class ChunkSource>
+	void *basic_alloc<SizeClasses, ChunkSource>::chunck_alloc(size_t size, size_t& nobjs) {
+		char *result = 0;
+		size_t total_bytes = size * nobjs;
+		size_t bytes_left = end_free - start_free;
+
+		if (bytes_left >= total_bytes) {
+			result = start_free;
+			start_free += total_bytes;
+			return result;
+		}
+		else if (bytes_left >= size) {
+			nobjs = bytes_left / size;
+			total_bytes = size * nobjs;
+			result = start_free;
+			start_free += total_bytes;
+			return result;
+		}
+		else {
+			size_t bytes_to_get = 2 * total_bytes + ((heap_size >> 4) & ~size_t(EAlign::ALIGN - 1));
+			// hand the leftover of the current pool to the central lists
+			if (bytes_left > 0) {
+				push_free(start_free, bytes_left);
+			}
+			bytes_to_get += CHUNK_HEADER();
+			size_t slack = CHUNK_SLACK();
+			size_t raw_size = bytes_to_get + slack;
+			void *raw = ChunkSource::allocate(raw_size);
+			if (raw == 0) {
+				// out of memory: scavenge a free block of a larger size class
+				for (size_t i = FREELIST_INDEX(size); i != ENFreeLists::NFREELISTS; ++i) {
+					obj *p = free_list[i];
+					if (p != 0) {
+						free_list[i] = p->next;
+						central_free -= SizeClasses::class_size(i);
+						start_free = reinterpret_cast<char *>(p);
+						end_free = start_free + SizeClasses::class_size(i);
+						return chunck_alloc(size, nobjs);
+					}
+				}
+				start_free = end_free = 0;
+				throw std::bad_alloc();
+			}
+			// the source may round up; use all of it
+			bytes_to_get = (raw_size - slack) & ~size_t(EAlign::ALIGN - 1);
+			uintptr_t base = reinterpret_cast<uintptr_t>(raw);
+			if (slack) base = (base + slack - 1) & ~uintptr_t(slack - 1);
+			chunk_header *chunk = reinterpret_cast<chunk_header *>(base);
+			chunk->raw = raw;
+			chunk->raw_size = raw_size;
+			chunk->size = bytes_to_get;
+			chunk->next = chunks;
+			chunks = chunk;
+			++nchunks;
+			heap_size += bytes_to_get;
+			if (heap_size > peak_heap_size) peak_heap_size = heap_size;
+			++chunk_mallocs;
+			start_free = reinterpret_cast<char *>(chunk) + CHUNK_HEADER();
+			end_free = reinterpret_cast<char *>(chunk) + bytes_to_get;
+			return chunck_alloc(size, nobjs);
+		}
+	}
+
+	/*
+	** Resize a small block without moving it: either both sizes fall in the same
+	** class, or the block is the last one carved from the newest chunk and the
+	** pool's unused tail can give (or take back) the difference. Returns false,
+	** leaving the block alone, when the block would have to move.
+	*/
+	template<class SizeClasses, class ChunkSource>
+	bool basic_alloc<SizeClasses, ChunkSource>::resize_in_place(void *ptr, size_t old_sz, size_t new_sz) {
+		if (old_sz > EMaxBytes::MAX_BYTES || new_sz > EMaxBytes::MAX_BYTES) {
+			return false;
+		}
+		size_t old_index = FREELIST_INDEX(old_sz), new_index = FREELIST_INDEX(new_sz);
+		if (old_index == new_index) {
+			return true;
+		}
+		char *p = static_cast<char *>(ptr);
+		size_t old_bytes = SizeClasses::class_size(old_index);
+		size_t new_bytes = SizeClasses::class_size(new_index);
+		{
+			std::lock_guard<std::mutex> guard(central_lock);
+			// start_free may point into a scavenged block of another chunk
+			if (chunks == 0 || p + old_bytes != start_free
+				|| end_free != reinterpret_cast<char *>(chunks) + chunks->size
+				|| p < reinterpret_cast<char *>(chunks) + CHUNK_HEADER()) {
+				return false;
+			}
+			if (new_bytes > old_bytes && size_t(end_free - start_free) < new_bytes - old_bytes) {
+				return false;
+			}
+			start_free = p + new_bytes;
+		}
+#if TINYSTL_ALLOC_PROFILE
+		note_deallocate(cache, ptr, old_sz, old_index);
+		note_allocate(cache, ptr, new_sz, new_index);
+#endif
+		return true;
+	}
+
+	template<class SizeClasses, class ChunkSource>
+	void *basic_alloc<SizeClasses, ChunkSource>::reallocate(void *ptr, size_t old_sz, size_t new_sz) {
+		if (old_sz > EMaxBytes::MAX_BYTES && new_sz > EMaxBytes::MAX_BYTES && !OVER_ALIGNED()) {
+#if TINYSTL_ALLOC_PROFILE
+			note_deallocate(cache, ptr, old_sz, ENFreeLists::NFREELISTS);
+#endif
+			void *result = realloc(ptr, new_sz);
+			if (result == 0) throw std::bad_alloc();
+#if TINYSTL_ALLOC_PROFILE
+			note_allocate(cache, result, new_sz, ENFreeLists::NFREELISTS);
+#endif
+			return result;
+		}
+		if (resize_in_place(ptr, old_sz, new_sz)) {
+			return ptr;
+		}
+		void *result = allocate(new_sz);
+		memcpy(result, ptr, old_sz < new_sz ? old_sz : new_sz);
+		deallocate(ptr, old_sz);
+		return result;
+	}
+
+	template<class SizeClasses, class ChunkSource>
+	typename basic_alloc<SizeClasses, ChunkSource>::free_list_stats basic_alloc<SizeClasses, ChunkSource>::stats(size_t index) {
+		std::lock_guard<std::mutex> guard(central_lock);
+		free_list_stats st = list_stats[index];
+		st.bytes = SizeClasses::class_size(index);
+		return st;
+	}
+
+	template<class SizeClasses, class ChunkSource>
+	size_t basic_alloc<SizeClasses, ChunkSource>::heap_bytes() {
+		std::lock_guard<std::mutex> guard(central_lock);
+		return heap_size;
+	}
+
+	template<class SizeClasses, class ChunkSource>
+	size_t basic_alloc<SizeClasses, ChunkSource>::chunk_malloc_calls() {
+		std::lock_guard<std::mutex> guard(central_lock);
+		return chunk_mallocs;
+	}
+
+	// free every chunk whose blocks all sit in the central lists; called with central_lock held
+	template<class SizeClasses, class ChunkSource>
+	size_t basic_alloc<SizeClasses, ChunkSource>::release_free_chunks() {
+		if (nchunks == 0) return 0;
+		chunk_header **sorted = static_cast<chunk_header **>(malloc(nchunks * sizeof(chunk_header *)));
+		size_t *free_bytes = static_cast<size_t *>(calloc(nchunks, sizeof(size_t)));
+		if (sorted == 0 || free_bytes == 0) {
+			free(sorted);
+			free(free_bytes);
+			return 0;
+		}
+		size_t n = 0;
+		for (chunk_header *c = chunks; c; c = c->next) {
+			sorted[n++] = c;
+		}
+		qsort(sorted, n, sizeof(chunk_header *), Detail::compare_chunks);
+
+		for (size_t i = 0; i != ENFreeLists::NFREELISTS; ++i) {
+			for (obj *p = free_list[i]; p; p = p->next) {
+				free_bytes[Detail::find_chunk(sorted, n, p)] += SizeClasses::class_size(i);
+			}
+		}
+		if (start_free != end_free) {
+			free_bytes[Detail::find_chunk(sorted, n, start_free)] += end_free - start_free;
+		}
+		// from here on free_bytes[k] != 0 marks sorted[k] as releasable
+		size_t releasable = 0;
+		for (size_t k = 0; k != n; ++k) {
+			free_bytes[k] = (free_bytes[k] == sorted[k]->size - CHUNK_HEADER());
+			releasable += free_bytes[k];
+		}
+
+		size_t released = 0;
+		if (releasable != 0) {
+			for (size_t i = 0; i != ENFreeLists::NFREELISTS; ++i) {
+				obj **link = free_list + i;
+				while (*link) {
+					if (free_bytes[Detail::find_chunk(sorted, n, *link)]) {
+						*link = (*link)->next;
+						central_free -= SizeClasses::class_size(i);
+					}
+					else {
+						link = &(*link)->next;
+					}
+				}
+			}
+			if (start_free != end_free && free_bytes[Detail::find_chunk(sorted, n, start_free)]) {
+				start_free = end_free = 0;
+			}
+			chunk_header **link = &chunks;
+			while (*link) {
+				chunk_header *c = *link;
+				if (free_bytes[Detail::find_chunk(sorted, n, c)]) {
+					*link = c->next;
+					released += c->size;
+					heap_size -= c->size;
+					--nchunks;
+					ChunkSource::deallocate(c->raw, c->raw_size);
+				}
+				else {
+					link = &c->next;
+				}
+			}
+		}
+		free(sorted);
+		free(free_bytes);
+		return released;
+	}
+
+	// return the calling thread's cache to the central lists, then release idle chunks
+	template<class SizeClasses, class ChunkSource>
+	size_t basic_alloc<SizeClasses, ChunkSource>::trim() {
+		thread_cache& tc = cache;
+		for (size_t i = 0; i != ENFreeLists::NFREELISTS; ++i) {
+			if (tc.length[i] != 0) {
+				drain(tc, i, tc.length[i]);
+			}
+		}
+		std::lock_guard<std::mutex> guard(central_lock);
+		return release_free_chunks();
+	}
+
+	template<class SizeClasses, class ChunkSource>
+	void basic_alloc<SizeClasses, ChunkSource>::set_trim_threshold(size_t bytes) {
+		std::lock_guard<std::mutex> guard(central_lock);
+		trim_threshold = bytes;
+		trim_trigger = bytes;
+	}
+
+	template<class SizeClasses, class ChunkSource>
+	typename basic_alloc<SizeClasses, ChunkSource>::alloc_profile basic_alloc<SizeClasses, ChunkSource>::profile() {
+		alloc_profile p = alloc_profile();
+#if TINYSTL_ALLOC_PROFILE
+		thread_cache& tc = cache;
+#endif
+		std::lock_guard<std::mutex> guard(central_lock);
+#if TINYSTL_ALLOC_PROFILE
+		flush_profile(tc);
+		ptrdiff_t live = static_cast<ptrdiff_t>(large_bytes);
+		p.large_allocs = large_allocs;
+		p.large_frees = large_frees;
+#endif
+		p.heap_size = heap_size;
+		p.peak_heap_size = peak_heap_size;
+		p.chunk_mallocs = chunk_mallocs;
+		p.chunck_alloc_calls = chunck_alloc_calls;
+		for (size_t i = 0; i != ENFreeLists::NFREELISTS; ++i) {
+			p.classes[i] = list_stats[i];
+			p.classes[i].bytes = SizeClasses::class_size(i);
+#if TINYSTL_ALLOC_PROFILE
+			live += static_cast<ptrdiff_t>(list_stats[i].allocs - list_stats[i].frees) * static_cast<ptrdiff_t>(p.classes[i].bytes);
+#endif
+		}
+#if TINYSTL_ALLOC_PROFILE
+		// frees counted before the matching allocations were flushed can dip below zero
+		p.bytes_live = live > 0 ? static_cast<size_t>(live) : 0;
+#endif
+		return p;
+	}
+
+	template<class SizeClasses, class ChunkSource>
+	void basic_alloc<SizeClasses, ChunkSource>::dump(FILE *out) {
+		alloc_profile p = profile();
+		fprintf(out, "heap %zu bytes (peak %zu), %zu chunk mallocs, %zu chunck_alloc calls\n",
+			p.heap_size, p.peak_heap_size, p.chunk_mallocs, p.chunck_alloc_calls);
+#if TINYSTL_ALLOC_PROFILE
+		fprintf(out, "live %zu bytes, %zu large allocs, %zu large frees\n",
+			p.bytes_live, p.large_allocs, p.large_frees);
+#endif
+		fprintf(out, "%8s %10s %10s %8s %8s %8s %6s\n", "class", "allocs", "frees", "refills", "chunks", "drains", "batch");
+		for (size_t i = 0; i != ENFreeLists::NFREELISTS; ++i) {
+			const free_list_stats& st = p.classes[i];
+			if (st.allocs == 0 && st.refills == 0) continue;
+			fprintf(out, "%8zu %10zu %10zu %8zu %8zu %8zu %6zu\n",
+				st.bytes, st.allocs, st.frees, st.refills, st.chunk_refills, st.drains, st.last_batch);
+		}
+#if TINYSTL_ALLOC_PROFILE
+		samples.for_each([out](const Detail::alloc_sample_table::sample& s) {
+			fprintf(out, "sampled %zu bytes at %p\n", s.bytes, s.ptr);
+			for (size_t i = 0; i != s.depth; ++i) {
+				fprintf(out, "    #%zu %p\n", i, s.frames[i]);
+			}
+		});
+#endif
+	}
+
+	// sample one allocation per `bytes` allocated by a thread; 0 turns sampling off
+	template<class SizeClasses, class ChunkSource>
+	void basic_alloc<SizeClasses, ChunkSource>::set_sample_interval(size_t bytes) {
+#if TINYSTL_ALLOC_PROFILE
+		sample_interval.store(bytes, std::memory_order_relaxed);
+		cache.sample_countdown = 0;
+#else
+		(void)bytes;
+#endif
+	}
+
+#if TINYSTL_ALLOC_PROFILE
+	template<class SizeClasses, class ChunkSource>
+	inline void basic_alloc<SizeClasses, ChunkSource>::note_allocate(thread_cache& tc, void *ptr, size_t bytes, size_t index) {
+		if (index != ENFreeLists::NFREELISTS) {
+			++tc.allocs[index];
+		}
+		else {
+			++tc.large_allocs;
+			tc.large_bytes += bytes;
+		}
+		if ((tc.sample_countdown -= static_cast<ptrdiff_t>(bytes)) < 0) {
+			take_sample(tc, ptr, bytes);
+		}
+	}
+
+	template<class SizeClasses, class ChunkSource>
+	inline void basic_alloc<SizeClasses, ChunkSource>::note_deallocate(thread_cache& tc, void *ptr, size_t bytes, size_t index) {
+		if (index != ENFreeLists::NFREELISTS) {
+			++tc.frees[index];
+		}
+		else {
+			++tc.large_frees;
+			tc.large_bytes -= bytes;
+		}
+		// forget the sample before the block can be handed out again
+		if (!samples.empty()) {
+			samples.erase(ptr);
+		}
+	}
+
+	template<class SizeClasses, class ChunkSource>
+	void basic_alloc<SizeClasses, ChunkSource>::take_sample(thread_cache& tc, void *ptr, size_t bytes) {
+		size_t interval = sample_interval.load(std::memory_order_relaxed);
+		if (interval == 0) {
+			// sampling is off: look at the interval again after another MB
+			tc.sample_countdown = 1 << 20;
+			return;
+		}
+		tc.sample_countdown = static_cast<ptrdiff_t>(interval);
+		samples.insert(ptr, bytes);
+	}
+
+	// move a thread's counters into the pool totals; called with central_lock held
+	template<class SizeClasses, class ChunkSource>
+	void basic_alloc<SizeClasses, ChunkSource>::flush_profile(thread_cache& tc) {
+		for (size_t i = 0; i != ENFreeLists::NFREELISTS; ++i) {
+			list_stats[i].allocs += tc.allocs[i];
+			list_stats[i].frees += tc.frees[i];
+			tc.allocs[i] = tc.frees[i] = 0;
+		}
+		large_allocs += tc.large_allocs;
+		large_frees += tc.large_frees;
+		large_bytes += tc.large_bytes;
+		tc.large_allocs = tc.large_frees = tc.large_bytes = 0;
+	}
+#endif
+
+	// the default pool is instantiated once, in Alloc.cpp
+	extern template class basic_alloc<size_class_table<> >;
+
 } // namespace tinySTL
 
 #endif // !
-
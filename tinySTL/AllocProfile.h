@@ -0,0 +1,142 @@
+#ifndef _ALLOC_PROFILE_H_
+#define _ALLOC_PROFILE_H_
+
+/*
+** Compile-time switch of the basic_alloc profiler. Build with
+** TINYSTL_ALLOC_PROFILE defined to 1 to count allocations and frees per size
+** class, track live bytes and sample allocation stacks. With the default of 0
+** the hooks in Alloc.h are not compiled at all and the pool only keeps the
+** counters it updates on its slow paths anyway.
+*/
+#ifndef TINYSTL_ALLOC_PROFILE
+#define TINYSTL_ALLOC_PROFILE 0
+#endif
+
+/*
+** Set the switch the same way for every object file, Alloc.cpp included,
+** since that is where basic_alloc is instantiated. MSVC rejects a mix at
+** link time. Elsewhere a mix either leaves the sampling hooks unresolved
+** or links. When it links, the pool stays consistent because thread_cache
+** has the same layout either way, but only calls compiled with the switch
+** are counted.
+*/
+#if defined(_MSC_VER)
+#if TINYSTL_ALLOC_PROFILE
+#pragma detect_mismatch("TINYSTL_ALLOC_PROFILE", "1")
+#else
+#pragma detect_mismatch("TINYSTL_ALLOC_PROFILE", "0")
+#endif
+#endif
+
+#if TINYSTL_ALLOC_PROFILE
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__GLIBC__)
+#include <execinfo.h>
+#endif
+
+namespace tinySTL {
+
+	namespace Detail {
+		// return addresses of the calling stack, innermost first
+		inline size_t capture_stack(void **frames, size_t max_frames) {
+#if defined(_WIN32)
+			return CaptureStackBackTrace(1, static_cast<DWORD>(max_frames), frames, 0);
+#elif defined(__GLIBC__)
+			int n = backtrace(frames, static_cast<int>(max_frames));
+			return n > 0 ? static_cast<size_t>(n) : 0;
+#else
+			(void)frames;
+			(void)max_frames;
+			return 0;
+#endif
+		}
+
+		/*
+		** Live sampled allocations keyed by address: a fixed open-addressing table
+		** with backward-shift deletion. When it is full further samples are dropped.
+		** empty() is a relaxed load, so frees only take the lock while samples exist.
+		*/
+		class alloc_sample_table {
+			public:
+				enum ECapacity{ CAPACITY = 1024, MAX_LIVE = CAPACITY * 3 / 4 };
+				enum EFrames{ MAX_FRAMES = 16 };
+				struct sample {
+					void *ptr;
+					size_t bytes;
+					size_t depth;
+					void *frames[EFrames::MAX_FRAMES];
+				};
+			private:
+				sample slots_[ECapacity::CAPACITY];
+				std::atomic<size_t> live_;
+				std::mutex lock_;
+			private:
+				static size_t HASH(const void *ptr) {
+					uintptr_t h = reinterpret_cast<uintptr_t>(ptr) >> 3;
+					return static_cast<size_t>(h * 0x9E3779B97F4A7C15ull >> 20) & (ECapacity::CAPACITY - 1);
+				}
+			public:
+				alloc_sample_table() :slots_(), live_(0) {}
+
+				bool empty() const { return live_.load(std::memory_order_relaxed) == 0; }
+				void insert(void *ptr, size_t bytes);
+				void erase(void *ptr);
+				template<class Function>
+				void for_each(Function f);
+		};
+
+		inline void alloc_sample_table::insert(void *ptr, size_t bytes) {
+			sample s;
+			s.ptr = ptr;
+			s.bytes = bytes;
+			s.depth = capture_stack(s.frames, EFrames::MAX_FRAMES);
+			std::lock_guard<std::mutex> guard(lock_);
+			if (live_.load(std::memory_order_relaxed) >= ECapacity::MAX_LIVE) return;
+			size_t i = HASH(ptr);
+			while (slots_[i].ptr != 0) {
+				i = (i + 1) & (ECapacity::CAPACITY - 1);
+			}
+			slots_[i] = s;
+			live_.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		inline void alloc_sample_table::erase(void *ptr) {
+			std::lock_guard<std::mutex> guard(lock_);
+			size_t i = HASH(ptr);
+			while (slots_[i].ptr != ptr) {
+				if (slots_[i].ptr == 0) return;
+				i = (i + 1) & (ECapacity::CAPACITY - 1);
+			}
+			// pull later members of the probe run back over the hole
+			size_t hole = i;
+			for (size_t j = (i + 1) & (ECapacity::CAPACITY - 1); slots_[j].ptr != 0; j = (j + 1) & (ECapacity::CAPACITY - 1)) {
+				size_t home = HASH(slots_[j].ptr);
+				if (((j - home) & (ECapacity::CAPACITY - 1)) >= ((j - hole) & (ECapacity::CAPACITY - 1))) {
+					slots_[hole] = slots_[j];
+					hole = j;
+				}
+			}
+			slots_[hole].ptr = 0;
+			live_.fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		template<class Function>
+		void alloc_sample_table::for_each(Function f) {
+			std::lock_guard<std::mutex> guard(lock_);
+			for (size_t i = 0; i != ECapacity::CAPACITY; ++i) {
+				if (slots_[i].ptr != 0) f(slots_[i]);
+			}
+		}
+	}// namespace Detail
+} // namespace tinySTL
+
+#endif // TINYSTL_ALLOC_PROFILE
+
+#endif // _ALLOC_PROFILE_H_
@@ -6,6 +6,8 @@
 
 #include <new>
 #include <cassert>
+#include <type_traits>
+#include <utility>
 
 namespace tinySTL {
 
@@ -20,15 +22,27 @@ namespace tinySTL {
 			typedef size_t  size_type;
 			typedef ptrdiff_t difference_type;
 
+			template<class U>
+			struct rebind { typedef allocator<U> other; };
+
+			// stateless: every instance can free what any other one allocated
+			typedef std::true_type is_always_equal;
+
 		public:
+			allocator() {}
+			template<class U>
+			allocator(const allocator<U>&) {}
+
 			static T* allocate();
 			static T* allocate(size_t n);
 
 			static void deallocate(T* p);
 			static void deallocate(T* p, size_t n);
 
-			static void construct(T* p);
-			static void construct(T* p, const T& value);
+			static T* reallocate(T* p, size_t old_n, size_t new_n, size_t count);
+
+			template<class... Args>
+			static void construct(T* p, Args&&... args);
 			
 			static void destroy(T* p);
 			static void destroy(T* frist, T* last);
@@ -40,6 +54,7 @@ namespace tinySTL {
 	}
 	template<class T>
 	T* allocator<T>::allocate(size_t n) {
+		if (n == 0) return 0;
 		return static_cast<T*>(alloc::allocate(n * sizeof(T)));
 	}
 
@@ -53,13 +68,49 @@ namespace tinySTL {
 		alloc::deallocate(static_cast<void*>(p), n * sizeof(T));
 	}
 
+	/*
+	** Grow or shrink the array p of old_n elements, whose first count elements
+	** are constructed (count <= new_n), to new_n elements. The block is resized
+	** in place when alloc allows it. Otherwise trivially relocatable elements are
+	** moved with alloc::reallocate (realloc for large blocks), and any other type
+	** is move-constructed into a new block and destroyed in the old one.
+	*/
 	template<class T>
-	void allocator<T>::construct(T* p) {
-		new(p) T();
+	T* allocator<T>::reallocate(T* p, size_t old_n, size_t new_n, size_t count) {
+		if (p == 0 || old_n == 0) return allocate(new_n);
+		if (new_n == 0) {
+			destroy(p, p + count);
+			deallocate(p, old_n);
+			return 0;
+		}
+		if (is_trivially_relocatable<T>::value) {
+			// alloc::reallocate tries in place first
+			return static_cast<T*>(alloc::reallocate(p, old_n * sizeof(T), new_n * sizeof(T)));
+		}
+		if (alloc::resize_in_place(p, old_n * sizeof(T), new_n * sizeof(T))) {
+			return p;
+		}
+		T* result = allocate(new_n);
+		size_t i = 0;
+		try {
+			for (; i != count; ++i) {
+				new(result + i) T(std::move_if_noexcept(p[i]));
+			}
+		}
+		catch (...) {
+			destroy(result, result + i);
+			deallocate(result, new_n);
+			throw;
+		}
+		destroy(p, p + count);
+		deallocate(p, old_n);
+		return result;
 	}
+
 	template<class T>
-	void allocator<T>::construct(T* p, const T& value) {
-		new(p) T(value);
+	template<class... Args>
+	void allocator<T>::construct(T* p, Args&&... args) {
+		new(p) T(std::forward<Args>(args)...);
 	}
 
 	template<class T>
@@ -72,6 +123,15 @@ namespace tinySTL {
 			frist->~T();
 		}
 	}
+
+	template<class T, class U>
+	bool operator == (const allocator<T>&, const allocator<U>&) {
+		return true;
+	}
+	template<class T, class U>
+	bool operator != (const allocator<T>&, const allocator<U>&) {
+		return false;
+	}
 } // namespace tinySTL
 
 #endif // _ALLOCATOR_H_
\ No newline at end of file
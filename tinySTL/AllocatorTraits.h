@@ -0,0 +1,196 @@
+#ifndef _ALLOCATOR_TRAITS_H_
+#define _ALLOCATOR_TRAITS_H_
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace tinySTL {
+
+	namespace Detail {
+		template<class...>
+		struct voider { typedef void type; };
+
+		// Alloc::rebind<U>::other if Alloc has it, otherwise Alloc<T, Args...> -> Alloc<U, Args...>
+		template<class Alloc, class U>
+		struct rebind_first_arg;
+		template<template<class, class...> class Alloc, class T, class... Args, class U>
+		struct rebind_first_arg<Alloc<T, Args...>, U> { typedef Alloc<U, Args...> type; };
+		template<class Alloc, class U, class = void>
+		struct rebind_of : rebind_first_arg<Alloc, U> {};
+		template<class Alloc, class U>
+		struct rebind_of<Alloc, U, typename voider<typename Alloc::template rebind<U>::other>::type> {
+			typedef typename Alloc::template rebind<U>::other type;
+		};
+
+		// the propagation flags Alloc declares, or the std::allocator_traits defaults
+		template<class Alloc, class = void>
+		struct pocca_of { typedef std::false_type type; };
+		template<class Alloc>
+		struct pocca_of<Alloc, typename voider<typename Alloc::propagate_on_container_copy_assignment>::type> {
+			typedef typename Alloc::propagate_on_container_copy_assignment type;
+		};
+		template<class Alloc, class = void>
+		struct pocma_of { typedef std::false_type type; };
+		template<class Alloc>
+		struct pocma_of<Alloc, typename voider<typename Alloc::propagate_on_container_move_assignment>::type> {
+			typedef typename Alloc::propagate_on_container_move_assignment type;
+		};
+		template<class Alloc, class = void>
+		struct pocs_of { typedef std::false_type type; };
+		template<class Alloc>
+		struct pocs_of<Alloc, typename voider<typename Alloc::propagate_on_container_swap>::type> {
+			typedef typename Alloc::propagate_on_container_swap type;
+		};
+		template<class Alloc, class = void>
+		struct always_equal_of { typedef typename std::is_empty<Alloc>::type type; };
+		template<class Alloc>
+		struct always_equal_of<Alloc, typename voider<typename Alloc::is_always_equal>::type> {
+			typedef typename Alloc::is_always_equal type;
+		};
+
+		template<class Void, class Alloc, class T, class... Args>
+		struct has_construct_aux : std::false_type {};
+		template<class Alloc, class T, class... Args>
+		struct has_construct_aux<typename voider<decltype(std::declval<Alloc&>().construct(std::declval<T*>(), std::declval<Args>()...))>::type, Alloc, T, Args...>
+			: std::true_type {};
+		template<class Alloc, class T, class... Args>
+		struct has_construct : has_construct_aux<void, Alloc, T, Args...> {};
+
+		template<class Alloc, class T, class = void>
+		struct has_destroy : std::false_type {};
+		template<class Alloc, class T>
+		struct has_destroy<Alloc, T, typename voider<decltype(std::declval<Alloc&>().destroy(std::declval<T*>()))>::type>
+			: std::true_type {};
+
+		template<class Alloc, class = void>
+		struct has_reallocate : std::false_type {};
+		template<class Alloc>
+		struct has_reallocate<Alloc, typename voider<decltype(std::declval<Alloc&>().reallocate(
+			std::declval<typename Alloc::value_type*>(), size_t(), size_t(), size_t()))>::type>
+			: std::true_type {};
+
+		template<class Alloc, class = void>
+		struct has_select_on_copy : std::false_type {};
+		template<class Alloc>
+		struct has_select_on_copy<Alloc, typename voider<decltype(std::declval<const Alloc&>().select_on_container_copy_construction())>::type>
+			: std::true_type {};
+
+		/*
+		** Storage for a container's allocator. An empty allocator becomes a base
+		** class so the empty-base optimisation folds it away; a stateful one is
+		** kept as a member.
+		*/
+		template<class Alloc, bool = std::is_empty<Alloc>::value && !std::is_final<Alloc>::value>
+		class alloc_holder : private Alloc {
+		public:
+			alloc_holder() {}
+			explicit alloc_holder(const Alloc& a) :Alloc(a) {}
+			Alloc& get_alloc() { return *this; }
+			const Alloc& get_alloc() const { return *this; }
+		};
+		template<class Alloc>
+		class alloc_holder<Alloc, false> {
+		private:
+			Alloc alloc_;
+		public:
+			alloc_holder() :alloc_() {}
+			explicit alloc_holder(const Alloc& a) :alloc_(a) {}
+			Alloc& get_alloc() { return alloc_; }
+			const Alloc& get_alloc() const { return alloc_; }
+		};
+	}// namespace Detail
+
+	/*
+	** Uniform access to allocators, following std::allocator_traits: containers
+	** call allocate/construct/destroy through here so that both the all-static
+	** allocator<T> and stateful instances such as arena_allocator<T> work, and
+	** read the propagate_on_container_* flags (false unless the allocator says
+	** otherwise) to decide what happens to the allocator on copy, move and swap.
+	*/
+	template<class Alloc>
+	struct allocator_traits {
+		typedef Alloc allocator_type;
+		typedef typename Alloc::value_type value_type;
+		typedef value_type* pointer;
+		typedef const value_type* const_pointer;
+		typedef size_t size_type;
+		typedef ptrdiff_t difference_type;
+
+		typedef typename Detail::pocca_of<Alloc>::type propagate_on_container_copy_assignment;
+		typedef typename Detail::pocma_of<Alloc>::type propagate_on_container_move_assignment;
+		typedef typename Detail::pocs_of<Alloc>::type propagate_on_container_swap;
+		typedef typename Detail::always_equal_of<Alloc>::type is_always_equal;
+
+		template<class U>
+		using rebind_alloc = typename Detail::rebind_of<Alloc, U>::type;
+		template<class U>
+		using rebind_traits = allocator_traits<rebind_alloc<U> >;
+
+		static pointer allocate(Alloc& a, size_type n) {
+			return a.allocate(n);
+		}
+		static void deallocate(Alloc& a, pointer p, size_type n) {
+			a.deallocate(p, n);
+		}
+		// resize p from old_n to new_n elements keeping its first count ones, see allocator<T>::reallocate
+		static pointer reallocate(Alloc& a, pointer p, size_type old_n, size_type new_n, size_type count) {
+			return reallocate_aux(a, p, old_n, new_n, count, Detail::has_reallocate<Alloc>());
+		}
+
+		template<class T, class... Args>
+		static void construct(Alloc& a, T* p, Args&&... args) {
+			construct_aux(Detail::has_construct<Alloc, T, Args...>(), a, p, std::forward<Args>(args)...);
+		}
+		template<class T>
+		static void destroy(Alloc& a, T* p) {
+			destroy_aux(a, p, Detail::has_destroy<Alloc, T>());
+		}
+
+		static size_type max_size(const Alloc&) {
+			return size_type(-1) / sizeof(value_type);
+		}
+		static Alloc select_on_container_copy_construction(const Alloc& a) {
+			return select_aux(a, Detail::has_select_on_copy<Alloc>());
+		}
+
+	private:
+		template<class T, class... Args>
+		static void construct_aux(std::true_type, Alloc& a, T* p, Args&&... args) {
+			a.construct(p, std::forward<Args>(args)...);
+		}
+		template<class T, class... Args>
+		static void construct_aux(std::false_type, Alloc&, T* p, Args&&... args) {
+			new(static_cast<void*>(p)) T(std::forward<Args>(args)...);
+		}
+		static pointer reallocate_aux(Alloc& a, pointer p, size_type old_n, size_type new_n, size_type count, std::true_type) {
+			return a.reallocate(p, old_n, new_n, count);
+		}
+		static pointer reallocate_aux(Alloc& a, pointer p, size_type old_n, size_type new_n, size_type count, std::false_type) {
+			pointer result = new_n != 0 ? allocate(a, new_n) : pointer();
+			size_type i = 0;
+			try {
+				for (; i != count; ++i) {
+					construct(a, result + i, std::move_if_noexcept(p[i]));
+				}
+			}
+			catch (...) {
+				for (size_type j = 0; j != i; ++j) destroy(a, result + j);
+				deallocate(a, result, new_n);
+				throw;
+			}
+			for (size_type j = 0; j != count; ++j) destroy(a, p + j);
+			if (old_n != 0) deallocate(a, p, old_n);
+			return result;
+		}
+		template<class T>
+		static void destroy_aux(Alloc& a, T* p, std::true_type) { a.destroy(p); }
+		template<class T>
+		static void destroy_aux(Alloc&, T* p, std::false_type) { p->~T(); }
+		static Alloc select_aux(const Alloc& a, std::true_type) { return a.select_on_container_copy_construction(); }
+		static Alloc select_aux(const Alloc& a, std::false_type) { return a; }
+	};
+} // namespace tinySTL
+
+#endif // _ALLOCATOR_TRAITS_H_
@@ -0,0 +1,202 @@
+#ifndef _ARENA_ALLOCATOR_H_
+#define _ARENA_ALLOCATOR_H_
+
+#include "Alloc.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+namespace tinySTL {
+
+	/*
+	** Monotonic memory resource: memory is bump-allocated from blocks taken from
+	** alloc, deallocate is a no-op and everything is given back at once by
+	** reset() or release(). Block sizes double from the initial size up to
+	** MAX_BLOCK_SIZE, or further when a single request needs it.
+	** reset() keeps the newest (largest) block for reuse, so a request-scoped
+	** arena that is reset after every request stops allocating once it has grown.
+	*/
+	class arena {
+		private:
+			enum EBlockSize{ MIN_BLOCK_SIZE = 4096, MAX_BLOCK_SIZE = 1024 * 1024 };
+			struct block {
+				block* next;
+				size_t size;	// bytes obtained from alloc, header included
+			};
+		private:
+			block *blocks_;		// newest first
+			char *cur_;
+			char *end_;
+			size_t next_size_;
+		public:
+			explicit arena(size_t initial_size = EBlockSize::MIN_BLOCK_SIZE);
+			arena(const arena&) = delete;
+			arena& operator = (const arena&) = delete;
+			~arena();
+
+			void *allocate(size_t bytes, size_t align = alignof(std::max_align_t));
+			void deallocate(void *, size_t) {}
+
+			void reset();
+			void release();
+			size_t capacity() const;
+		private:
+			static size_t HEADER() {
+				return (sizeof(block) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+			}
+			void *allocate_block(size_t bytes, size_t align);
+	};
+
+	inline arena::arena(size_t initial_size)
+		:blocks_(0), cur_(0), end_(0),
+		next_size_(initial_size < EBlockSize::MIN_BLOCK_SIZE ? size_t(EBlockSize::MIN_BLOCK_SIZE) : initial_size) {}
+
+	inline arena::~arena() {
+		release();
+	}
+
+	inline void *arena::allocate(size_t bytes, size_t align) {
+		uintptr_t p = (reinterpret_cast<uintptr_t>(cur_) + align - 1) & ~uintptr_t(align - 1);
+		if (cur_ != 0 && p + bytes <= reinterpret_cast<uintptr_t>(end_)) {
+			cur_ = reinterpret_cast<char *>(p + bytes);
+			return reinterpret_cast<void *>(p);
+		}
+		return allocate_block(bytes, align);
+	}
+
+	inline void *arena::allocate_block(size_t bytes, size_t align) {
+		size_t need = HEADER() + bytes + align;
+		size_t size = next_size_;
+		while (size < need) size *= 2;
+		block *b = static_cast<block *>(alloc::allocate(size));
+		b->size = size;
+		b->next = blocks_;
+		blocks_ = b;
+		if (next_size_ < EBlockSize::MAX_BLOCK_SIZE) {
+			next_size_ *= 2;
+		}
+		uintptr_t p = (reinterpret_cast<uintptr_t>(b) + HEADER() + align - 1) & ~uintptr_t(align - 1);
+		cur_ = reinterpret_cast<char *>(p + bytes);
+		end_ = reinterpret_cast<char *>(b) + size;
+		return reinterpret_cast<void *>(p);
+	}
+
+	// free every block but the newest one and rewind it
+	inline void arena::reset() {
+		if (blocks_ == 0) return;
+		block *keep = blocks_;
+		block *b = keep->next;
+		while (b) {
+			block *next = b->next;
+			alloc::deallocate(b, b->size);
+			b = next;
+		}
+		keep->next = 0;
+		cur_ = reinterpret_cast<char *>(keep) + HEADER();
+		end_ = reinterpret_cast<char *>(keep) + keep->size;
+	}
+
+	inline void arena::release() {
+		block *b = blocks_;
+		while (b) {
+			block *next = b->next;
+			alloc::deallocate(b, b->size);
+			b = next;
+		}
+		blocks_ = 0;
+		cur_ = end_ = 0;
+	}
+
+	inline size_t arena::capacity() const {
+		size_t total = 0;
+		for (block *b = blocks_; b; b = b->next) {
+			total += b->size;
+		}
+		return total;
+	}
+
+	/*
+	** Stateful allocator handing out memory of an arena. It has the interface of
+	** allocator<T>, but as members of an instance that refers to its arena, so it
+	** can be given to containers through their Alloc parameter. Copies (and
+	** rebound copies) share the arena and compare equal.
+	*/
+	template<class T>
+	class arena_allocator {
+		public:
+			typedef T       value_type;
+			typedef T*      pointer;
+			typedef const T* const_pointer;
+			typedef T&      reference;
+			typedef const T& const_reference;
+			typedef size_t  size_type;
+			typedef ptrdiff_t difference_type;
+
+			template<class U>
+			struct rebind { typedef arena_allocator<U> other; };
+
+		private:
+			template<class U>
+			friend class arena_allocator;
+			arena *arena_;
+
+		public:
+			explicit arena_allocator(arena& a) :arena_(&a) {}
+			template<class U>
+			arena_allocator(const arena_allocator<U>& other) :arena_(other.arena_) {}
+
+			T* allocate();
+			T* allocate(size_t n);
+
+			void deallocate(T*) {}
+			void deallocate(T*, size_t) {}
+
+			template<class... Args>
+			void construct(T* p, Args&&... args);
+
+			void destroy(T* p);
+			void destroy(T* first, T* last);
+
+			arena *resource() const { return arena_; }
+	};
+
+	template<class T>
+	T* arena_allocator<T>::allocate() {
+		return static_cast<T*>(arena_->allocate(sizeof(T), alignof(T)));
+	}
+	template<class T>
+	T* arena_allocator<T>::allocate(size_t n) {
+		if (n == 0) return 0;
+		return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+	}
+
+	template<class T>
+	template<class... Args>
+	void arena_allocator<T>::construct(T* p, Args&&... args) {
+		new(p) T(std::forward<Args>(args)...);
+	}
+
+	template<class T>
+	void arena_allocator<T>::destroy(T* p) {
+		p->~T();
+	}
+	template<class T>
+	void arena_allocator<T>::destroy(T* first, T* last) {
+		for (; first != last; ++first) {
+			first->~T();
+		}
+	}
+
+	template<class T, class U>
+	bool operator == (const arena_allocator<T>& a, const arena_allocator<U>& b) {
+		return a.resource() == b.resource();
+	}
+	template<class T, class U>
+	bool operator != (const arena_allocator<T>& a, const arena_allocator<U>& b) {
+		return !(a == b);
+	}
+} // namespace tinySTL
+
+#endif // _ARENA_ALLOCATOR_H_
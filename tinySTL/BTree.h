@@ -0,0 +1,1279 @@
+#ifndef _BTREE_H_
+#define _BTREE_H_
+
+#include "Allocator.h"
+#include "AllocatorTraits.h"
+#include "Functional.h"
+#include "Iterator.h"
+#include "ReverseIterator.h"
+#include "TypeTraits.h"
+#include "UninitializedFunctions.h"
+#include "Utility.h"
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace tinySTL {
+	namespace Detail {
+		struct btree_node_base {
+			btree_node_base *parent;
+			unsigned short position;	// index in parent's children
+			unsigned short count;		// elements of a leaf, keys of an internal node
+			bool leaf;
+		};
+
+		// N uninitialised T side by side
+		template<class T, size_t N>
+		struct btree_array {
+			typename std::aligned_storage<sizeof(T), alignof(T)>::type buf_[N];
+			T *data() { return reinterpret_cast<T*>(buf_); }
+			const T *data() const { return reinterpret_cast<const T*>(buf_); }
+		};
+
+		/*
+		** The leaves hold every element, the keys in one array and the mapped
+		** values (maps only) in another, so that a search in a node reads
+		** nothing but keys. Leaves are chained in key order for range scans.
+		** Internal nodes hold separator keys: child i has the keys k with
+		** keys[i - 1] <= k < keys[i].
+		*/
+		template<class Key, class Mapped, size_t N>
+		struct btree_leaf : btree_node_base {
+			btree_leaf *prev;
+			btree_leaf *next;
+			btree_array<Key, N> keys;
+			btree_array<Mapped, N> values;
+		};
+		template<class Key, size_t N>
+		struct btree_leaf<Key, void, N> : btree_node_base {
+			btree_leaf *prev;
+			btree_leaf *next;
+			btree_array<Key, N> keys;
+		};
+		template<class Key, size_t N>
+		struct btree_internal : btree_node_base {
+			btree_array<Key, N> keys;
+			btree_node_base *children[N + 1];
+		};
+
+		template<class Mapped>
+		struct btree_mapped_bytes : std::integral_constant<size_t, sizeof(Mapped)> {};
+		template<>
+		struct btree_mapped_bytes<void> : std::integral_constant<size_t, 0> {};
+
+		// as many slots as fit in NodeBytes, so a node spans whole cache lines and one pool size class
+		template<class Key, class Mapped, size_t NodeBytes>
+		struct btree_shape {
+			static_assert(NodeBytes % 64 == 0 && NodeBytes >= 128, "NodeBytes must be a multiple of a 64 byte cache line, at least two");
+			enum ELeafFit{ LEAF_FIT = (NodeBytes - sizeof(btree_node_base) - 2 * sizeof(void*)) / (sizeof(Key) + btree_mapped_bytes<Mapped>::value) };
+			enum EInternalFit{ INTERNAL_FIT = (NodeBytes - sizeof(btree_node_base) - sizeof(void*)) / (sizeof(Key) + sizeof(void*)) };
+			enum ELeafSlots{ LEAF_SLOTS = LEAF_FIT < 4 ? 4 : LEAF_FIT };
+			enum EInternalSlots{ INTERNAL_SLOTS = INTERNAL_FIT < 4 ? 4 : INTERNAL_FIT };
+			static_assert(LEAF_SLOTS < 65536 && INTERNAL_SLOTS < 65536, "too many slots for a node");
+		};
+
+		// what a map iterator gives: the key and the value next to each other, by reference
+		template<class Reference>
+		class btree_arrow {
+			private:
+				Reference ref_;
+			public:
+				explicit btree_arrow(const Reference& ref) :ref_(ref) {}
+				const Reference *operator ->() const { return &ref_; }
+		};
+
+		template<class Key, class Mapped, bool Const>
+		struct btree_access {
+			typedef pair<const Key, Mapped> value_type;
+			typedef typename std::conditional<Const, const Mapped, Mapped>::type mapped_type;
+			typedef pair<const Key&, mapped_type&> reference;
+			typedef btree_arrow<reference> pointer;
+
+			template<class Leaf>
+			static reference get(Leaf *leaf, size_t i) { return reference(leaf->keys.data()[i], leaf->values.data()[i]); }
+			static pointer arrow(const reference& ref) { return pointer(ref); }
+		};
+		template<class Key, bool Const>
+		struct btree_access<Key, void, Const> {
+			typedef Key value_type;
+			typedef const Key& reference;
+			typedef const Key* pointer;
+
+			template<class Leaf>
+			static reference get(Leaf *leaf, size_t i) { return leaf->keys.data()[i]; }
+			static pointer arrow(reference ref) { return &ref; }
+		};
+
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		class btree;
+
+		/*
+		** A leaf and a place in it. end() is one past the last element of the
+		** last leaf; every other iterator points at an element. Any insert or
+		** erase may move elements between leaves and invalidates iterators.
+		*/
+		template<class Key, class Mapped, size_t N, bool Const>
+		class btree_iter : public iterator<bidirectional_iterator_tag, typename btree_access<Key, Mapped, Const>::value_type, ptrdiff_t,
+			typename btree_access<Key, Mapped, Const>::pointer, typename btree_access<Key, Mapped, Const>::reference> {
+			private:
+				template<class K, class M, class C, class A, size_t B>
+				friend class btree;
+				template<class K, class M, size_t S, bool C>
+				friend class btree_iter;
+				friend struct ::tinySTL::segmented_iterator_traits<btree_iter>;
+				typedef btree_access<Key, Mapped, Const> access;
+				typedef btree_leaf<Key, Mapped, N> leaf_type;
+			public:
+				typedef typename access::value_type value_type;
+				typedef ptrdiff_t difference_type;
+				typedef typename access::pointer pointer;
+				typedef typename access::reference reference;
+			private:
+				leaf_type *leaf_;
+				int pos_;
+			public:
+				btree_iter() :leaf_(0), pos_(0) {}
+				// iterator -> const_iterator
+				template<bool C, class = typename std::enable_if<Const && !C>::type>
+				btree_iter(const btree_iter<Key, Mapped, N, C>& it) :leaf_(it.leaf_), pos_(it.pos_) {}
+
+				reference operator *() const { return access::get(leaf_, pos_); }
+				pointer operator ->() const { return access::arrow(**this); }
+				btree_iter& operator ++() {
+					if (++pos_ == leaf_->count && leaf_->next) {
+						leaf_ = leaf_->next;
+						pos_ = 0;
+					}
+					return *this;
+				}
+				btree_iter operator ++(int) {
+					btree_iter temp = *this;
+					++*this;
+					return temp;
+				}
+				// before begin() is allowed too, for reverse iterators; only ++ may follow
+				btree_iter& operator --() {
+					if (pos_ == 0 && leaf_->prev) {
+						leaf_ = leaf_->prev;
+						pos_ = leaf_->count;
+					}
+					--pos_;
+					return *this;
+				}
+				btree_iter operator --(int) {
+					btree_iter temp = *this;
+					--*this;
+					return temp;
+				}
+				friend bool operator ==(const btree_iter& it1, const btree_iter& it2) { return it1.leaf_ == it2.leaf_ && it1.pos_ == it2.pos_; }
+				friend bool operator !=(const btree_iter& it1, const btree_iter& it2) { return !(it1 == it2); }
+			private:
+				btree_iter(leaf_type *leaf, size_t pos) :leaf_(leaf), pos_(static_cast<int>(pos)) {}
+		};
+
+		// steps from leaf to leaf: the segments of a btree range
+		template<class Leaf>
+		class btree_leaf_cursor {
+			private:
+				Leaf *leaf_;
+			public:
+				explicit btree_leaf_cursor(Leaf *leaf) :leaf_(leaf) {}
+				Leaf *get() const { return leaf_; }
+				btree_leaf_cursor& operator ++() {
+					leaf_ = leaf_->next;
+					return *this;
+				}
+				friend bool operator ==(const btree_leaf_cursor& c1, const btree_leaf_cursor& c2) { return c1.leaf_ == c2.leaf_; }
+				friend bool operator !=(const btree_leaf_cursor& c1, const btree_leaf_cursor& c2) { return c1.leaf_ != c2.leaf_; }
+		};
+
+		// walks the key and value arrays of one map leaf together
+		template<class Key, class Mapped, bool Const>
+		class btree_zip_iter : public iterator<forward_iterator_tag, typename btree_access<Key, Mapped, Const>::value_type, ptrdiff_t,
+			typename btree_access<Key, Mapped, Const>::pointer, typename btree_access<Key, Mapped, Const>::reference> {
+			private:
+				typedef btree_access<Key, Mapped, Const> access;
+				typedef typename access::mapped_type mapped_type;
+			public:
+				typedef typename access::value_type value_type;
+				typedef ptrdiff_t difference_type;
+				typedef typename access::pointer pointer;
+				typedef typename access::reference reference;
+			private:
+				const Key *key_;
+				mapped_type *value_;
+			public:
+				btree_zip_iter() :key_(0), value_(0) {}
+				btree_zip_iter(const Key *key, mapped_type *value) :key_(key), value_(value) {}
+				const Key *key() const { return key_; }
+
+				reference operator *() const { return reference(*key_, *value_); }
+				pointer operator ->() const { return pointer(**this); }
+				btree_zip_iter& operator ++() {
+					++key_;
+					++value_;
+					return *this;
+				}
+				btree_zip_iter operator ++(int) {
+					btree_zip_iter temp = *this;
+					++*this;
+					return temp;
+				}
+				friend bool operator ==(const btree_zip_iter& it1, const btree_zip_iter& it2) { return it1.key_ == it2.key_; }
+				friend bool operator !=(const btree_zip_iter& it1, const btree_zip_iter& it2) { return it1.key_ != it2.key_; }
+		};
+
+		template<class Key, class Mapped, bool Const>
+		struct btree_local {
+			typedef btree_zip_iter<Key, Mapped, Const> type;
+			template<class Leaf>
+			static type at(Leaf *leaf, size_t i) { return type(leaf->keys.data() + i, leaf->values.data() + i); }
+			template<class Leaf>
+			static size_t index(Leaf *leaf, type it) { return it.key() - leaf->keys.data(); }
+		};
+		template<class Key, bool Const>
+		struct btree_local<Key, void, Const> {
+			typedef const Key *type;
+			template<class Leaf>
+			static type at(Leaf *leaf, size_t i) { return leaf->keys.data() + i; }
+			template<class Leaf>
+			static size_t index(Leaf *leaf, type it) { return it - leaf->keys.data(); }
+		};
+
+		// keys that compare with < can be counted without a branch per key
+		template<class Key, class Compare>
+		struct btree_counts_less : std::integral_constant<bool, std::is_arithmetic<Key>::value &&
+			(std::is_same<Compare, less<Key> >::value || std::is_same<Compare, std::less<Key> >::value)> {};
+
+		/*
+		** A B+ tree with unique keys. Nodes are allocated one at a time through
+		** Alloc rebound to the node type, which for allocator<T> means the
+		** alloc pool: with the default 256 byte nodes a leaf or an internal
+		** node fills one size class.
+		**
+		** Inserting into a full leaf splits it in two, and a separator moves up
+		** into the parent, splitting it in turn if full. Appending past the
+		** largest key keeps the left node full instead of halving it, so sorted
+		** input (bulk_load, or insert at end()) packs every node. An erase
+		** that leaves a node less than half full merges it with a neighbour or
+		** borrows from it.
+		**
+		** Elements are moved between and within nodes, so Key and the mapped
+		** type must be nothrow move constructible. Everything that may throw
+		** (allocating nodes, copying a separator key) is done before anything
+		** moves, so a failed insert leaves the tree as it was.
+		*/
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		class btree : private alloc_holder<Alloc> {
+			private:
+				typedef btree_shape<Key, Mapped, NodeBytes> shape;
+				enum ESlots{ LEAF_SLOTS = shape::LEAF_SLOTS, INTERNAL_SLOTS = shape::INTERNAL_SLOTS };
+				enum EMinSlots{ MIN_LEAF = LEAF_SLOTS / 2, MIN_INTERNAL = INTERNAL_SLOTS / 2 };
+				enum EMaxHeight{ MAX_HEIGHT = 64 };
+				enum ELinearRun{ LINEAR_RUN = 16 };
+				typedef btree_node_base node_base;
+				typedef btree_leaf<Key, Mapped, LEAF_SLOTS> leaf_type;
+				typedef btree_internal<Key, INTERNAL_SLOTS> internal_type;
+				typedef std::integral_constant<bool, !std::is_void<Mapped>::value> has_values;
+				typedef typename std::conditional<has_values::value, Mapped, Key>::type stored_mapped;
+				// an element on its way into the tree
+				typedef typename std::conditional<has_values::value, pair<Key, stored_mapped>, Key>::type slot_type;
+
+				static_assert(std::is_nothrow_move_constructible<Key>::value && std::is_nothrow_move_constructible<stored_mapped>::value,
+					"btree moves elements between nodes: Key and the mapped type must be nothrow move constructible");
+			public:
+				typedef Key key_type;
+				typedef Compare key_compare;
+				typedef Alloc allocator_type;
+				typedef size_t size_type;
+				typedef ptrdiff_t difference_type;
+				typedef btree_iter<Key, Mapped, LEAF_SLOTS, false> iterator;
+				typedef btree_iter<Key, Mapped, LEAF_SLOTS, true> const_iterator;
+				typedef reverse_iterator_t<iterator> reverse_iterator;
+				typedef reverse_iterator_t<const_iterator> const_reverse_iterator;
+				typedef typename iterator::value_type value_type;
+				typedef typename iterator::reference reference;
+				typedef typename const_iterator::reference const_reference;
+			private:
+				typedef allocator_traits<Alloc> dataTraits;
+				typedef typename dataTraits::template rebind_alloc<leaf_type> leafAllocator;
+				typedef allocator_traits<leafAllocator> leafTraits;
+				typedef typename dataTraits::template rebind_alloc<internal_type> internalAllocator;
+				typedef allocator_traits<internalAllocator> internalTraits;
+				typedef typename dataTraits::template rebind_alloc<Key> keyAllocator;
+				typedef allocator_traits<keyAllocator> keyTraits;
+				typedef typename dataTraits::template rebind_alloc<stored_mapped> mappedAllocator;
+				typedef allocator_traits<mappedAllocator> mappedTraits;
+				typedef alloc_holder<Alloc> holder;
+				typedef std::integral_constant<bool, is_trivially_relocatable<Key>::value
+					&& uses_placement_new<keyAllocator, Key&&>::value> keys_relocatable;
+				typedef std::integral_constant<bool, is_trivially_relocatable<stored_mapped>::value
+					&& uses_placement_new<mappedAllocator, stored_mapped&&>::value> values_relocatable;
+			private:
+				node_base *root_;
+				leaf_type *leftmost_;
+				leaf_type *rightmost_;
+				size_t size_;
+				Compare comp_;
+			public:
+				btree() :holder(), root_(emptyLeaf()), leftmost_(emptyLeaf()), rightmost_(emptyLeaf()), size_(0), comp_() {}
+				explicit btree(const Compare& comp, const allocator_type& alloc = allocator_type());
+				explicit btree(const allocator_type& alloc);
+				template<class InputIterator>
+				btree(InputIterator first, InputIterator last, const Compare& comp = Compare(), const allocator_type& alloc = allocator_type());
+				btree(std::initializer_list<value_type> list, const Compare& comp = Compare(), const allocator_type& alloc = allocator_type());
+				btree(const btree& other);
+				btree(btree&& other);
+				~btree();
+
+				btree& operator = (const btree& other);
+				btree& operator = (btree&& other);
+
+				iterator begin() { return iterator(leftmost_, 0); }
+				const_iterator begin() const { return const_iterator(leftmost_, 0); }
+				iterator end() { return iterator(rightmost_, rightmost_->count); }
+				const_iterator end() const { return const_iterator(rightmost_, rightmost_->count); }
+				const_iterator cbegin() const { return begin(); }
+				const_iterator cend() const { return end(); }
+				reverse_iterator rbegin() { return reverse_iterator(end()); }
+				const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+				reverse_iterator rend() { return reverse_iterator(begin()); }
+				const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+				allocator_type get_allocator() const { return this->get_alloc(); }
+				key_compare key_comp() const { return comp_; }
+			public:
+				size_type size() const { return size_; }
+				bool empty() const { return size_ == 0; }
+				size_type max_size() const { return size_t(-1) / sizeof(Key); }
+
+				pair<iterator, bool> insert(const value_type& value) { return emplace(value); }
+				pair<iterator, bool> insert(value_type&& value) { return emplace(std::move(value)); }
+				// value goes right before hint if that is its place: O(1) plus any split
+				iterator insert(const_iterator hint, const value_type& value) { return emplace_hint(hint, value); }
+				iterator insert(const_iterator hint, value_type&& value) { return emplace_hint(hint, std::move(value)); }
+				template<class InputIterator>
+				void insert(InputIterator first, InputIterator last);
+				void insert(std::initializer_list<value_type> list) { insert(list.begin(), list.end()); }
+				template<class... Args>
+				pair<iterator, bool> emplace(Args&&... args);
+				template<class... Args>
+				iterator emplace_hint(const_iterator hint, Args&&... args);
+				/*
+				** Replaces the contents with [first, last), which should be sorted.
+				** Every element then goes to the end of the last leaf and the nodes
+				** come out full. Duplicates are skipped; an element out of order is
+				** inserted the ordinary way.
+				*/
+				template<class InputIterator>
+				void bulk_load(InputIterator first, InputIterator last);
+
+				iterator erase(const_iterator pos);
+				iterator erase(const_iterator first, const_iterator last);
+				size_type erase(const key_type& key);
+				void clear();
+				void swap(btree& other);
+
+				iterator find(const key_type& key) { return findKey<iterator>(key); }
+				const_iterator find(const key_type& key) const { return findKey<const_iterator>(key); }
+				size_type count(const key_type& key) const { return find(key) != end() ? 1 : 0; }
+				bool contains(const key_type& key) const { return find(key) != end(); }
+				iterator lower_bound(const key_type& key) { return lowerBound<iterator>(key); }
+				const_iterator lower_bound(const key_type& key) const { return lowerBound<const_iterator>(key); }
+				iterator upper_bound(const key_type& key) { return upperBound<iterator>(key); }
+				const_iterator upper_bound(const key_type& key) const { return upperBound<const_iterator>(key); }
+				pair<iterator, iterator> equal_range(const key_type& key) { return pair<iterator, iterator>(lower_bound(key), upper_bound(key)); }
+				pair<const_iterator, const_iterator> equal_range(const key_type& key) const {
+					return pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key));
+				}
+			protected:
+				template<class K, class... Args>
+				pair<iterator, bool> tryEmplace(K&& key, Args&&... args);
+			private:
+				static leaf_type *emptyLeaf();
+				static const Key& keyOf(const slot_type& slot) { return keyOf(slot, has_values()); }
+				static const Key& keyOf(const Key& key, std::false_type) { return key; }
+				template<class Slot>
+				static const Key& keyOf(const Slot& slot, std::true_type) { return slot.first; }
+				static Key *keyAt(node_base *node, size_t i) { return static_cast<leaf_type*>(node)->keys.data() + i; }
+				static Key *ikeyAt(node_base *node, size_t i) { return static_cast<internal_type*>(node)->keys.data() + i; }
+				static node_base *&childAt(node_base *node, size_t i) { return static_cast<internal_type*>(node)->children[i]; }
+
+				template<class K>
+				size_t lowerIn(const Key *keys, size_t n, const K& key) const;
+				template<class K>
+				size_t upperIn(const Key *keys, size_t n, const K& key) const;
+				template<class K>
+				leaf_type *findLeaf(const K& key) const;
+				template<class Iterator>
+				Iterator normalize(leaf_type *leaf, size_t pos) const {
+					if (pos == leaf->count && leaf->next) return Iterator(leaf->next, 0);
+					return Iterator(leaf, pos);
+				}
+				template<class Iterator, class K>
+				Iterator findKey(const K& key) const;
+				template<class Iterator, class K>
+				Iterator lowerBound(const K& key) const;
+				template<class Iterator, class K>
+				Iterator upperBound(const K& key) const;
+
+				pair<iterator, bool> insertUnique(slot_type&& slot);
+				iterator insertSlot(leaf_type *leaf, size_t pos, slot_type&& slot);
+				iterator splitInsert(leaf_type *leaf, size_t pos, slot_type&& slot);
+				void insertSeparator(node_base *left, Key *sep, node_base *right, internal_type **spare, bool append);
+				iterator eraseAt(leaf_type *leaf, size_t pos);
+				void mergeLeaves(leaf_type *left, leaf_type *right);
+				void fixInternal(node_base *node);
+				void removeSeparator(node_base *node, size_t k);
+				void replaceSeparator(node_base *node, size_t k, const Key& key);
+				void adoptChildren(node_base *node, size_t from, size_t to);
+
+				leaf_type *newLeaf();
+				internal_type *newInternal();
+				void freeNode(node_base *node);
+				void freeTree(node_base *node);
+				void resetEmpty() { root_ = leftmost_ = rightmost_ = emptyLeaf(); size_ = 0; }
+				void appendFrom(const btree& other);
+				void swapData(btree& other);
+
+				static slot_type copySlot(leaf_type *leaf, size_t i, std::true_type) {
+					return slot_type(leaf->keys.data()[i], leaf->values.data()[i]);
+				}
+				static slot_type copySlot(leaf_type *leaf, size_t i, std::false_type) { return slot_type(leaf->keys.data()[i]); }
+				static slot_type takeSlot(leaf_type *leaf, size_t i, std::true_type) {
+					return slot_type(std::move(leaf->keys.data()[i]), std::move(leaf->values.data()[i]));
+				}
+				static slot_type takeSlot(leaf_type *leaf, size_t i, std::false_type) { return slot_type(std::move(leaf->keys.data()[i])); }
+				void constructSlot(leaf_type *leaf, size_t i, slot_type&& slot);
+				void constructValue(leaf_type *leaf, size_t i, slot_type&& slot, std::true_type);
+				void constructValue(leaf_type *, size_t, slot_type&&, std::false_type) {}
+				void destroySlot(leaf_type *leaf, size_t i);
+				void destroyValue(leaf_type *leaf, size_t i, std::true_type);
+				void destroyValue(leaf_type *, size_t, std::false_type) {}
+				// relocates n elements from src[i] to dst[j]; the ranges may overlap
+				void moveSlots(leaf_type *dst, size_t j, leaf_type *src, size_t i, size_t n);
+				void moveValues(leaf_type *dst, size_t j, leaf_type *src, size_t i, size_t n, std::true_type);
+				void moveValues(leaf_type *, size_t, leaf_type *, size_t, size_t, std::false_type) {}
+				void moveKeys(Key *dst, Key *src, size_t n);
+				template<class T, class Traits, class A>
+				static void relocate(T *dst, T *src, size_t n, A& alloc, std::true_type);
+				template<class T, class Traits, class A>
+				static void relocate(T *dst, T *src, size_t n, A& alloc, std::false_type);
+		};
+
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		btree<Key, Mapped, Compare, Alloc, NodeBytes>::btree(const Compare& comp, const allocator_type& alloc)
+			:holder(alloc), root_(emptyLeaf()), leftmost_(emptyLeaf()), rightmost_(emptyLeaf()), size_(0), comp_(comp) {}
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		btree<Key, Mapped, Compare, Alloc, NodeBytes>::btree(const allocator_type& alloc)
+			:holder(alloc), root_(emptyLeaf()), leftmost_(emptyLeaf()), rightmost_(emptyLeaf()), size_(0), comp_() {}
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		template<class InputIterator>
+		btree<Key, Mapped, Compare, Alloc, NodeBytes>::btree(InputIterator first, InputIterator last, const Compare& comp,
+			const allocator_type& alloc)
+			:holder(alloc), root_(emptyLeaf()), leftmost_(emptyLeaf()), rightmost_(emptyLeaf()), size_(0), comp_(comp) {
+			bulk_load(first, last);
+		}
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		btree<Key, Mapped, Compare, Alloc, NodeBytes>::btree(std::initializer_list<value_type> list, const Compare& comp,
+			const allocator_type& alloc)
+			:holder(alloc), root_(emptyLeaf()), leftmost_(emptyLeaf()), rightmost_(emptyLeaf()), size_(0), comp_(comp) {
+			bulk_load(list.begin(), list.end());
+		}
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		btree<Key, Mapped, Compare, Alloc, NodeBytes>::btree(const btree& other)
+			:holder(dataTraits::select_on_container_copy_construction(other.get_alloc())),
+			root_(emptyLeaf()), leftmost_(emptyLeaf()), rightmost_(emptyLeaf()), size_(0), comp_(other.comp_) {
+			appendFrom(other);
+		}
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		btree<Key, Mapped, Compare, Alloc, NodeBytes>::btree(btree&& other)
+			:holder(other.get_alloc()), root_(emptyLeaf()), leftmost_(emptyLeaf()), rightmost_(emptyLeaf()), size_(0), comp_(other.comp_) {
+			swapData(other);
+		}
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		btree<Key, Mapped, Compare, Alloc, NodeBytes>::~btree() {
+			freeTree(root_);
+		}
+
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		btree<Key, Mapped, Compare, Alloc, NodeBytes>& btree<Key, Mapped, Compare, Alloc, NodeBytes>::operator = (const btree& other) {
+			if (this != &other) {
+				// build the copy with the allocator this tree will end up with
+				const bool propagate = dataTraits::propagate_on_container_copy_assignment::value;
+				btree temp(other.comp_, propagate ? other.get_alloc() : this->get_alloc());
+				temp.appendFrom(other);
+				swapData(temp);
+				if (propagate) {
+					tinySTL::swap(this->get_alloc(), temp.get_alloc());
+				}
+			}
+			return *this;
+		}
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		btree<Key, Mapped, Compare, Alloc, NodeBytes>& btree<Key, Mapped, Compare, Alloc, NodeBytes>::operator = (btree&& other) {
+			if (this == &other) return *this;
+			if (dataTraits::propagate_on_container_move_assignment::value
+				|| dataTraits::is_always_equal::value || this->get_alloc() == other.get_alloc()) {
+				// take other's nodes; other gets ours and frees them with its own allocator
+				swapData(other);
+				if (dataTraits::propagate_on_container_move_assignment::value) {
+					tinySTL::swap(this->get_alloc(), other.get_alloc());
+				}
+				other.clear();
+			}
+			else {
+				// the nodes belong to another allocator: move the elements instead
+				btree temp(other.comp_, this->get_alloc());
+				for (leaf_type *leaf = other.leftmost_; leaf; leaf = leaf->next) {
+					for (size_t i = 0; i != leaf->count; ++i) {
+						temp.insertSlot(temp.rightmost_, temp.rightmost_->count, takeSlot(leaf, i, has_values()));
+					}
+				}
+				swapData(temp);
+				other.clear();
+			}
+			return *this;
+		}
+
+		// the leaf of a tree with no elements: never written to, never freed
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		typename btree<Key, Mapped, Compare, Alloc, NodeBytes>::leaf_type *btree<Key, Mapped, Compare, Alloc, NodeBytes>::emptyLeaf() {
+			struct empty_leaf : leaf_type {
+				empty_leaf() {
+					this->parent = 0;
+					this->position = 0;
+					this->count = 0;
+					this->leaf = true;
+					this->prev = 0;
+					this->next = 0;
+				}
+			};
+			static empty_leaf leaf;
+			return &leaf;
+		}
+
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		template<class InputIterator>
+		void btree<Key, Mapped, Compare, Alloc, NodeBytes>::insert(InputIterator first, InputIterator last) {
+			for (; first != last; ++first) {
+				emplace_hint(end(), *first);
+			}
+		}
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		template<class... Args>
+		pair<typename btree<Key, Mapped, Compare, Alloc, NodeBytes>::iterator, bool> btree<Key, Mapped, Compare, Alloc, NodeBytes>::emplace(Args&&... args) {
+			return insertUnique(slot_type(std::forward<Args>(args)...));
+		}
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		template<class... Args>
+		typename btree<Key, Mapped, Compare, Alloc, NodeBytes>::iterator btree<Key, Mapped, Compare, Alloc, NodeBytes>::emplace_hint(const_iterator hint, Args&&... args) {
+			slot_type slot(std::forward<Args>(args)...);
+			const Key& key = keyOf(slot);
+			leaf_type *leaf = hint.leaf_;
+			const size_t pos = hint.pos_;
+			// only inside hint's leaf: before the first key of a later leaf the separator decides
+			if (size_ != 0 && (pos != 0 || leaf == leftmost_)
+				&& (pos == leaf->count || comp_(key, leaf->keys.data()[pos]))
+				&& (pos == 0 || comp_(leaf->keys.data()[pos - 1], key))) {
+				return insertSlot(leaf, pos, std::move(slot));
+			}
+			return insertUnique(std::move(slot)).first;
+		}
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		template<class InputIterator>
+		void btree<Key, Mapped, Compare, Alloc, NodeBytes>::bulk_load(InputIterator first, InputIterator last) {
+			clear();
+			insert(first, last);
+		}
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		template<class K, class... Args>
+		pair<typename btree<Key, Mapped, Compare, Alloc, NodeBytes>::iterator, bool> btree<Key, Mapped, Compare, Alloc, NodeBytes>::tryEmplace(K&& key, Args&&... args) {
+			leaf_type *leaf = findLeaf(key);
+			const size_t pos = lowerIn(leaf->keys.data(), leaf->count, key);
+			if (pos != leaf->count && !comp_(key, leaf->keys.data()[pos])) {
+				return pair<iterator, bool>(iterator(leaf, pos), false);
+			}
+			return pair<iterator, bool>(insertSlot(leaf, pos, slot_type(std::piecewise_construct,
+				std::forward_as_tuple(std::forward<K>(key)), std::forward_as_tuple(std::forward<Args>(args)...))), true);
+		}
+
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		typename btree<Key, Mapped, Compare, Alloc, NodeBytes>::iterator btree<Key, Mapped, Compare, Alloc, NodeBytes>::erase(const_iterator pos) {
+			return eraseAt(pos.leaf_, pos.pos_);
+		}
+		// each erase returns the element after the erased one, wherever rebalancing put it
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		typename btree<Key, Mapped, Compare, Alloc, NodeBytes>::iterator btree<Key, Mapped, Compare, Alloc, NodeBytes>::erase(const_iterator first, const_iterator last) {
+			size_t n = 0;
+			for (const_iterator it = first; it != last; ++it) {
+				++n;
+			}
+			if (n == size_) {
+				clear();
+				return end();
+			}
+			iterator it(first.leaf_, first.pos_);
+			for (; n != 0; --n) {
+				it = eraseAt(it.leaf_, it.pos_);
+			}
+			return it;
+		}
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		typename btree<Key, Mapped, Compare, Alloc, NodeBytes>::size_type btree<Key, Mapped, Compare, Alloc, NodeBytes>::erase(const key_type& key) {
+			iterator it = find(key);
+			if (it == end()) return 0;
+			eraseAt(it.leaf_, it.pos_);
+			return 1;
+		}
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		void btree<Key, Mapped, Compare, Alloc, NodeBytes>::clear() {
+			freeTree(root_);
+			resetEmpty();
+		}
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		void btree<Key, Mapped, Compare, Alloc, NodeBytes>::swap(btree& other) {
+			swapData(other);
+			if (dataTraits::propagate_on_container_swap::value) {
+				tinySTL::swap(this->get_alloc(), other.get_alloc());
+			}
+		}
+
+		/*
+		** Halve the range until a short run is left, then count the keys
+		** before key in one pass; for numbers that pass has no branch.
+		*/
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		template<class K>
+		inline size_t btree<Key, Mapped, Compare, Alloc, NodeBytes>::lowerIn(const Key *keys, size_t n, const K& key) const {
+			size_t lo = 0;
+			while (n > LINEAR_RUN) {
+				size_t half = n / 2;
+				if (comp_(keys[lo + half], key)) {
+					lo += half + 1;
+					n -= half + 1;
+				}
+				else {
+					n = half;
+				}
+			}
+			if (btree_counts_less<Key, Compare>::value) {
+				size_t count = 0;
+				for (size_t i = 0; i != n; ++i) {
+					count += keys[lo + i] < key;
+				}
+				return lo + count;
+			}
+			while (n != 0 && comp_(keys[lo], key)) {
+				++lo;
+				--n;
+			}
+			return lo;
+		}
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		template<class K>
+		inline size_t btree<Key, Mapped, Compare, Alloc, NodeBytes>::upperIn(const Key *keys, size_t n, const K& key) const {
+			size_t lo = 0;
+			while (n > LINEAR_RUN) {
+				size_t half = n / 2;
+				if (!comp_(key, keys[lo + half])) {
+					lo += half + 1;
+					n -= half + 1;
+				}
+				else {
+					n = half;
+				}
+			}
+			if (btree_counts_less<Key, Compare>::value) {
+				size_t count = 0;
+				for (size_t i = 0; i != n; ++i) {
+					count += !(key < keys[lo + i]);
+				}
+				return lo + count;
+			}
+			while (n != 0 && !comp_(key, keys[lo])) {
+				++lo;
+				--n;
+			}
+			return lo;
+		}
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		template<class K>
+		typename btree<Key, Mapped, Compare, Alloc, NodeBytes>::leaf_type *btree<Key, Mapped, Compare, Alloc, NodeBytes>::findLeaf(const K& key) const {
+			node_base *node = root_;
+			while (!node->leaf) {
+				internal_type *in = static_cast<internal_type*>(node);
+				node = in->children[upperIn(in->keys.data(), in->count, key)];
+			}
+			return static_cast<leaf_type*>(node);
+		}
+		// a key past the end of its leaf is below the separator, so it is not in the next leaf either
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		template<class Iterator, class K>
+		Iterator btree<Key, Mapped, Compare, Alloc, NodeBytes>::findKey(const K& key) const {
+			leaf_type *leaf = findLeaf(key);
+			const size_t pos = lowerIn(leaf->keys.data(), leaf->count, key);
+			if (pos != leaf->count && !comp_(key, leaf->keys.data()[pos])) return Iterator(leaf, pos);
+			return Iterator(rightmost_, rightmost_->count);
+		}
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		template<class Iterator, class K>
+		Iterator btree<Key, Mapped, Compare, Alloc, NodeBytes>::lowerBound(const K& key) const {
+			leaf_type *leaf = findLeaf(key);
+			return normalize<Iterator>(leaf, lowerIn(leaf->keys.data(), leaf->count, key));
+		}
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		template<class Iterator, class K>
+		Iterator btree<Key, Mapped, Compare, Alloc, NodeBytes>::upperBound(const K& key) const {
+			leaf_type *leaf = findLeaf(key);
+			return normalize<Iterator>(leaf, upperIn(leaf->keys.data(), leaf->count, key));
+		}
+
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		pair<typename btree<Key, Mapped, Compare, Alloc, NodeBytes>::iterator, bool> btree<Key, Mapped, Compare, Alloc, NodeBytes>::insertUnique(slot_type&& slot) {
+			const Key& key = keyOf(slot);
+			leaf_type *leaf = findLeaf(key);
+			const size_t pos = lowerIn(leaf->keys.data(), leaf->count, key);
+			if (pos != leaf->count && !comp_(key, leaf->keys.data()[pos])) {
+				return pair<iterator, bool>(iterator(leaf, pos), false);
+			}
+			return pair<iterator, bool>(insertSlot(leaf, pos, std::move(slot)), true);
+		}
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		typename btree<Key, Mapped, Compare, Alloc, NodeBytes>::iterator btree<Key, Mapped, Compare, Alloc, NodeBytes>::insertSlot(leaf_type *leaf, size_t pos, slot_type&& slot) {
+			if (leaf == emptyLeaf()) {
+				leaf = newLeaf();
+				root_ = leftmost_ = rightmost_ = leaf;
+				pos = 0;
+			}
+			if (leaf->count == LEAF_SLOTS) {
+				return splitInsert(leaf, pos, std::move(slot));
+			}
+			moveSlots(leaf, pos + 1, leaf, pos, leaf->count - pos);
+			constructSlot(leaf, pos, std::move(slot));
+			++leaf->count;
+			++size_;
+			return iterator(leaf, pos);
+		}
+		/*
+		** The full leaf with slot inserted at pos is cut in two: the first
+		** `split` elements stay, the rest go to a new leaf on its right, whose
+		** first key is copied up as the separator.
+		*/
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		typename btree<Key, Mapped, Compare, Alloc, NodeBytes>::iterator btree<Key, Mapped, Compare, Alloc, NodeBytes>::splitInsert(leaf_type *leaf, size_t pos, slot_type&& slot) {
+			// allocate every node the split can need, and copy the separator, before anything moves
+			internal_type *spare[MAX_HEIGHT];
+			size_t needed = 0;
+			node_base *node = leaf->parent;
+			for (; node && node->count == INTERNAL_SLOTS; node = node->parent) {
+				++needed;
+			}
+			if (!node) ++needed;	// a new root
+			const bool append = leaf == rightmost_ && pos == leaf->count;
+			const size_t total = leaf->count + 1;
+			const size_t split = append ? leaf->count : total / 2;
+			keyAllocator keyAlloc(this->get_alloc());
+			typename std::aligned_storage<sizeof(Key), alignof(Key)>::type sepBuf;
+			Key *sep = reinterpret_cast<Key*>(&sepBuf);
+			leaf_type *right = newLeaf();
+			size_t made = 0;
+			try {
+				for (; made != needed; ++made) {
+					spare[made] = newInternal();
+				}
+				const Key& first = split == pos ? keyOf(slot) : leaf->keys.data()[split < pos ? split : split - 1];
+				keyTraits::construct(keyAlloc, sep, first);
+			}
+			catch (...) {
+				while (made != 0) freeNode(spare[--made]);
+				freeNode(right);
+				throw;
+			}
+			if (pos >= split) {
+				moveSlots(right, 0, leaf, split, pos - split);
+				constructSlot(right, pos - split, std::move(slot));
+				moveSlots(right, pos - split + 1, leaf, pos, leaf->count - pos);
+			}
+			else {
+				moveSlots(right, 0, leaf, split - 1, leaf->count - split + 1);
+				moveSlots(leaf, pos + 1, leaf, pos, split - 1 - pos);
+				constructSlot(leaf, pos, std::move(slot));
+			}
+			right->count = static_cast<unsigned short>(total - split);
+			leaf->count = static_cast<unsigned short>(split);
+			++size_;
+			right->prev = leaf;
+			right->next = leaf->next;
+			if (leaf->next) {
+				leaf->next->prev = right;
+			}
+			else {
+				rightmost_ = right;
+			}
+			leaf->next = right;
+			insertSeparator(leaf, sep, right, spare, append);
+			return pos >= split ? iterator(right, pos - split) : iterator(leaf, pos);
+		}
+		/*
+		** Puts *sep (moved from) and the new node right after left in their
+		** parent. A full parent is cut the same way as a leaf: with sep and
+		** right in place it has one key too many, and the key at the cut
+		** moves up instead of being copied.
+		*/
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		void btree<Key, Mapped, Compare, Alloc, NodeBytes>::insertSeparator(node_base *left, Key *sep, node_base *right, internal_type **spare, bool append) {
+			for (;;) {
+				node_base *parent = left->parent;
+				if (!parent) {
+					internal_type *root = *spare;
+					moveKeys(root->keys.data(), sep, 1);
+					root->children[0] = left;
+					root->children[1] = right;
+					root->count = 1;
+					adoptChildren(root, 0, 2);
+					root_ = root;
+					return;
+				}
+				const size_t i = left->position;
+				Key *keys = ikeyAt(parent, 0);
+				node_base **children = static_cast<internal_type*>(parent)->children;
+				if (parent->count < INTERNAL_SLOTS) {
+					moveKeys(keys + i + 1, keys + i, parent->count - i);
+					moveKeys(keys + i, sep, 1);
+					memmove(children + i + 2, children + i + 1, (parent->count - i) * sizeof(node_base*));
+					children[i + 1] = right;
+					++parent->count;
+					adoptChildren(parent, i + 1, parent->count + 1);
+					return;
+				}
+				// key j of the parent with sep in place is keys[j] before i, sep at i, keys[j - 1] after
+				internal_type *sibling = *spare++;
+				const size_t full = parent->count;
+				// an append leaves the sibling one key and two children, the least an internal node may hold
+				const size_t cut = append && i == full ? full - 1 : (full + 1) / 2;
+				for (size_t j = cut + 1; j <= full; ++j) {
+					moveKeys(sibling->keys.data() + (j - cut - 1), j < i ? keys + j : j == i ? sep : keys + j - 1, 1);
+				}
+				for (size_t j = cut + 1; j <= full + 1; ++j) {
+					sibling->children[j - cut - 1] = j <= i ? children[j] : j == i + 1 ? right : children[j - 1];
+				}
+				typename std::aligned_storage<sizeof(Key), alignof(Key)>::type upBuf;
+				Key *up = reinterpret_cast<Key*>(&upBuf);
+				moveKeys(up, cut < i ? keys + cut : cut == i ? sep : keys + cut - 1, 1);
+				if (i < cut) {
+					moveKeys(keys + i + 1, keys + i, cut - 1 - i);
+					moveKeys(keys + i, sep, 1);
+					memmove(children + i + 2, children + i + 1, (cut - 1 - i) * sizeof(node_base*));
+					children[i + 1] = right;
+					adoptChildren(parent, i + 1, cut + 1);
+				}
+				parent->count = static_cast<unsigned short>(cut);
+				sibling->count = static_cast<unsigned short>(full - cut);
+				adoptChildren(sibling, 0, sibling->count + 1);
+				moveKeys(sep, up, 1);
+				left = parent;
+				right = sibling;
+			}
+		}
+
+		/*
+		** A leaf left less than half full takes its left neighbour's elements
+		** if they fit together, else borrows one from it; the first leaf of a
+		** parent does the same with its right neighbour. Borrowing copies the
+		** new separator, which happens before anything moves.
+		*/
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		typename btree<Key, Mapped, Compare, Alloc, NodeBytes>::iterator btree<Key, Mapped, Compare, Alloc, NodeBytes>::eraseAt(leaf_type *leaf, size_t pos) {
+			destroySlot(leaf, pos);
+			moveSlots(leaf, pos, leaf, pos + 1, leaf->count - pos - 1);
+			--leaf->count;
+			--size_;
+			if (leaf == root_) {
+				if (leaf->count == 0) {
+					freeNode(leaf);
+					resetEmpty();
+					return end();
+				}
+				return normalize<iterator>(leaf, pos);
+			}
+			if (leaf->count >= MIN_LEAF) {
+				return normalize<iterator>(leaf, pos);
+			}
+			node_base *parent = leaf->parent;
+			const size_t idx = leaf->position;
+			if (idx > 0) {
+				leaf_type *left = static_cast<leaf_type*>(childAt(parent, idx - 1));
+				if (left->count + leaf->count <= LEAF_SLOTS) {
+					const size_t offset = left->count;
+					mergeLeaves(left, leaf);
+					return normalize<iterator>(left, offset + pos);
+				}
+				replaceSeparator(parent, idx - 1, left->keys.data()[left->count - 1]);
+				moveSlots(leaf, 1, leaf, 0, leaf->count);
+				moveSlots(leaf, 0, left, left->count - 1, 1);
+				--left->count;
+				++leaf->count;
+				return normalize<iterator>(leaf, pos + 1);
+			}
+			leaf_type *right = static_cast<leaf_type*>(childAt(parent, 1));
+			if (leaf->count + right->count <= LEAF_SLOTS) {
+				mergeLeaves(leaf, right);
+				return normalize<iterator>(leaf, pos);
+			}
+			replaceSeparator(parent, 0, right->keys.data()[1]);
+			moveSlots(leaf, leaf->count, right, 0, 1);
+			moveSlots(right, 0, right, 1, right->count - 1);
+			++leaf->count;
+			--right->count;
+			return normalize<iterator>(leaf, pos);
+		}
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		void btree<Key, Mapped, Compare, Alloc, NodeBytes>::mergeLeaves(leaf_type *left, leaf_type *right) {
+			moveSlots(left, left->count, right, 0, right->count);
+			left->count += right->count;
+			left->next = right->next;
+			if (right->next) {
+				right->next->prev = left;
+			}
+			else {
+				rightmost_ = left;
+			}
+			node_base *parent = right->parent;
+			const size_t k = right->position - 1;
+			keyAllocator alloc(this->get_alloc());
+			keyTraits::destroy(alloc, ikeyAt(parent, k));
+			removeSeparator(parent, k);
+			freeNode(right);
+			fixInternal(parent);
+		}
+		// internal nodes merge around the separator or rotate a key through it; nothing is copied
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		void btree<Key, Mapped, Compare, Alloc, NodeBytes>::fixInternal(node_base *node) {
+			for (;;) {
+				if (node == root_) {
+					if (node->count == 0) {
+						root_ = childAt(node, 0);
+						root_->parent = 0;
+						root_->position = 0;
+						freeNode(node);
+					}
+					return;
+				}
+				if (node->count >= MIN_INTERNAL) return;
+				node_base *parent = node->parent;
+				node_base *left = node->position > 0 ? childAt(parent, node->position - 1) : node;
+				node_base *right = node->position > 0 ? node : childAt(parent, 1);
+				const size_t k = right->position - 1;
+				if (left->count + right->count + 1 <= INTERNAL_SLOTS) {
+					const size_t n = left->count;
+					moveKeys(ikeyAt(left, n), ikeyAt(parent, k), 1);
+					moveKeys(ikeyAt(left, n + 1), ikeyAt(right, 0), right->count);
+					memcpy(&childAt(left, n + 1), &childAt(right, 0), (right->count + 1) * sizeof(node_base*));
+					left->count += right->count + 1;
+					adoptChildren(left, n + 1, left->count + 1);
+					removeSeparator(parent, k);
+					freeNode(right);
+					node = parent;
+					continue;
+				}
+				if (node == right) {
+					moveKeys(ikeyAt(right, 1), ikeyAt(right, 0), right->count);
+					moveKeys(ikeyAt(right, 0), ikeyAt(parent, k), 1);
+					moveKeys(ikeyAt(parent, k), ikeyAt(left, left->count - 1), 1);
+					memmove(&childAt(right, 1), &childAt(right, 0), (right->count + 1) * sizeof(node_base*));
+					childAt(right, 0) = childAt(left, left->count);
+					--left->count;
+					++right->count;
+					adoptChildren(right, 0, right->count + 1);
+				}
+				else {
+					moveKeys(ikeyAt(left, left->count), ikeyAt(parent, k), 1);
+					moveKeys(ikeyAt(parent, k), ikeyAt(right, 0), 1);
+					moveKeys(ikeyAt(right, 0), ikeyAt(right, 1), right->count - 1);
+					childAt(left, left->count + 1) = childAt(right, 0);
+					memmove(&childAt(right, 0), &childAt(right, 1), right->count * sizeof(node_base*));
+					++left->count;
+					--right->count;
+					adoptChildren(left, left->count, left->count + 1);
+					adoptChildren(right, 0, right->count + 1);
+				}
+				return;
+			}
+		}
+		// key k is already gone; child k + 1 goes with it
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		void btree<Key, Mapped, Compare, Alloc, NodeBytes>::removeSeparator(node_base *node, size_t k) {
+			moveKeys(ikeyAt(node, k), ikeyAt(node, k + 1), node->count - k - 1);
+			node_base **children = static_cast<internal_type*>(node)->children;
+			memmove(children + k + 1, children + k + 2, (node->count - k - 1) * sizeof(node_base*));
+			--node->count;
+			adoptChildren(node, k + 1, node->count + 1);
+		}
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		void btree<Key, Mapped, Compare, Alloc, NodeBytes>::replaceSeparator(node_base *node, size_t k, const Key& key) {
+			keyAllocator alloc(this->get_alloc());
+			typename std::aligned_storage<sizeof(Key), alignof(Key)>::type buf;
+			Key *copy = reinterpret_cast<Key*>(&buf);
+			keyTraits::construct(alloc, copy, key);
+			keyTraits::destroy(alloc, ikeyAt(node, k));
+			moveKeys(ikeyAt(node, k), copy, 1);
+		}
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		void btree<Key, Mapped, Compare, Alloc, NodeBytes>::adoptChildren(node_base *node, size_t from, size_t to) {
+			for (size_t c = from; c != to; ++c) {
+				node_base *child = childAt(node, c);
+				child->parent = node;
+				child->position = static_cast<unsigned short>(c);
+			}
+		}
+
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		typename btree<Key, Mapped, Compare, Alloc, NodeBytes>::leaf_type *btree<Key, Mapped, Compare, Alloc, NodeBytes>::newLeaf() {
+			leafAllocator alloc(this->get_alloc());
+			leaf_type *leaf = leafTraits::allocate(alloc, 1);
+			leaf->parent = 0;
+			leaf->position = 0;
+			leaf->count = 0;
+			leaf->leaf = true;
+			leaf->prev = 0;
+			leaf->next = 0;
+			return leaf;
+		}
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		typename btree<Key, Mapped, Compare, Alloc, NodeBytes>::internal_type *btree<Key, Mapped, Compare, Alloc, NodeBytes>::newInternal() {
+			internalAllocator alloc(this->get_alloc());
+			internal_type *node = internalTraits::allocate(alloc, 1);
+			node->parent = 0;
+			node->position = 0;
+			node->count = 0;
+			node->leaf = false;
+			return node;
+		}
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		void btree<Key, Mapped, Compare, Alloc, NodeBytes>::freeNode(node_base *node) {
+			if (node->leaf) {
+				leafAllocator alloc(this->get_alloc());
+				leafTraits::deallocate(alloc, static_cast<leaf_type*>(node), 1);
+			}
+			else {
+				internalAllocator alloc(this->get_alloc());
+				internalTraits::deallocate(alloc, static_cast<internal_type*>(node), 1);
+			}
+		}
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		void btree<Key, Mapped, Compare, Alloc, NodeBytes>::freeTree(node_base *node) {
+			if (node == emptyLeaf()) return;
+			if (node->leaf) {
+				leaf_type *leaf = static_cast<leaf_type*>(node);
+				for (size_t i = 0; i != leaf->count; ++i) {
+					destroySlot(leaf, i);
+				}
+			}
+			else {
+				keyAllocator alloc(this->get_alloc());
+				for (size_t i = 0; i <= node->count; ++i) {
+					freeTree(childAt(node, i));
+				}
+				for (size_t i = 0; i != node->count; ++i) {
+					keyTraits::destroy(alloc, ikeyAt(node, i));
+				}
+			}
+			freeNode(node);
+		}
+		// other's elements in order, each at the end of the last leaf
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		void btree<Key, Mapped, Compare, Alloc, NodeBytes>::appendFrom(const btree& other) {
+			try {
+				for (leaf_type *leaf = other.leftmost_; leaf; leaf = leaf->next) {
+					for (size_t i = 0; i != leaf->count; ++i) {
+						insertSlot(rightmost_, rightmost_->count, copySlot(leaf, i, has_values()));
+					}
+				}
+			}
+			catch (...) {
+				clear();
+				throw;
+			}
+		}
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		void btree<Key, Mapped, Compare, Alloc, NodeBytes>::swapData(btree& other) {
+			tinySTL::swap(root_, other.root_);
+			tinySTL::swap(leftmost_, other.leftmost_);
+			tinySTL::swap(rightmost_, other.rightmost_);
+			tinySTL::swap(size_, other.size_);
+			tinySTL::swap(comp_, other.comp_);
+		}
+
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		void btree<Key, Mapped, Compare, Alloc, NodeBytes>::constructSlot(leaf_type *leaf, size_t i, slot_type&& slot) {
+			keyAllocator alloc(this->get_alloc());
+			keyTraits::construct(alloc, leaf->keys.data() + i, std::move(const_cast<Key&>(keyOf(slot))));
+			constructValue(leaf, i, std::move(slot), has_values());
+		}
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		void btree<Key, Mapped, Compare, Alloc, NodeBytes>::constructValue(leaf_type *leaf, size_t i, slot_type&& slot, std::true_type) {
+			mappedAllocator alloc(this->get_alloc());
+			mappedTraits::construct(alloc, leaf->values.data() + i, std::move(slot.second));
+		}
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		void btree<Key, Mapped, Compare, Alloc, NodeBytes>::destroySlot(leaf_type *leaf, size_t i) {
+			keyAllocator alloc(this->get_alloc());
+			keyTraits::destroy(alloc, leaf->keys.data() + i);
+			destroyValue(leaf, i, has_values());
+		}
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		void btree<Key, Mapped, Compare, Alloc, NodeBytes>::destroyValue(leaf_type *leaf, size_t i, std::true_type) {
+			mappedAllocator alloc(this->get_alloc());
+			mappedTraits::destroy(alloc, leaf->values.data() + i);
+		}
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		void btree<Key, Mapped, Compare, Alloc, NodeBytes>::moveSlots(leaf_type *dst, size_t j, leaf_type *src, size_t i, size_t n) {
+			moveKeys(dst->keys.data() + j, src->keys.data() + i, n);
+			moveValues(dst, j, src, i, n, has_values());
+		}
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		void btree<Key, Mapped, Compare, Alloc, NodeBytes>::moveValues(leaf_type *dst, size_t j, leaf_type *src, size_t i, size_t n, std::true_type) {
+			mappedAllocator alloc(this->get_alloc());
+			relocate<stored_mapped, mappedTraits>(dst->values.data() + j, src->values.data() + i, n, alloc, values_relocatable());
+		}
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		inline void btree<Key, Mapped, Compare, Alloc, NodeBytes>::moveKeys(Key *dst, Key *src, size_t n) {
+			keyAllocator alloc(this->get_alloc());
+			relocate<Key, keyTraits>(dst, src, n, alloc, keys_relocatable());
+		}
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		template<class T, class Traits, class A>
+		inline void btree<Key, Mapped, Compare, Alloc, NodeBytes>::relocate(T *dst, T *src, size_t n, A&, std::true_type) {
+			if (n != 0) memmove(static_cast<void*>(dst), static_cast<const void*>(src), n * sizeof(T));
+		}
+		// one element at a time, in the direction that never overwrites a source not yet moved
+		template<class Key, class Mapped, class Compare, class Alloc, size_t NodeBytes>
+		template<class T, class Traits, class A>
+		void btree<Key, Mapped, Compare, Alloc, NodeBytes>::relocate(T *dst, T *src, size_t n, A& alloc, std::false_type) {
+			if (dst == src || n == 0) return;
+			if (dst < src) {
+				for (size_t i = 0; i != n; ++i) {
+					Traits::construct(alloc, dst + i, std::move(src[i]));
+					Traits::destroy(alloc, src + i);
+				}
+			}
+			else {
+				for (size_t i = n; i-- != 0; ) {
+					Traits::construct(alloc, dst + i, std::move(src[i]));
+					Traits::destroy(alloc, src + i);
+				}
+			}
+		}
+
+		template<class Tree>
+		bool btree_equal(const Tree& t1, const Tree& t2) {
+			if (t1.size() != t2.size()) return false;
+			typename Tree::const_iterator it2 = t2.begin();
+			for (typename Tree::const_iterator it1 = t1.begin(); it1 != t1.end(); ++it1, ++it2) {
+				if (!(*it1 == *it2)) return false;
+			}
+			return true;
+		}
+	}// namespace Detail
+
+	// algorithms run over a btree range leaf by leaf, on the key (and value) arrays
+	template<class Key, class Mapped, size_t N, bool Const>
+	struct segmented_iterator_traits<Detail::btree_iter<Key, Mapped, N, Const> > {
+		typedef std::true_type is_segmented_iterator;
+		typedef Detail::btree_iter<Key, Mapped, N, Const> iterator;
+		typedef Detail::btree_leaf<Key, Mapped, N> leaf_type;
+		typedef Detail::btree_local<Key, Mapped, Const> local_access;
+		typedef Detail::btree_leaf_cursor<leaf_type> segment_iterator;
+		typedef typename local_access::type local_iterator;
+
+		static segment_iterator segment(const iterator& it) { return segment_iterator(it.leaf_); }
+		static local_iterator local(const iterator& it) { return local_access::at(it.leaf_, it.pos_); }
+		static local_iterator begin(segment_iterator seg) { return local_access::at(seg.get(), 0); }
+		static local_iterator end(segment_iterator seg) { return local_access::at(seg.get(), seg.get()->count); }
+		// the end of a leaf is the start of the next one, as for operator++
+		static iterator compose(segment_iterator seg, local_iterator local) {
+			size_t pos = local_access::index(seg.get(), local);
+			if (pos == seg.get()->count && seg.get()->next) {
+				return iterator(seg.get()->next, 0);
+			}
+			return iterator(seg.get(), pos);
+		}
+	};
+
+	// class btree_map
+	// an ordered map in a B+ tree; see Detail::btree for the layout
+	template<class Key, class T, class Compare = less<Key>, class Alloc = allocator<pair<const Key, T> >, size_t NodeBytes = 256>
+	class btree_map : public Detail::btree<Key, T, Compare, Alloc, NodeBytes> {
+		private:
+			typedef Detail::btree<Key, T, Compare, Alloc, NodeBytes> base;
+		public:
+			typedef T mapped_type;
+			typedef typename base::key_type key_type;
+			typedef typename base::iterator iterator;
+		public:
+			using base::base;
+			btree_map() {}
+
+			// builds the value only if key is not there yet
+			template<class... Args>
+			pair<iterator, bool> try_emplace(const key_type& key, Args&&... args) { return this->tryEmplace(key, std::forward<Args>(args)...); }
+			template<class... Args>
+			pair<iterator, bool> try_emplace(key_type&& key, Args&&... args) { return this->tryEmplace(std::move(key), std::forward<Args>(args)...); }
+			mapped_type& operator [](const key_type& key) { return try_emplace(key).first->second; }
+			mapped_type& operator [](key_type&& key) { return try_emplace(std::move(key)).first->second; }
+			mapped_type& at(const key_type& key) {
+				iterator it = this->find(key);
+				if (it == this->end()) throw std::out_of_range("tinySTL::btree_map::at");
+				return it->second;
+			}
+			const mapped_type& at(const key_type& key) const {
+				typename base::const_iterator it = this->find(key);
+				if (it == this->end()) throw std::out_of_range("tinySTL::btree_map::at");
+				return it->second;
+			}
+	};
+
+	// class btree_set
+	template<class Key, class Compare = less<Key>, class Alloc = allocator<Key>, size_t NodeBytes = 256>
+	class btree_set : public Detail::btree<Key, void, Compare, Alloc, NodeBytes> {
+		private:
+			typedef Detail::btree<Key, void, Compare, Alloc, NodeBytes> base;
+		public:
+			using base::base;
+			btree_set() {}
+	};
+
+	template<class Key, class T, class Compare, class Alloc, size_t NodeBytes>
+	bool operator ==(const btree_map<Key, T, Compare, Alloc, NodeBytes>& m1, const btree_map<Key, T, Compare, Alloc, NodeBytes>& m2) {
+		return Detail::btree_equal(m1, m2);
+	}
+	template<class Key, class T, class Compare, class Alloc, size_t NodeBytes>
+	bool operator !=(const btree_map<Key, T, Compare, Alloc, NodeBytes>& m1, const btree_map<Key, T, Compare, Alloc, NodeBytes>& m2) {
+		return !(m1 == m2);
+	}
+	template<class Key, class T, class Compare, class Alloc, size_t NodeBytes>
+	void swap(btree_map<Key, T, Compare, Alloc, NodeBytes>& m1, btree_map<Key, T, Compare, Alloc, NodeBytes>& m2) {
+		m1.swap(m2);
+	}
+	template<class Key, class Compare, class Alloc, size_t NodeBytes>
+	bool operator ==(const btree_set<Key, Compare, Alloc, NodeBytes>& s1, const btree_set<Key, Compare, Alloc, NodeBytes>& s2) {
+		return Detail::btree_equal(s1, s2);
+	}
+	template<class Key, class Compare, class Alloc, size_t NodeBytes>
+	bool operator !=(const btree_set<Key, Compare, Alloc, NodeBytes>& s1, const btree_set<Key, Compare, Alloc, NodeBytes>& s2) {
+		return !(s1 == s2);
+	}
+	template<class Key, class Compare, class Alloc, size_t NodeBytes>
+	void swap(btree_set<Key, Compare, Alloc, NodeBytes>& s1, btree_set<Key, Compare, Alloc, NodeBytes>& s2) {
+		s1.swap(s2);
+	}
+} // namespace tinySTL
+
+#endif // _BTREE_H_
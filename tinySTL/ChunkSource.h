@@ -0,0 +1,180 @@
+#ifndef _CHUNK_SOURCE_H_
+#define _CHUNK_SOURCE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace tinySTL {
+
+	/*
+	** Where basic_alloc gets its chunks from. A chunk source has
+	**   ALIGNMENT                       the alignment of every chunk it returns
+	**   void *allocate(size_t& bytes)   at least bytes, 0 on failure; may round
+	**                                   bytes up, and the whole rounded size is used
+	**   void deallocate(void *p, size_t bytes)   with the rounded size
+	** and is called with the pool's lock held.
+	*/
+	struct malloc_chunk_source {
+		enum EAlignment{ ALIGNMENT = alignof(std::max_align_t) };
+
+		static void *allocate(size_t& bytes) { return malloc(bytes); }
+		static void deallocate(void *p, size_t) { free(p); }
+	};
+
+	enum EChunkFlags{
+		CHUNK_HUGE_TLB = 1,		// reserved huge pages: MAP_HUGETLB, MEM_LARGE_PAGES on Windows
+		CHUNK_HUGE_ADVISE = 2,	// 2 MB aligned chunks with madvise(MADV_HUGEPAGE)
+		CHUNK_POPULATE = 4		// fault the pages in when the chunk is mapped
+	};
+
+	/*
+	** Chunks mapped directly from the OS, for pools whose working set makes TLB
+	** misses the bottleneck. With huge pages requested, chunk sizes are rounded
+	** to whole huge pages. Each step falls back to the next one when the system
+	** refuses: reserved huge pages, then transparent huge pages, then normal
+	** pages. After the first refusal CHUNK_HUGE_TLB is not tried again.
+	** huge_chunks() counts the chunks that got reserved huge pages, so callers
+	** can check what the system actually granted.
+	*/
+	template<unsigned Flags = CHUNK_HUGE_ADVISE>
+	class mmap_chunk_source {
+		public:
+			enum EAlignment{ ALIGNMENT = 4096 };
+			enum EHugePage{ HUGE_PAGE = 2 * 1024 * 1024 };
+		private:
+			static std::atomic<bool> huge_tlb_failed;
+			static std::atomic<size_t> huge_tlb_chunks;
+		private:
+			static size_t ROUND_UP(size_t bytes, size_t align) {
+				return (bytes + align - 1) & ~(align - 1);
+			}
+			static void prefault(char *p, size_t bytes) {
+				for (size_t i = 0; i < bytes; i += EAlignment::ALIGNMENT) {
+					static_cast<volatile char *>(p)[i] = 0;
+				}
+			}
+			static void *map_huge_tlb(size_t& bytes);
+			static void *map_pages(size_t& bytes);
+		public:
+			static void *allocate(size_t& bytes);
+			static void deallocate(void *p, size_t bytes);
+
+			static size_t huge_chunks() { return huge_tlb_chunks.load(std::memory_order_relaxed); }
+	};
+
+	template<unsigned Flags>
+	std::atomic<bool> mmap_chunk_source<Flags>::huge_tlb_failed(false);
+	template<unsigned Flags>
+	std::atomic<size_t> mmap_chunk_source<Flags>::huge_tlb_chunks(0);
+
+	template<unsigned Flags>
+	void *mmap_chunk_source<Flags>::allocate(size_t& bytes) {
+		if ((Flags & CHUNK_HUGE_TLB) && !huge_tlb_failed.load(std::memory_order_relaxed)) {
+			void *p = map_huge_tlb(bytes);
+			if (p) {
+				huge_tlb_chunks.fetch_add(1, std::memory_order_relaxed);
+				return p;
+			}
+			huge_tlb_failed.store(true, std::memory_order_relaxed);
+		}
+		return map_pages(bytes);
+	}
+
+#if defined(_WIN32)
+	template<unsigned Flags>
+	void *mmap_chunk_source<Flags>::map_huge_tlb(size_t& bytes) {
+		// needs SeLockMemoryPrivilege, fails with ERROR_PRIVILEGE_NOT_HELD otherwise
+		size_t large = GetLargePageMinimum();
+		if (large == 0) return 0;
+		size_t len = ROUND_UP(bytes, large);
+		void *p = VirtualAlloc(0, len, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+		if (p) bytes = len;
+		return p;
+	}
+
+	// Windows has no transparent huge pages; CHUNK_HUGE_ADVISE only keeps the rounding
+	template<unsigned Flags>
+	void *mmap_chunk_source<Flags>::map_pages(size_t& bytes) {
+		size_t len = ROUND_UP(bytes, (Flags & (CHUNK_HUGE_TLB | CHUNK_HUGE_ADVISE)) ? size_t(EHugePage::HUGE_PAGE) : size_t(64 * 1024));
+		void *p = VirtualAlloc(0, len, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+		if (p == 0) return 0;
+		if (Flags & CHUNK_POPULATE) prefault(static_cast<char *>(p), len);
+		bytes = len;
+		return p;
+	}
+
+	template<unsigned Flags>
+	void mmap_chunk_source<Flags>::deallocate(void *p, size_t) {
+		VirtualFree(p, 0, MEM_RELEASE);
+	}
+#else
+	template<unsigned Flags>
+	void *mmap_chunk_source<Flags>::map_huge_tlb(size_t& bytes) {
+#if defined(MAP_HUGETLB)
+		size_t len = ROUND_UP(bytes, EHugePage::HUGE_PAGE);
+		int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB;
+#if defined(MAP_POPULATE)
+		if (Flags & CHUNK_POPULATE) flags |= MAP_POPULATE;
+#endif
+		void *p = mmap(0, len, PROT_READ | PROT_WRITE, flags, -1, 0);
+		if (p == MAP_FAILED) return 0;
+		bytes = len;
+		return p;
+#else
+		(void)bytes;
+		return 0;
+#endif
+	}
+
+	template<unsigned Flags>
+	void *mmap_chunk_source<Flags>::map_pages(size_t& bytes) {
+		if (Flags & (CHUNK_HUGE_TLB | CHUNK_HUGE_ADVISE)) {
+			// over-map by a huge page and cut the ends so the kernel can back it with huge pages
+			size_t len = ROUND_UP(bytes, EHugePage::HUGE_PAGE);
+			char *raw = static_cast<char *>(mmap(0, len + EHugePage::HUGE_PAGE, PROT_READ | PROT_WRITE,
+				MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+			if (raw == MAP_FAILED) return 0;
+			char *p = reinterpret_cast<char *>(ROUND_UP(reinterpret_cast<uintptr_t>(raw), EHugePage::HUGE_PAGE));
+			if (p != raw) munmap(raw, p - raw);
+			munmap(p + len, raw + EHugePage::HUGE_PAGE - p);
+#if defined(MADV_HUGEPAGE)
+			madvise(p, len, MADV_HUGEPAGE);	// a kernel without THP just says no
+#endif
+			// MAP_POPULATE would fault small pages in before the advice
+			if (Flags & CHUNK_POPULATE) prefault(p, len);
+			bytes = len;
+			return p;
+		}
+		size_t len = ROUND_UP(bytes, EAlignment::ALIGNMENT);
+		int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#if defined(MAP_POPULATE)
+		if (Flags & CHUNK_POPULATE) flags |= MAP_POPULATE;
+#endif
+		void *p = mmap(0, len, PROT_READ | PROT_WRITE, flags, -1, 0);
+		if (p == MAP_FAILED) return 0;
+#if !defined(MAP_POPULATE)
+		if (Flags & CHUNK_POPULATE) prefault(static_cast<char *>(p), len);
+#endif
+		bytes = len;
+		return p;
+	}
+
+	template<unsigned Flags>
+	void mmap_chunk_source<Flags>::deallocate(void *p, size_t bytes) {
+		munmap(p, bytes);
+	}
+#endif
+} // namespace tinySTL
+
+#endif // _CHUNK_SOURCE_H_
@@ -3,13 +3,14 @@
 
 #include <new>
 
+#include "Iterator.h"
 #include "TypeTraits.h"
 
 namespace tinySTL {
 
 	template<class T1, class T2>
 	inline void construct(T1* ptr, const T2& value) {
-		new (ptr) T1(value);
+		new (static_cast<void*>(ptr)) T1(value);
 	}
 
 	template<class T>
@@ -18,21 +19,57 @@ namespace tinySTL {
 	}
 
 	template<class ForwardIterator>
-	inline void _destroy(ForwardIterator first, ForwardIterator last, _true_type) { }
+	void destroy(ForwardIterator first, ForwardIterator last);
 
+	// what destroy(first, last) dispatches on: the element type's destructor, never the iterator's
 	template<class ForwardIterator>
-	inline void _destroy(ForwardIterator first, ForwardIterator last, _false_type) {
-		for (; first!= last; ++first) {
-			destroy(&*first);
+	struct range_destructor_traits {
+		typedef typename std::remove_cv<typename iterator_traits<ForwardIterator>::value_type>::type value_type;
+		typedef typename _type_traits<value_type>::has_trivial_destructor has_trivial_destructor;
+	};
+
+	/*
+	** The range version asks about the element type, not the iterator: a range
+	** of trivially destructible elements is a no-op whatever iterates over it.
+	** Otherwise segmented ranges (deque) are destroyed segment by segment with
+	** plain pointer loops.
+	*/
+	template<class ForwardIterator>
+	inline void _destroy(ForwardIterator, ForwardIterator, _true_type) { }
+
+	template<class ForwardIterator>
+	inline void _destroy_aux(ForwardIterator first, ForwardIterator last, std::false_type) {
+		for (; first != last; ++first) {
+			tinySTL::destroy(&*first);
 		}
 	}
 
+	template<class SegmentedIterator>
+	void _destroy_aux(SegmentedIterator first, SegmentedIterator last, std::true_type) {
+		typedef segmented_iterator_traits<SegmentedIterator> traits;
+		typename traits::segment_iterator sfirst = traits::segment(first), slast = traits::segment(last);
+		if (sfirst == slast) {
+			tinySTL::destroy(traits::local(first), traits::local(last));
+			return;
+		}
+		tinySTL::destroy(traits::local(first), traits::end(sfirst));
+		for (++sfirst; sfirst != slast; ++sfirst) {
+			tinySTL::destroy(traits::begin(sfirst), traits::end(sfirst));
+		}
+		tinySTL::destroy(traits::begin(slast), traits::local(last));
+	}
+
+	template<class ForwardIterator>
+	inline void _destroy(ForwardIterator first, ForwardIterator last, _false_type) {
+		typedef typename segmented_iterator_traits<ForwardIterator>::is_segmented_iterator segmented;
+		_destroy_aux(first, last, segmented());
+	}
+
 	template<class ForwardIterator>
 	inline void destroy(ForwardIterator first, ForwardIterator last) {
-		typedef typename _type_traits<ForwardIterator>::is_POD_type is_POD_type;
-		_destroy(first, last, is_POD_type());
+		_destroy(first, last, typename range_destructor_traits<ForwardIterator>::has_trivial_destructor());
 	}
 
 }
 
-#endif // CONSTRUCT_H
\ No newline at end of file
+#endif // CONSTRUCT_H
@@ -2,136 +2,1151 @@
 #define _DEQUE_H_
 
 #include "Allocator.h"
+#include "AllocatorTraits.h"
 #include "Iterator.h"
 #include "Utility.h"
 #include "ReverseIterator.h"
+#include "UninitializedFunctions.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+#include <utility>
 
 namespace tinySTL {
     template<class T, class Alloc = allocator<T>>
     class deque;
     namespace Detail {
         // class dq_iter
+        // keeps the bounds of its bucket, so stepping only looks at the map when it leaves the bucket
         template<class T>
-        class dq_iter : public iterator<bidirectional_iterator_tag, T> {
+        class dq_iter : public iterator<random_access_iterator_tag, typename std::remove_const<T>::type, ptrdiff_t, T*, T&> {
         private:
-            template<class T, class Alloc>
+            template<class U, class Alloc>
             friend class ::tinySTL::deque;
+            template<class U>
+            friend class dq_iter;
+            friend struct ::tinySTL::segmented_iterator_traits<dq_iter>;
         public:
-            typedef const ::tinySTL::deque<T>* cntrPtr;
-            size_t mapIndex_;
+            typedef typename std::remove_const<T>::type value_type;
+            typedef ptrdiff_t difference_type;
+            typedef T* pointer;
+            typedef T& reference;
+            typedef value_type** map_pointer;
+            // about BUCK_BYTES per bucket, but never fewer than MIN_BUCK_SIZE elements
+            enum EBuckSize{
+                BUCK_BYTES = 4096,
+                MIN_BUCK_SIZE = 16,
+                BUCK_SIZE = sizeof(value_type) * MIN_BUCK_SIZE < BUCK_BYTES ? BUCK_BYTES / sizeof(value_type) : MIN_BUCK_SIZE
+            };
+        private:
             T* cur_;
-            cntrPtr container_;
+            T* first_;      // first slot of the bucket
+            T* last_;       // one past the last slot of the bucket
+            map_pointer node_;
         public:
-            dq_iter() :mapIndex_(-1), cur_(0), container_(0) {}
-            dq_iter(size_t index, T* ptr, cntrPtr cntr) :mapIndex_(index), cur_(ptr), container_(cntr) {}
-            dq_iter(const dq_iter& it) :mapIndex_(it.mapIndex_), cur_(it.cur_), container_(it.container_) {}
+            dq_iter() :cur_(0), first_(0), last_(0), node_(0) {}
+            dq_iter(T* ptr, map_pointer node) :cur_(ptr), first_(*node), last_(*node + BUCK_SIZE), node_(node) {}
+            // iterator -> const_iterator
+            template<class U, class = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+            dq_iter(const dq_iter<U>& it) :cur_(it.cur_), first_(it.first_), last_(it.last_), node_(it.node_) {}
 
-            dq_iter& operator = (const dq_iter& it);
             void swap(dq_iter& it);
-            reference operator *() { return *cur_; }
-            const reference operator *() const { return *cur_; }
-            pointer operator ->() { return &(operator*()); }
-            const pointer operator ->() const { return &(operator*()); }
+            reference operator *() const { return *cur_; }
+            pointer operator ->() const { return cur_; }
+            reference operator [](difference_type n) const { return *(*this + n); }
             dq_iter& operator ++();
             dq_iter operator ++(int);
             dq_iter& operator --();
-            dq_iter& operator --(int);
-            bool operator ==(const dq_iter& it) const;
-            bool operator !=(const dq_iter& it) const;
+            dq_iter operator --(int);
+            dq_iter& operator +=(difference_type n);
+            dq_iter& operator -=(difference_type n) { return *this += -n; }
         private:
-            T* getBuckHead(size_t mapIndex) const;
-            T* getBuckTail(size_t mapIndex) const;
-            size_t getBuckSize() const;
+            void setNode(map_pointer node) {
+                node_ = node;
+                first_ = *node;
+                last_ = first_ + BUCK_SIZE;
+            }
         public:
-            template<class T>
-            friend dq_iter<T> operator +(const dq_iter<T>& it, typename dq_iter<T>::difference_type n);
-            template<class T>
-            friend dq_iter<T> operator -(const dq_iter<T>& it, typename dq_iter<T>::difference_type n);
-            template<class T>
-            friend dq_iter<T> operator +(typename dq_iter<T>::difference_type n, const dq_iter<T>& it);
-            template<class T>
-            friend dq_iter<T> operator -(typename dq_iter<T>::difference_type n, const dq_iter<T>& it);
-            template<class T>
-            friend typename dq_iter<T>::difference_type operator -(const dq_iter<T>& it1, const dq_iter<T>& it2);
-            template<class T>
-            friend void swap(dq_iter<T>& it1, dq_iter<T>& it2);
+            friend dq_iter operator +(dq_iter it, difference_type n) { return it += n; }
+            friend dq_iter operator +(difference_type n, dq_iter it) { return it += n; }
+            friend dq_iter operator -(dq_iter it, difference_type n) { return it -= n; }
+            friend difference_type operator -(const dq_iter& it1, const dq_iter& it2) {
+                return difference_type(BUCK_SIZE) * (it1.node_ - it2.node_) + (it1.cur_ - it1.first_) - (it2.cur_ - it2.first_);
+            }
+            friend bool operator ==(const dq_iter& it1, const dq_iter& it2) { return it1.cur_ == it2.cur_; }
+            friend bool operator !=(const dq_iter& it1, const dq_iter& it2) { return it1.cur_ != it2.cur_; }
+            friend bool operator <(const dq_iter& it1, const dq_iter& it2) {
+                return it1.node_ == it2.node_ ? it1.cur_ < it2.cur_ : it1.node_ < it2.node_;
+            }
+            friend bool operator >(const dq_iter& it1, const dq_iter& it2) { return it2 < it1; }
+            friend bool operator <=(const dq_iter& it1, const dq_iter& it2) { return !(it2 < it1); }
+            friend bool operator >=(const dq_iter& it1, const dq_iter& it2) { return !(it1 < it2); }
+            friend void swap(dq_iter& it1, dq_iter& it2) { it1.swap(it2); }
         };
+
+        template<class T>
+        void dq_iter<T>::swap(dq_iter& it) {
+            tinySTL::swap(cur_, it.cur_);
+            tinySTL::swap(first_, it.first_);
+            tinySTL::swap(last_, it.last_);
+            tinySTL::swap(node_, it.node_);
+        }
+        template<class T>
+        inline dq_iter<T>& dq_iter<T>::operator ++() {
+            if (++cur_ == last_) {
+                setNode(node_ + 1);
+                cur_ = first_;
+            }
+            return *this;
+        }
+        template<class T>
+        inline dq_iter<T> dq_iter<T>::operator ++(int) {
+            dq_iter temp = *this;
+            ++*this;
+            return temp;
+        }
+        template<class T>
+        inline dq_iter<T>& dq_iter<T>::operator --() {
+            if (cur_ == first_) {
+                setNode(node_ - 1);
+                cur_ = last_;
+            }
+            --cur_;
+            return *this;
+        }
+        template<class T>
+        inline dq_iter<T> dq_iter<T>::operator --(int) {
+            dq_iter temp = *this;
+            --*this;
+            return temp;
+        }
+        template<class T>
+        inline dq_iter<T>& dq_iter<T>::operator +=(difference_type n) {
+            difference_type offset = n + (cur_ - first_);
+            if (offset >= 0 && offset < difference_type(BUCK_SIZE)) {
+                cur_ += n;
+            }
+            else {
+                difference_type nodeOffset = offset > 0 ? offset / difference_type(BUCK_SIZE)
+                    : -difference_type((-offset - 1) / BUCK_SIZE) - 1;
+                setNode(node_ + nodeOffset);
+                cur_ = first_ + (offset - nodeOffset * difference_type(BUCK_SIZE));
+            }
+            return *this;
+        }
     }// namespace Detail
 
+    // a deque range is walked bucket by bucket; segments are map nodes
+    template<class T>
+    struct segmented_iterator_traits<Detail::dq_iter<T>> {
+        typedef std::true_type is_segmented_iterator;
+        typedef Detail::dq_iter<T> iterator;
+        typedef typename iterator::map_pointer segment_iterator;
+        typedef T* local_iterator;
+
+        static segment_iterator segment(const iterator& it) { return it.node_; }
+        static local_iterator local(const iterator& it) { return it.cur_; }
+        static local_iterator begin(segment_iterator seg) { return *seg; }
+        static local_iterator end(segment_iterator seg) { return *seg + iterator::BUCK_SIZE; }
+        // the end of a bucket is the start of the next one, as for operator++
+        static iterator compose(segment_iterator seg, local_iterator local) {
+            if (local == end(seg)) {
+                ++seg;
+                local = begin(seg);
+            }
+            return iterator(local, seg);
+        }
+    };
+
     // class deque
+    // holds its allocator through alloc_holder, so a stateless Alloc costs no space
+    // map_[0, mapSize_) points at the buckets; [beg_.node_, end_.node_] are allocated,
+    // and end_.cur_ always has a slot, so end() never sits past its bucket
     template<class T, class Alloc>
-    class deque {
+    class deque : private Detail::alloc_holder<Alloc> {
     private:
-        template<class T>
-        friend class ::tinySTL::Detail::dq_iter:
+        template<class U>
+        friend class ::tinySTL::Detail::dq_iter;
     public:
         typedef T value_type;
         typedef Detail::dq_iter<T> iterator;
         typedef Detail::dq_iter<const T> const_iterator;
+        typedef reverse_iterator_t<iterator> reverse_iterator;
+        typedef reverse_iterator_t<const_iterator> const_reverse_iterator;
         typedef T& reference;
+        typedef const T& const_reference;
+        typedef T* pointer;
+        typedef const T* const_pointer;
         typedef size_t size_type;
         typedef ptrdiff_t difference_type;
         typedef Alloc allocator_type;
     private:
         typedef Alloc dataAlloctor;
-        enum class EBuckSize { BUCK_SIZE = 64 };
+        typedef allocator_traits<dataAlloctor> dataTraits;
+        typedef typename dataTraits::template rebind_alloc<T*> mapAllocator;
+        typedef allocator_traits<mapAllocator> mapTraits;
+        typedef Detail::alloc_holder<Alloc> holder;
+        enum EBuckSize{ BUCK_SIZE = iterator::BUCK_SIZE };
+        enum EMapSize{ MIN_MAP_SIZE = 8 };
+        enum ESpare{ MAX_SPARE_BUCKS = 2 };
     private:
         iterator beg_, end_;
         size_t mapSize_;
         T **map_;
+        T *spare_;          // freed buckets kept for reuse, linked through their first word
+        size_t spareCount_;
     public:
         deque();
-        explicit deque(size_type n, const value_type& value = value_type());
+        explicit deque(const allocator_type& alloc);
+        explicit deque(size_type n, const value_type& value = value_type(), const allocator_type& alloc = allocator_type());
         template<class InputIterator>
-        deque(InputIterator first, InputIterator last);
+        deque(InputIterator first, InputIterator last, const allocator_type& alloc = allocator_type());
         deque(const deque& other);
+        deque(const deque& other, const allocator_type& alloc);
+        deque(deque&& other);
+        deque(deque&& other, const allocator_type& alloc);
 
         ~deque();
 
         deque& operator = (const deque& other);
         deque& operator = (deque&& other);
-    
-        iterator begin();
-        iterator begin() const;
-        iterator end();
-        iterator end() const;
+
+        iterator begin() { return beg_; }
+        const_iterator begin() const { return beg_; }
+        iterator end() { return end_; }
+        const_iterator end() const { return end_; }
+        const_iterator cbegin() const { return beg_; }
+        const_iterator cend() const { return end_; }
+        reverse_iterator rbegin() { return reverse_iterator(end_); }
+        const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+        reverse_iterator rend() { return reverse_iterator(beg_); }
+        const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+        allocator_type get_allocator() const { return this->get_alloc(); }
     public:
-        size_type size() const { return end() - begin(); }
-        bool empty() const { return size() == 0; }
+        size_type size() const { return end_ - beg_; }
+        bool empty() const { return beg_ == end_; }
 
         reference operator[] (size_type n);
         const_reference operator[] (size_type n) const;
-        reference front();
-        const_reference front() const;
+        reference front() { return *beg_.cur_; }
+        const_reference front() const { return *beg_.cur_; }
         reference back();
         const_reference back() const;
 
-        void push_front(const value_type& value);
-        void push_back(const value_type& value);
+        void push_front(const value_type& value) { emplace_front(value); }
+        void push_front(value_type&& value) { emplace_front(std::move(value)); }
+        void push_back(const value_type& value) { emplace_back(value); }
+        void push_back(value_type&& value) { emplace_back(std::move(value)); }
+        template<class... Args>
+        void emplace_front(Args&&... args);
+        template<class... Args>
+        void emplace_back(Args&&... args);
+        template<class... Args>
+        iterator emplace(const_iterator pos, Args&&... args);
         void pop_front();
         void pop_back();
         void swap(deque& other);
         void clear();
+        void shrink_to_fit();
+        void reserve_front(size_type n);
+        void reserve_back(size_type n);
+
+        iterator insert(const_iterator pos, const value_type& value) { return emplace(pos, value); }
+        iterator insert(const_iterator pos, value_type&& value) { return emplace(pos, std::move(value)); }
+        iterator insert(const_iterator pos, size_type n, const value_type& value);
+        template<class InputIterator>
+        iterator insert(const_iterator pos, InputIterator first, InputIterator last);
+        iterator erase(const_iterator pos);
+        iterator erase(const_iterator first, const_iterator last);
+        void resize(size_type n, const value_type& value = value_type());
+        void assign(size_type n, const value_type& value);
+        template<class InputIterator>
+        void assign(InputIterator first, InputIterator last);
     private:
-        T* getnNewBuck();
+        T* getNewBuck();
+        void putBuck(T* buck);
+        void freeBuck(T* buck);
+        void pushSpare(T* buck);
+        void releaseSpares();
         T** getNewMap(const size_t size);
-        size_t getNewMapSize(const size_t size);
-        size_t getBuckSize() const;
-        void init();
-        bool back_full() const;
-        bool front_full() const;
+        void putMap(T** map, const size_t size);
+        size_t getNewMapSize(const size_t size) const;
+        void init(size_t n);
+        void destroyAndFree();
+        void destroyRange(iterator first, iterator last);
+        void fillInit(const value_type& value);
         void deque_aux(size_t n, const value_type& value, std::true_type);
         template<class InputIterator>
         void deque_aux(InputIterator first, InputIterator last, std::false_type);
-        void reallocateAndCopy();
+        template<class InputIterator>
+        void range_init(InputIterator first, InputIterator last, input_iterator_tag);
+        template<class ForwardIterator>
+        void range_init(ForwardIterator first, ForwardIterator last, forward_iterator_tag);
+        template<class InputIterator>
+        iterator uninitCopy(InputIterator first, InputIterator last, iterator result);
+        void uninitFill(iterator first, iterator last, const value_type& value);
+        void putBucks(T** first, T** last);
+        iterator reserveElementsAtBack(size_t n);
+        iterator reserveElementsAtFront(size_t n);
+        iterator mutablePos(const_iterator pos);
+        iterator fill_insert(iterator pos, size_t n, const value_type& value);
+        void insert_aux(iterator pos, size_t n, const value_type& value, std::true_type);
+        template<class InputIterator>
+        void insert_aux(iterator pos, InputIterator first, InputIterator last, std::false_type);
+        template<class InputIterator>
+        void range_insert(iterator pos, InputIterator first, InputIterator last, input_iterator_tag);
+        template<class ForwardIterator>
+        void range_insert(iterator pos, ForwardIterator first, ForwardIterator last, forward_iterator_tag);
+        void assign_aux(size_t n, const value_type& value, std::true_type);
+        template<class InputIterator>
+        void assign_aux(InputIterator first, InputIterator last, std::false_type);
+        template<class InputIterator>
+        void assign_range(InputIterator first, InputIterator last, input_iterator_tag);
+        template<class ForwardIterator>
+        void assign_range(ForwardIterator first, ForwardIterator last, forward_iterator_tag);
+        void swapData(deque& other);
+        void reserveMapAtBack(size_t nodesToAdd = 1);
+        void reserveMapAtFront(size_t nodesToAdd = 1);
+        void reallocateMap(size_t nodesToAdd, bool addAtFront);
+        template<class... Args>
+        void emplace_back_aux(Args&&... args);
+        template<class... Args>
+        void emplace_front_aux(Args&&... args);
     public:
-        template<class T, class Alloc>
-        friend bool operator ==(const deque<T, Alloc>& d1, const deque<T, Alloc>& d2);
-        template<class T, class Alloc>
-        friend bool operator !=(const deque<T, Alloc>& d1, const deque<T, Alloc>& d2);
-        template<class T, class Alloc>
-        friend void swap(deque<T, Alloc>& d1, deque<T, Alloc>& d2);
+        template<class U, class A>
+        friend bool operator ==(const deque<U, A>& d1, const deque<U, A>& d2);
+        template<class U, class A>
+        friend bool operator !=(const deque<U, A>& d1, const deque<U, A>& d2);
+        template<class U, class A>
+        friend void swap(deque<U, A>& d1, deque<U, A>& d2);
     };// class deque
+
+    template<class T, class Alloc>
+    deque<T, Alloc>::deque() :holder(), mapSize_(0), map_(0), spare_(0), spareCount_(0) {
+        init(0);
+    }
+    template<class T, class Alloc>
+    deque<T, Alloc>::deque(const allocator_type& alloc) :holder(alloc), mapSize_(0), map_(0), spare_(0), spareCount_(0) {
+        init(0);
+    }
+    template<class T, class Alloc>
+    deque<T, Alloc>::deque(size_type n, const value_type& value, const allocator_type& alloc)
+        :holder(alloc), mapSize_(0), map_(0), spare_(0), spareCount_(0) {
+        deque_aux(n, value, std::true_type());
+    }
+    template<class T, class Alloc>
+    template<class InputIterator>
+    deque<T, Alloc>::deque(InputIterator first, InputIterator last, const allocator_type& alloc)
+        :holder(alloc), mapSize_(0), map_(0), spare_(0), spareCount_(0) {
+        deque_aux(first, last, typename std::is_integral<InputIterator>::type());
+    }
+    template<class T, class Alloc>
+    deque<T, Alloc>::deque(const deque& other)
+        :holder(dataTraits::select_on_container_copy_construction(other.get_alloc())), mapSize_(0), map_(0), spare_(0), spareCount_(0) {
+        deque_aux(other.begin(), other.end(), std::false_type());
+    }
+    template<class T, class Alloc>
+    deque<T, Alloc>::deque(const deque& other, const allocator_type& alloc)
+        :holder(alloc), mapSize_(0), map_(0), spare_(0), spareCount_(0) {
+        deque_aux(other.begin(), other.end(), std::false_type());
+    }
+
+    // the source keeps a valid, empty deque: it gets the fresh map built here
+    template<class T, class Alloc>
+    deque<T, Alloc>::deque(deque&& other) :holder(other.get_alloc()), mapSize_(0), map_(0), spare_(0), spareCount_(0) {
+        init(0);
+        swapData(other);
+    }
+    template<class T, class Alloc>
+    deque<T, Alloc>::deque(deque&& other, const allocator_type& alloc) :holder(alloc), mapSize_(0), map_(0), spare_(0), spareCount_(0) {
+        if (dataTraits::is_always_equal::value || this->get_alloc() == other.get_alloc()) {
+            init(0);
+            swapData(other);
+        }
+        else {
+            deque_aux(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()), std::false_type());
+        }
+    }
+
+    template<class T, class Alloc>
+    deque<T, Alloc>::~deque() {
+        destroyAndFree();
+    }
+
+    template<class T, class Alloc>
+    deque<T, Alloc>& deque<T, Alloc>::operator = (const deque& other) {
+        if (this != &other) {
+            // build the copy with the allocator this deque will end up with
+            const bool propagate = dataTraits::propagate_on_container_copy_assignment::value;
+            deque temp(other, propagate ? other.get_alloc() : this->get_alloc());
+            swapData(temp);
+            if (propagate) {
+                tinySTL::swap(this->get_alloc(), temp.get_alloc());
+            }
+        }
+        return *this;
+    }
+    template<class T, class Alloc>
+    deque<T, Alloc>& deque<T, Alloc>::operator = (deque&& other) {
+        if (this == &other) return *this;
+        if (dataTraits::propagate_on_container_move_assignment::value
+            || dataTraits::is_always_equal::value || this->get_alloc() == other.get_alloc()) {
+            // take other's buckets; other gets ours and frees them with its own allocator
+            swapData(other);
+            if (dataTraits::propagate_on_container_move_assignment::value) {
+                tinySTL::swap(this->get_alloc(), other.get_alloc());
+            }
+            other.clear();
+        }
+        else {
+            // the buckets belong to another allocator: move the elements instead
+            deque temp(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()), this->get_alloc());
+            swapData(temp);
+        }
+        return *this;
+    }
+
+    template<class T, class Alloc>
+    inline typename deque<T, Alloc>::reference deque<T, Alloc>::operator[] (size_type n) {
+        size_t offset = n + (beg_.cur_ - beg_.first_);
+        return beg_.node_[offset / BUCK_SIZE][offset % BUCK_SIZE];
+    }
+    template<class T, class Alloc>
+    inline typename deque<T, Alloc>::const_reference deque<T, Alloc>::operator[] (size_type n) const {
+        size_t offset = n + (beg_.cur_ - beg_.first_);
+        return beg_.node_[offset / BUCK_SIZE][offset % BUCK_SIZE];
+    }
+    template<class T, class Alloc>
+    inline typename deque<T, Alloc>::reference deque<T, Alloc>::back() {
+        return end_.cur_ != end_.first_ ? end_.cur_[-1] : end_.node_[-1][BUCK_SIZE - 1];
+    }
+    template<class T, class Alloc>
+    inline typename deque<T, Alloc>::const_reference deque<T, Alloc>::back() const {
+        return end_.cur_ != end_.first_ ? end_.cur_[-1] : end_.node_[-1][BUCK_SIZE - 1];
+    }
+
+    template<class T, class Alloc>
+    template<class... Args>
+    inline void deque<T, Alloc>::emplace_back(Args&&... args) {
+        if (end_.cur_ != end_.last_ - 1) {
+            dataTraits::construct(this->get_alloc(), end_.cur_, std::forward<Args>(args)...);
+            ++end_.cur_;
+        }
+        else {
+            emplace_back_aux(std::forward<Args>(args)...);
+        }
+    }
+    template<class T, class Alloc>
+    template<class... Args>
+    inline void deque<T, Alloc>::emplace_front(Args&&... args) {
+        if (beg_.cur_ != beg_.first_) {
+            dataTraits::construct(this->get_alloc(), beg_.cur_ - 1, std::forward<Args>(args)...);
+            --beg_.cur_;
+        }
+        else {
+            emplace_front_aux(std::forward<Args>(args)...);
+        }
+    }
+    // in the middle: grow the shorter side by one and shift that side towards it with moves
+    template<class T, class Alloc>
+    template<class... Args>
+    typename deque<T, Alloc>::iterator deque<T, Alloc>::emplace(const_iterator pos, Args&&... args) {
+        if (pos.cur_ == beg_.cur_) {
+            emplace_front(std::forward<Args>(args)...);
+            return beg_;
+        }
+        if (pos.cur_ == end_.cur_) {
+            emplace_back(std::forward<Args>(args)...);
+            return end_ - 1;
+        }
+        value_type temp(std::forward<Args>(args)...);    // args may refer into this deque
+        difference_type index = pos - cbegin();
+        if (size_t(index) < size() / 2) {
+            emplace_front(std::move(front()));
+            std::move(beg_ + 2, beg_ + (index + 1), beg_ + 1);
+        }
+        else {
+            emplace_back(std::move(back()));
+            std::move_backward(beg_ + index, end_ - 2, end_ - 1);
+        }
+        iterator result = beg_ + index;
+        *result = std::move(temp);
+        return result;
+    }
+    template<class T, class Alloc>
+    inline void deque<T, Alloc>::pop_back() {
+        if (end_.cur_ == end_.first_) {
+            // the last bucket held no element: give it back and step into the previous one
+            putBuck(end_.first_);
+            end_.setNode(end_.node_ - 1);
+            end_.cur_ = end_.last_;
+        }
+        --end_.cur_;
+        dataTraits::destroy(this->get_alloc(), end_.cur_);
+    }
+    template<class T, class Alloc>
+    inline void deque<T, Alloc>::pop_front() {
+        dataTraits::destroy(this->get_alloc(), beg_.cur_);
+        if (beg_.cur_ != beg_.last_ - 1) {
+            ++beg_.cur_;
+        }
+        else {
+            putBuck(beg_.first_);
+            beg_.setNode(beg_.node_ + 1);
+            beg_.cur_ = beg_.first_;
+        }
+    }
+
+    template<class T, class Alloc>
+    void deque<T, Alloc>::swap(deque& other) {
+        swapData(other);
+        if (dataTraits::propagate_on_container_swap::value) {
+            tinySTL::swap(this->get_alloc(), other.get_alloc());
+        }
+    }
+    // keeps the bucket of beg_ and frees every other one
+    template<class T, class Alloc>
+    void deque<T, Alloc>::clear() {
+        destroyRange(beg_, end_);
+        for (T** node = beg_.node_ + 1; node <= end_.node_; ++node) {
+            putBuck(*node);
+        }
+        end_ = beg_;
+    }
+
+    // buckets come from the spare list first, so a sliding queue stops allocating
+    // give back the spare buckets and move the nodes to a map just big enough for them
+    template<class T, class Alloc>
+    void deque<T, Alloc>::shrink_to_fit() {
+        releaseSpares();
+        size_t nodes = end_.node_ - beg_.node_ + 1;
+        size_t newMapSize = getNewMapSize(nodes);
+        if (newMapSize >= mapSize_) return;
+        T** newMap = getNewMap(newMapSize);
+        T** newStart = newMap + (newMapSize - nodes) / 2;
+        memcpy(newStart, beg_.node_, nodes * sizeof(T*));
+        putMap(map_, mapSize_);
+        map_ = newMap;
+        mapSize_ = newMapSize;
+        beg_.setNode(newStart);
+        end_.setNode(newStart + nodes - 1);
+    }
+    // make room for n push_front/push_back calls without allocating: map slots and spare buckets
+    template<class T, class Alloc>
+    void deque<T, Alloc>::reserve_front(size_type n) {
+        size_t vacancies = beg_.cur_ - beg_.first_;
+        if (n <= vacancies) return;
+        size_t nodes = (n - vacancies + BUCK_SIZE - 1) / BUCK_SIZE;
+        reserveMapAtFront(nodes);
+        while (spareCount_ < nodes) {
+            pushSpare(dataTraits::allocate(this->get_alloc(), BUCK_SIZE));
+        }
+    }
+    template<class T, class Alloc>
+    void deque<T, Alloc>::reserve_back(size_type n) {
+        size_t vacancies = (end_.last_ - end_.cur_) - 1;
+        if (n <= vacancies) return;
+        size_t nodes = (n - vacancies + BUCK_SIZE - 1) / BUCK_SIZE;
+        reserveMapAtBack(nodes);
+        while (spareCount_ < nodes) {
+            pushSpare(dataTraits::allocate(this->get_alloc(), BUCK_SIZE));
+        }
+    }
+
+    template<class T, class Alloc>
+    T* deque<T, Alloc>::getNewBuck() {
+        if (spare_ != 0) {
+            T* buck = spare_;
+            memcpy(&spare_, buck, sizeof(T*));
+            --spareCount_;
+            return buck;
+        }
+        return dataTraits::allocate(this->get_alloc(), BUCK_SIZE);
+    }
+    template<class T, class Alloc>
+    void deque<T, Alloc>::putBuck(T* buck) {
+        if (spareCount_ < MAX_SPARE_BUCKS) {
+            pushSpare(buck);
+        }
+        else {
+            freeBuck(buck);
+        }
+    }
+    template<class T, class Alloc>
+    void deque<T, Alloc>::freeBuck(T* buck) {
+        dataTraits::deallocate(this->get_alloc(), buck, BUCK_SIZE);
+    }
+    // buckets may be only alignof(T) aligned, hence memcpy for the link
+    template<class T, class Alloc>
+    void deque<T, Alloc>::pushSpare(T* buck) {
+        memcpy(static_cast<void*>(buck), &spare_, sizeof(T*));
+        spare_ = buck;
+        ++spareCount_;
+    }
+    template<class T, class Alloc>
+    void deque<T, Alloc>::releaseSpares() {
+        while (spare_ != 0) {
+            freeBuck(getNewBuck());
+        }
+    }
+    template<class T, class Alloc>
+    T** deque<T, Alloc>::getNewMap(const size_t size) {
+        mapAllocator alloc(this->get_alloc());
+        return mapTraits::allocate(alloc, size);
+    }
+    template<class T, class Alloc>
+    void deque<T, Alloc>::putMap(T** map, const size_t size) {
+        mapAllocator alloc(this->get_alloc());
+        mapTraits::deallocate(alloc, map, size);
+    }
+    template<class T, class Alloc>
+    size_t deque<T, Alloc>::getNewMapSize(const size_t size) const {
+        return size + 2 > size_t(MIN_MAP_SIZE) ? size + 2 : size_t(MIN_MAP_SIZE);
+    }
+
+    // a map with room for n elements, buckets centred so both ends can grow
+    template<class T, class Alloc>
+    void deque<T, Alloc>::init(size_t n) {
+        size_t nodes = n / BUCK_SIZE + 1;
+        mapSize_ = getNewMapSize(nodes);
+        map_ = getNewMap(mapSize_);
+        T** start = map_ + (mapSize_ - nodes) / 2;
+        T** finish = start + nodes;
+        T** cur = start;
+        try {
+            for (; cur != finish; ++cur) {
+                *cur = getNewBuck();
+            }
+        }
+        catch (...) {
+            while (cur != start) freeBuck(*--cur);
+            releaseSpares();
+            putMap(map_, mapSize_);
+            map_ = 0;
+            throw;
+        }
+        beg_.setNode(start);
+        beg_.cur_ = beg_.first_;
+        end_.setNode(finish - 1);
+        end_.cur_ = end_.first_ + n % BUCK_SIZE;
+    }
+    template<class T, class Alloc>
+    void deque<T, Alloc>::destroyAndFree() {
+        if (map_ == 0) return;
+        destroyRange(beg_, end_);
+        for (T** node = beg_.node_; node <= end_.node_; ++node) {
+            freeBuck(*node);
+        }
+        releaseSpares();
+        putMap(map_, mapSize_);
+        map_ = 0;
+    }
+    // destroys bucket by bucket; nothing to do for trivially destructible T
+    template<class T, class Alloc>
+    void deque<T, Alloc>::destroyRange(iterator first, iterator last) {
+        if (std::is_trivially_destructible<T>::value) return;
+        dataAlloctor& alloc = this->get_alloc();
+        for (; first.node_ != last.node_; first.setNode(first.node_ + 1), first.cur_ = first.first_) {
+            for (T* p = first.cur_; p != first.last_; ++p) {
+                dataTraits::destroy(alloc, p);
+            }
+        }
+        for (T* p = first.cur_; p != last.cur_; ++p) {
+            dataTraits::destroy(alloc, p);
+        }
+    }
+    // construct [beg_, end_) of a freshly initialised map with copies of value
+    template<class T, class Alloc>
+    void deque<T, Alloc>::fillInit(const value_type& value) {
+        try {
+            uninitialized_fill_a(beg_, end_, value, this->get_alloc());
+        }
+        catch (...) {
+            end_ = beg_;
+            destroyAndFree();
+            throw;
+        }
+    }
+    template<class T, class Alloc>
+    void deque<T, Alloc>::deque_aux(size_t n, const value_type& value, std::true_type) {
+        init(n);
+        fillInit(value);
+    }
+    template<class T, class Alloc>
+    template<class InputIterator>
+    void deque<T, Alloc>::deque_aux(InputIterator first, InputIterator last, std::false_type) {
+        range_init(first, last, typename iterator_traits<InputIterator>::iterator_category());
+    }
+    template<class T, class Alloc>
+    template<class InputIterator>
+    void deque<T, Alloc>::range_init(InputIterator first, InputIterator last, input_iterator_tag) {
+        init(0);
+        try {
+            for (; first != last; ++first) {
+                push_back(*first);
+            }
+        }
+        catch (...) {
+            destroyAndFree();
+            throw;
+        }
+    }
+    template<class T, class Alloc>
+    template<class ForwardIterator>
+    void deque<T, Alloc>::range_init(ForwardIterator first, ForwardIterator last, forward_iterator_tag) {
+        init(tinySTL::distance(first, last));
+        try {
+            uninitCopy(first, last, beg_);
+        }
+        catch (...) {
+            end_ = beg_;
+            destroyAndFree();
+            throw;
+        }
+    }
+
+    // copy-construct [first, last) into raw slots at result; on failure nothing is left constructed
+    template<class T, class Alloc>
+    template<class InputIterator>
+    typename deque<T, Alloc>::iterator deque<T, Alloc>::uninitCopy(InputIterator first, InputIterator last, iterator result) {
+        return uninitialized_copy_a(first, last, result, this->get_alloc());
+    }
+    template<class T, class Alloc>
+    void deque<T, Alloc>::uninitFill(iterator first, iterator last, const value_type& value) {
+        uninitialized_fill_a(first, last, value, this->get_alloc());
+    }
+    template<class T, class Alloc>
+    void deque<T, Alloc>::putBucks(T** first, T** last) {
+        for (; first < last; ++first) {
+            putBuck(*first);
+        }
+    }
+    template<class T, class Alloc>
+    void deque<T, Alloc>::swapData(deque& other) {
+        beg_.swap(other.beg_);
+        end_.swap(other.end_);
+        tinySTL::swap(mapSize_, other.mapSize_);
+        tinySTL::swap(map_, other.map_);
+        tinySTL::swap(spare_, other.spare_);
+        tinySTL::swap(spareCount_, other.spareCount_);
+    }
+
+    template<class T, class Alloc>
+    void deque<T, Alloc>::reserveMapAtBack(size_t nodesToAdd) {
+        if (nodesToAdd + 1 > mapSize_ - (end_.node_ - map_)) {
+            reallocateMap(nodesToAdd, false);
+        }
+    }
+    template<class T, class Alloc>
+    void deque<T, Alloc>::reserveMapAtFront(size_t nodesToAdd) {
+        if (nodesToAdd > size_t(beg_.node_ - map_)) {
+            reallocateMap(nodesToAdd, true);
+        }
+    }
+    // recentre the nodes in the map, or move them to a bigger one if it is over half full
+    template<class T, class Alloc>
+    void deque<T, Alloc>::reallocateMap(size_t nodesToAdd, bool addAtFront) {
+        size_t oldNodes = end_.node_ - beg_.node_ + 1;
+        size_t newNodes = oldNodes + nodesToAdd;
+        T** newStart;
+        if (mapSize_ > 2 * newNodes) {
+            newStart = map_ + (mapSize_ - newNodes) / 2 + (addAtFront ? nodesToAdd : 0);
+            memmove(newStart, beg_.node_, oldNodes * sizeof(T*));
+        }
+        else {
+            size_t newMapSize = mapSize_ + (mapSize_ > nodesToAdd ? mapSize_ : nodesToAdd) + 2;
+            T** newMap = getNewMap(newMapSize);
+            newStart = newMap + (newMapSize - newNodes) / 2 + (addAtFront ? nodesToAdd : 0);
+            memcpy(newStart, beg_.node_, oldNodes * sizeof(T*));
+            putMap(map_, mapSize_);
+            map_ = newMap;
+            mapSize_ = newMapSize;
+        }
+        beg_.setNode(newStart);
+        end_.setNode(newStart + oldNodes - 1);
+    }
+    // the last slot of the last bucket is about to be used: chain a new bucket first.
+    // Growing the map only copies bucket pointers, so args may still refer into the deque.
+    template<class T, class Alloc>
+    template<class... Args>
+    void deque<T, Alloc>::emplace_back_aux(Args&&... args) {
+        reserveMapAtBack();
+        end_.node_[1] = getNewBuck();
+        try {
+            dataTraits::construct(this->get_alloc(), end_.cur_, std::forward<Args>(args)...);
+        }
+        catch (...) {
+            putBuck(end_.node_[1]);
+            throw;
+        }
+        end_.setNode(end_.node_ + 1);
+        end_.cur_ = end_.first_;
+    }
+    template<class T, class Alloc>
+    template<class... Args>
+    void deque<T, Alloc>::emplace_front_aux(Args&&... args) {
+        reserveMapAtFront();
+        beg_.node_[-1] = getNewBuck();
+        try {
+            dataTraits::construct(this->get_alloc(), beg_.node_[-1] + (BUCK_SIZE - 1), std::forward<Args>(args)...);
+        }
+        catch (...) {
+            putBuck(beg_.node_[-1]);
+            throw;
+        }
+        beg_.setNode(beg_.node_ - 1);
+        beg_.cur_ = beg_.last_ - 1;
+    }
+
+    // allocate whole buckets so that n more elements fit behind end_; returns end_ + n
+    template<class T, class Alloc>
+    typename deque<T, Alloc>::iterator deque<T, Alloc>::reserveElementsAtBack(size_t n) {
+        size_t vacancies = (end_.last_ - end_.cur_) - 1;
+        if (n > vacancies) {
+            size_t newNodes = (n - vacancies + BUCK_SIZE - 1) / BUCK_SIZE;
+            reserveMapAtBack(newNodes);
+            size_t i = 1;
+            try {
+                for (; i <= newNodes; ++i) {
+                    end_.node_[i] = getNewBuck();
+                }
+            }
+            catch (...) {
+                putBucks(end_.node_ + 1, end_.node_ + i);
+                throw;
+            }
+        }
+        return end_ + n;
+    }
+    template<class T, class Alloc>
+    typename deque<T, Alloc>::iterator deque<T, Alloc>::reserveElementsAtFront(size_t n) {
+        size_t vacancies = beg_.cur_ - beg_.first_;
+        if (n > vacancies) {
+            size_t newNodes = (n - vacancies + BUCK_SIZE - 1) / BUCK_SIZE;
+            reserveMapAtFront(newNodes);
+            size_t i = 1;
+            try {
+                for (; i <= newNodes; ++i) {
+                    *(beg_.node_ - i) = getNewBuck();
+                }
+            }
+            catch (...) {
+                putBucks(beg_.node_ - i + 1, beg_.node_);
+                throw;
+            }
+        }
+        return beg_ - n;
+    }
+    template<class T, class Alloc>
+    inline typename deque<T, Alloc>::iterator deque<T, Alloc>::mutablePos(const_iterator pos) {
+        iterator it;
+        it.cur_ = const_cast<T*>(pos.cur_);
+        it.first_ = const_cast<T*>(pos.first_);
+        it.last_ = const_cast<T*>(pos.last_);
+        it.node_ = pos.node_;
+        return it;
+    }
+
+    template<class T, class Alloc>
+    typename deque<T, Alloc>::iterator deque<T, Alloc>::insert(const_iterator pos, size_type n, const value_type& value) {
+        return fill_insert(mutablePos(pos), n, value);
+    }
+    template<class T, class Alloc>
+    template<class InputIterator>
+    typename deque<T, Alloc>::iterator deque<T, Alloc>::insert(const_iterator pos, InputIterator first, InputIterator last) {
+        difference_type elemsBefore = pos - cbegin();
+        insert_aux(mutablePos(pos), first, last, typename std::is_integral<InputIterator>::type());
+        return beg_ + elemsBefore;
+    }
+    template<class T, class Alloc>
+    void deque<T, Alloc>::insert_aux(iterator pos, size_t n, const value_type& value, std::true_type) {
+        fill_insert(pos, n, value);
+    }
+    template<class T, class Alloc>
+    template<class InputIterator>
+    void deque<T, Alloc>::insert_aux(iterator pos, InputIterator first, InputIterator last, std::false_type) {
+        range_insert(pos, first, last, typename iterator_traits<InputIterator>::iterator_category());
+    }
+    // single pass: collect into a temporary deque, then insert that as a forward range
+    template<class T, class Alloc>
+    template<class InputIterator>
+    void deque<T, Alloc>::range_insert(iterator pos, InputIterator first, InputIterator last, input_iterator_tag) {
+        deque temp(first, last, this->get_alloc());
+        range_insert(pos, std::make_move_iterator(temp.begin()), std::make_move_iterator(temp.end()), forward_iterator_tag());
+    }
+
+    /*
+    ** Bulk insertion opens an n element gap on the shorter side of pos: whole
+    ** buckets are reserved in one go, the elements between that end and pos are
+    ** moved over by n, and the gap is filled. Only the part of the gap and of the
+    ** moved elements that lands in fresh memory is constructed; the rest is
+    ** assigned. If constructing throws, the fresh buckets are released again.
+    */
+    template<class T, class Alloc>
+    typename deque<T, Alloc>::iterator deque<T, Alloc>::fill_insert(iterator pos, size_t n, const value_type& value) {
+        difference_type elemsBefore = pos - beg_;
+        if (n == 0) return pos;
+        value_type copy(value);    // value may live in this deque
+        if (size_t(elemsBefore) < size() / 2) {
+            iterator newStart = reserveElementsAtFront(n);
+            iterator oldStart = beg_;
+            pos = beg_ + elemsBefore;
+            try {
+                if (size_t(elemsBefore) >= n) {
+                    uninitCopy(std::make_move_iterator(beg_), std::make_move_iterator(beg_ + n), newStart);
+                }
+                else {
+                    iterator mid = uninitCopy(std::make_move_iterator(beg_), std::make_move_iterator(pos), newStart);
+                    try {
+                        uninitFill(mid, oldStart, copy);
+                    }
+                    catch (...) {
+                        destroyRange(newStart, mid);
+                        throw;
+                    }
+                }
+            }
+            catch (...) {
+                putBucks(newStart.node_, oldStart.node_);
+                throw;
+            }
+            beg_ = newStart;
+            if (size_t(elemsBefore) >= n) {
+                std::move(oldStart + n, pos, oldStart);
+                std::fill(pos - n, pos, copy);
+            }
+            else {
+                std::fill(oldStart, pos, copy);
+            }
+        }
+        else {
+            iterator newFinish = reserveElementsAtBack(n);
+            iterator oldFinish = end_;
+            size_t elemsAfter = size() - elemsBefore;
+            pos = end_ - elemsAfter;
+            try {
+                if (elemsAfter > n) {
+                    uninitCopy(std::make_move_iterator(end_ - n), std::make_move_iterator(end_), end_);
+                }
+                else {
+                    uninitFill(oldFinish, pos + n, copy);
+                    try {
+                        uninitCopy(std::make_move_iterator(pos), std::make_move_iterator(oldFinish), pos + n);
+                    }
+                    catch (...) {
+                        destroyRange(oldFinish, pos + n);
+                        throw;
+                    }
+                }
+            }
+            catch (...) {
+                putBucks(oldFinish.node_ + 1, newFinish.node_ + 1);
+                throw;
+            }
+            end_ = newFinish;
+            if (elemsAfter > n) {
+                std::move_backward(pos, oldFinish - n, oldFinish);
+                std::fill(pos, pos + n, copy);
+            }
+            else {
+                std::fill(pos, oldFinish, copy);
+            }
+        }
+        return beg_ + elemsBefore;
+    }
+    // the forward range counterpart of fill_insert
+    template<class T, class Alloc>
+    template<class ForwardIterator>
+    void deque<T, Alloc>::range_insert(iterator pos, ForwardIterator first, ForwardIterator last, forward_iterator_tag) {
+        size_t n = tinySTL::distance(first, last);
+        difference_type elemsBefore = pos - beg_;
+        if (n == 0) return;
+        if (size_t(elemsBefore) < size() / 2) {
+            iterator newStart = reserveElementsAtFront(n);
+            iterator oldStart = beg_;
+            pos = beg_ + elemsBefore;
+            ForwardIterator mid = first;
+            try {
+                if (size_t(elemsBefore) >= n) {
+                    uninitCopy(std::make_move_iterator(beg_), std::make_move_iterator(beg_ + n), newStart);
+                }
+                else {
+                    tinySTL::advance(mid, n - elemsBefore);
+                    iterator moved = uninitCopy(std::make_move_iterator(beg_), std::make_move_iterator(pos), newStart);
+                    try {
+                        uninitCopy(first, mid, moved);
+                    }
+                    catch (...) {
+                        destroyRange(newStart, moved);
+                        throw;
+                    }
+                }
+            }
+            catch (...) {
+                putBucks(newStart.node_, oldStart.node_);
+                throw;
+            }
+            beg_ = newStart;
+            if (size_t(elemsBefore) >= n) {
+                std::move(oldStart + n, pos, oldStart);
+                std::copy(first, last, pos - n);
+            }
+            else {
+                std::copy(mid, last, oldStart);
+            }
+        }
+        else {
+            iterator newFinish = reserveElementsAtBack(n);
+            iterator oldFinish = end_;
+            size_t elemsAfter = size() - elemsBefore;
+            pos = end_ - elemsAfter;
+            ForwardIterator mid = first;
+            try {
+                if (elemsAfter > n) {
+                    uninitCopy(std::make_move_iterator(end_ - n), std::make_move_iterator(end_), end_);
+                }
+                else {
+                    tinySTL::advance(mid, elemsAfter);
+                    iterator filled = uninitCopy(mid, last, oldFinish);
+                    try {
+                        uninitCopy(std::make_move_iterator(pos), std::make_move_iterator(oldFinish), filled);
+                    }
+                    catch (...) {
+                        destroyRange(oldFinish, filled);
+                        throw;
+                    }
+                }
+            }
+            catch (...) {
+                putBucks(oldFinish.node_ + 1, newFinish.node_ + 1);
+                throw;
+            }
+            end_ = newFinish;
+            if (elemsAfter > n) {
+                std::move_backward(pos, oldFinish - n, oldFinish);
+                std::copy(first, last, pos);
+            }
+            else {
+                std::copy(first, mid, pos);
+            }
+        }
+    }
+
+    template<class T, class Alloc>
+    typename deque<T, Alloc>::iterator deque<T, Alloc>::erase(const_iterator pos) {
+        return erase(pos, pos + 1);
+    }
+    // close the gap from the shorter side, then free the buckets that side no longer uses
+    template<class T, class Alloc>
+    typename deque<T, Alloc>::iterator deque<T, Alloc>::erase(const_iterator first, const_iterator last) {
+        if (first.cur_ == beg_.cur_ && last.cur_ == end_.cur_) {
+            clear();
+            return end_;
+        }
+        difference_type n = last - first;
+        difference_type elemsBefore = first - cbegin();
+        if (n == 0) return beg_ + elemsBefore;
+        if (size_t(elemsBefore) < (size() - n) / 2) {
+            std::move_backward(beg_, mutablePos(first), mutablePos(last));
+            iterator newStart = beg_ + n;
+            destroyRange(beg_, newStart);
+            putBucks(beg_.node_, newStart.node_);
+            beg_ = newStart;
+        }
+        else {
+            std::move(mutablePos(last), end_, mutablePos(first));
+            iterator newFinish = end_ - n;
+            destroyRange(newFinish, end_);
+            putBucks(newFinish.node_ + 1, end_.node_ + 1);
+            end_ = newFinish;
+        }
+        return beg_ + elemsBefore;
+    }
+
+    template<class T, class Alloc>
+    void deque<T, Alloc>::resize(size_type n, const value_type& value) {
+        size_type len = size();
+        if (n < len) {
+            erase(beg_ + n, end_);
+        }
+        else {
+            fill_insert(end_, n - len, value);
+        }
+    }
+    template<class T, class Alloc>
+    void deque<T, Alloc>::assign(size_type n, const value_type& value) {
+        assign_aux(n, value, std::true_type());
+    }
+    template<class T, class Alloc>
+    template<class InputIterator>
+    void deque<T, Alloc>::assign(InputIterator first, InputIterator last) {
+        assign_aux(first, last, typename std::is_integral<InputIterator>::type());
+    }
+    template<class T, class Alloc>
+    void deque<T, Alloc>::assign_aux(size_t n, const value_type& value, std::true_type) {
+        size_t len = size();
+        if (n > len) {
+            std::fill(beg_, end_, value);
+            fill_insert(end_, n - len, value);
+        }
+        else {
+            erase(beg_ + n, end_);
+            std::fill(beg_, end_, value);
+        }
+    }
+    template<class T, class Alloc>
+    template<class InputIterator>
+    void deque<T, Alloc>::assign_aux(InputIterator first, InputIterator last, std::false_type) {
+        assign_range(first, last, typename iterator_traits<InputIterator>::iterator_category());
+    }
+    template<class T, class Alloc>
+    template<class InputIterator>
+    void deque<T, Alloc>::assign_range(InputIterator first, InputIterator last, input_iterator_tag) {
+        iterator cur = beg_;
+        for (; first != last && cur != end_; ++cur, ++first) {
+            *cur = *first;
+        }
+        if (first == last) {
+            erase(cur, end_);
+        }
+        else {
+            range_insert(end_, first, last, input_iterator_tag());
+        }
+    }
+    template<class T, class Alloc>
+    template<class ForwardIterator>
+    void deque<T, Alloc>::assign_range(ForwardIterator first, ForwardIterator last, forward_iterator_tag) {
+        size_t len = tinySTL::distance(first, last);
+        if (len > size()) {
+            ForwardIterator mid = first;
+            tinySTL::advance(mid, size());
+            std::copy(first, mid, beg_);
+            range_insert(end_, mid, last, forward_iterator_tag());
+        }
+        else {
+            erase(std::copy(first, last, beg_), end_);
+        }
+    }
+
+    template<class T, class Alloc>
+    bool operator ==(const deque<T, Alloc>& d1, const deque<T, Alloc>& d2) {
+        if (d1.size() != d2.size()) return false;
+        typename deque<T, Alloc>::const_iterator it1 = d1.begin(), it2 = d2.begin();
+        for (; it1 != d1.end(); ++it1, ++it2) {
+            if (!(*it1 == *it2)) return false;
+        }
+        return true;
+    }
+    template<class T, class Alloc>
+    bool operator !=(const deque<T, Alloc>& d1, const deque<T, Alloc>& d2) {
+        return !(d1 == d2);
+    }
+    template<class T, class Alloc>
+    void swap(deque<T, Alloc>& d1, deque<T, Alloc>& d2) {
+        d1.swap(d2);
+    }
 }
-// #include "Deque.cpp"
-#endif // _DEQUE_H_
\ No newline at end of file
+#endif // _DEQUE_H_
@@ -0,0 +1,371 @@
+#ifndef _EXECUTION_H_
+#define _EXECUTION_H_
+
+#include "Algorithm.h"
+#include "Functional.h"
+#include "Iterator.h"
+#include "ThreadPool.h"
+#include "Vector.h"
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace tinySTL {
+
+	namespace execution {
+		struct sequenced_policy {};
+		struct parallel_policy {};
+		// no vectorisation of its own yet: runs as parallel_policy
+		struct parallel_unsequenced_policy {};
+
+		constexpr sequenced_policy seq{};
+		constexpr parallel_policy par{};
+		constexpr parallel_unsequenced_policy par_unseq{};
+	}// namespace execution
+
+	template<class T>
+	struct is_execution_policy : std::false_type {};
+	template<>
+	struct is_execution_policy<execution::sequenced_policy> : std::true_type {};
+	template<>
+	struct is_execution_policy<execution::parallel_policy> : std::true_type {};
+	template<>
+	struct is_execution_policy<execution::parallel_unsequenced_policy> : std::true_type {};
+
+	/*
+	** The overloads below take a policy first. A parallel policy over
+	** random access iterators splits the work into tasks on
+	** thread_pool::shared(), the calling thread working on them as well;
+	** anything else (seq, or a range that cannot be split without walking
+	** it) runs the sequential algorithm. Ranges too short to be worth a
+	** task, MIN_GRAIN elements for the element-wise algorithms, run on the
+	** calling thread alone. for_each and transform go through parallel_for,
+	** which splits only as fast as the pool takes the pieces; reduce cuts
+	** fixed pieces, so that its result does not depend on the timing.
+	** Function objects are shared by the tasks, so they are called from
+	** several threads at once. The first exception a task throws is
+	** rethrown once all the tasks are done.
+	*/
+	namespace Detail {
+		enum EParallelGrain{ MIN_GRAIN = 2048, MIN_CHUNK = 256, SORT_MIN_GRAIN = 4096, PIECES_PER_THREAD = 4 };
+
+		template<class Policy, class T = void>
+		struct enable_if_policy : std::enable_if<is_execution_policy<typename std::decay<Policy>::type>::value, T> {};
+
+		template<class Iterator>
+		struct is_random_access : std::is_convertible<
+			typename iterator_traits<Iterator>::iterator_category, random_access_iterator_tag> {};
+
+		template<class Policy, class Iterator1, class Iterator2 = Iterator1, class Iterator3 = Iterator1>
+		struct runs_parallel : std::integral_constant<bool,
+			!std::is_same<typename std::decay<Policy>::type, execution::sequenced_policy>::value &&
+			is_random_access<Iterator1>::value && is_random_access<Iterator2>::value &&
+			is_random_access<Iterator3>::value> {};
+
+		// parallel_for's own grain, but no less than MIN_CHUNK elements a call
+		inline size_t chunk_grain(ptrdiff_t n) {
+			size_t grain = size_t(n) / (64 * (thread_pool::shared().size() + 1));
+			return grain > MIN_CHUNK ? grain : size_t(MIN_CHUNK);
+		}
+		// how many pieces of at least grain elements n is cut into: a few per thread, so stealing can even them out
+		inline ptrdiff_t piece_count(ptrdiff_t n, ptrdiff_t grain) {
+			ptrdiff_t pieces = n / grain;
+			ptrdiff_t most = PIECES_PER_THREAD * ptrdiff_t(thread_pool::shared().size() + 1);
+			return pieces < most ? pieces : most;
+		}
+		// f(i, begin, end) for each of the pieces of [0, n); the calling thread takes the first
+		template<class Function>
+		void for_pieces(ptrdiff_t pieces, ptrdiff_t n, Function& f) {
+			task_group group;
+			for (ptrdiff_t i = 1; i < pieces; ++i) {
+				group.spawn([&f, i, n, pieces] { f(i, n * i / pieces, n * (i + 1) / pieces); });
+			}
+			f(ptrdiff_t(0), ptrdiff_t(0), n / pieces);
+			group.sync();
+		}
+	}// namespace Detail
+
+	//********** [for_each] ******************************
+	namespace Detail {
+		template<class InputIterator, class Function>
+		void for_each_policy(InputIterator first, InputIterator last, Function& f, std::false_type) {
+			tinySTL::for_each(first, last, std::ref(f));
+		}
+		template<class RandomAccessIterator, class Function>
+		void for_each_policy(RandomAccessIterator first, RandomAccessIterator last, Function& f, std::true_type) {
+			ptrdiff_t n = last - first;
+			if (n < MIN_GRAIN) {
+				tinySTL::for_each(first, last, std::ref(f));
+				return;
+			}
+			parallel_for(first, last, [&f](RandomAccessIterator begin, RandomAccessIterator end) {
+				tinySTL::for_each(begin, end, std::ref(f));
+			}, chunk_grain(n));
+		}
+	}// namespace Detail
+
+	template<class ExecutionPolicy, class InputIterator, class Function>
+	typename Detail::enable_if_policy<ExecutionPolicy>::type
+		for_each(ExecutionPolicy&&, InputIterator first, InputIterator last, Function f) {
+		typedef Detail::runs_parallel<ExecutionPolicy, InputIterator> parallel;
+		Detail::for_each_policy(first, last, f, parallel());
+	}
+
+	//********** [transform] *****************************
+	namespace Detail {
+		template<class InputIterator, class OutputIterator, class UnaryOperation>
+		OutputIterator transform_policy(InputIterator first, InputIterator last, OutputIterator result,
+			UnaryOperation& op, std::false_type) {
+			return tinySTL::transform(first, last, result, std::ref(op));
+		}
+		template<class RandomAccessIterator1, class RandomAccessIterator2, class UnaryOperation>
+		RandomAccessIterator2 transform_policy(RandomAccessIterator1 first, RandomAccessIterator1 last,
+			RandomAccessIterator2 result, UnaryOperation& op, std::true_type) {
+			ptrdiff_t n = last - first;
+			if (n < MIN_GRAIN) return tinySTL::transform(first, last, result, std::ref(op));
+			parallel_for(ptrdiff_t(0), n, [first, result, &op](ptrdiff_t begin, ptrdiff_t end) {
+				tinySTL::transform(first + begin, first + end, result + begin, std::ref(op));
+			}, chunk_grain(n));
+			return result + n;
+		}
+
+		template<class InputIterator1, class InputIterator2, class OutputIterator, class BinaryOperation>
+		OutputIterator transform_policy(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2,
+			OutputIterator result, BinaryOperation& op, std::false_type) {
+			return tinySTL::transform(first1, last1, first2, result, std::ref(op));
+		}
+		template<class RandomAccessIterator1, class RandomAccessIterator2, class RandomAccessIterator3, class BinaryOperation>
+		RandomAccessIterator3 transform_policy(RandomAccessIterator1 first1, RandomAccessIterator1 last1,
+			RandomAccessIterator2 first2, RandomAccessIterator3 result, BinaryOperation& op, std::true_type) {
+			ptrdiff_t n = last1 - first1;
+			if (n < MIN_GRAIN) return tinySTL::transform(first1, last1, first2, result, std::ref(op));
+			parallel_for(ptrdiff_t(0), n, [first1, first2, result, &op](ptrdiff_t begin, ptrdiff_t end) {
+				tinySTL::transform(first1 + begin, first1 + end, first2 + begin, result + begin, std::ref(op));
+			}, chunk_grain(n));
+			return result + n;
+		}
+	}// namespace Detail
+
+	template<class ExecutionPolicy, class ForwardIterator1, class ForwardIterator2, class UnaryOperation>
+	typename Detail::enable_if_policy<ExecutionPolicy, ForwardIterator2>::type
+		transform(ExecutionPolicy&&, ForwardIterator1 first, ForwardIterator1 last,
+			ForwardIterator2 result, UnaryOperation op) {
+		typedef Detail::runs_parallel<ExecutionPolicy, ForwardIterator1, ForwardIterator2> parallel;
+		return Detail::transform_policy(first, last, result, op, parallel());
+	}
+	template<class ExecutionPolicy, class ForwardIterator1, class ForwardIterator2, class ForwardIterator3, class BinaryOperation>
+	typename Detail::enable_if_policy<ExecutionPolicy, ForwardIterator3>::type
+		transform(ExecutionPolicy&&, ForwardIterator1 first1, ForwardIterator1 last1,
+			ForwardIterator2 first2, ForwardIterator3 result, BinaryOperation op) {
+		typedef Detail::runs_parallel<ExecutionPolicy, ForwardIterator1, ForwardIterator2, ForwardIterator3> parallel;
+		return Detail::transform_policy(first1, last1, first2, result, op, parallel());
+	}
+
+	//********** [reduce] ********************************
+	namespace Detail {
+		template<class InputIterator, class T, class BinaryOperation>
+		T reduce_policy(InputIterator first, InputIterator last, T init, BinaryOperation& op, std::false_type) {
+			return tinySTL::reduce(first, last, init, std::ref(op));
+		}
+		// each piece is reduced from its first element, then the pieces are reduced in order onto init
+		template<class RandomAccessIterator, class T, class BinaryOperation>
+		T reduce_policy(RandomAccessIterator first, RandomAccessIterator last, T init, BinaryOperation& op, std::true_type) {
+			ptrdiff_t n = last - first, pieces = piece_count(n, MIN_GRAIN);
+			if (pieces <= 1) return tinySTL::reduce(first, last, init, std::ref(op));
+			vector<T> partial(pieces, init);
+			auto piece = [first, &partial, &op](ptrdiff_t i, ptrdiff_t begin, ptrdiff_t end) {
+				partial[i] = tinySTL::reduce(first + begin + 1, first + end, T(first[begin]), std::ref(op));
+			};
+			for_pieces(pieces, n, piece);
+			return tinySTL::reduce(partial.begin(), partial.end(), init, std::ref(op));
+		}
+	}// namespace Detail
+
+	template<class ExecutionPolicy, class ForwardIterator, class T, class BinaryOperation>
+	typename Detail::enable_if_policy<ExecutionPolicy, T>::type
+		reduce(ExecutionPolicy&&, ForwardIterator first, ForwardIterator last, T init, BinaryOperation op) {
+		typedef Detail::runs_parallel<ExecutionPolicy, ForwardIterator> parallel;
+		return Detail::reduce_policy(first, last, init, op, parallel());
+	}
+	template<class ExecutionPolicy, class ForwardIterator, class T>
+	typename Detail::enable_if_policy<ExecutionPolicy, T>::type
+		reduce(ExecutionPolicy&& policy, ForwardIterator first, ForwardIterator last, T init) {
+		return tinySTL::reduce(std::forward<ExecutionPolicy>(policy), first, last, init, Detail::plus_op());
+	}
+	template<class ExecutionPolicy, class ForwardIterator>
+	typename Detail::enable_if_policy<ExecutionPolicy, typename iterator_traits<ForwardIterator>::value_type>::type
+		reduce(ExecutionPolicy&& policy, ForwardIterator first, ForwardIterator last) {
+		typedef typename iterator_traits<ForwardIterator>::value_type value_type;
+		return tinySTL::reduce(std::forward<ExecutionPolicy>(policy), first, last, value_type(), Detail::plus_op());
+	}
+
+	//********** [sort] **********************************
+	/*
+	** The introsort of Algorithm.h with the upper part of each partition
+	** handed to the pool while this thread goes on with the lower part, down
+	** to pieces of about n / (8 * threads) elements, which are sorted
+	** sequentially. The first partitions are still one thread's work.
+	*/
+	namespace Detail {
+		template<class RandomAccessIterator, class Compare>
+		void parallel_sort(RandomAccessIterator first, RandomAccessIterator last, Compare& comp,
+			size_t depth, ptrdiff_t grain, task_group& group) {
+			while (last - first > grain) {
+				if (depth == 0) {
+					heap_sort(first, last, comp);
+					return;
+				}
+				--depth;
+				RandomAccessIterator cut = partition_pivot(first, last, comp);
+				group.spawn([cut, last, &comp, depth, grain, &group] { parallel_sort(cut, last, comp, depth, grain, group); });
+				last = cut;
+			}
+			sort_aux(first, last, comp);
+		}
+
+		// pieces of at least floor elements, about 8 per thread
+		inline ptrdiff_t sort_grain(ptrdiff_t n, ptrdiff_t floor) {
+			ptrdiff_t grain = n / (8 * ptrdiff_t(thread_pool::shared().size() + 1));
+			return grain > floor ? grain : floor;
+		}
+
+		template<class RandomAccessIterator, class Compare>
+		void sort_policy(RandomAccessIterator first, RandomAccessIterator last, Compare& comp, std::false_type) {
+			sort_aux(first, last, comp);
+		}
+		template<class RandomAccessIterator, class Compare>
+		void sort_policy(RandomAccessIterator first, RandomAccessIterator last, Compare& comp, std::true_type) {
+			ptrdiff_t n = last - first, grain = sort_grain(n, SORT_MIN_GRAIN);
+			if (n <= grain) {
+				sort_aux(first, last, comp);
+				return;
+			}
+			task_group group;
+			parallel_sort(first, last, comp, sort_depth(n), grain, group);
+			group.sync();
+		}
+	}// namespace Detail
+
+	template<class ExecutionPolicy, class RandomAccessIterator, class Compare>
+	typename Detail::enable_if_policy<ExecutionPolicy>::type
+		sort(ExecutionPolicy&&, RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+		typedef Detail::runs_parallel<ExecutionPolicy, RandomAccessIterator> parallel;
+		Detail::sort_policy(first, last, comp, parallel());
+	}
+	template<class ExecutionPolicy, class RandomAccessIterator>
+	typename Detail::enable_if_policy<ExecutionPolicy>::type
+		sort(ExecutionPolicy&& policy, RandomAccessIterator first, RandomAccessIterator last) {
+		typedef typename iterator_traits<RandomAccessIterator>::value_type value_type;
+		tinySTL::sort(std::forward<ExecutionPolicy>(policy), first, last, less<value_type>());
+	}
+
+	//********** [stable_sort] ***************************
+	/*
+	** The merge sort of Algorithm.h with the two halves sorted as separate
+	** tasks and the merges themselves split: the longer input is cut in the
+	** middle, the shorter one where that element would go, and the two
+	** pairs of pieces are merged side by side.
+	*/
+	namespace Detail {
+		// first place in [first, last) that value should go before
+		template<class RandomAccessIterator, class T, class Compare>
+		RandomAccessIterator merge_bound(RandomAccessIterator first, RandomAccessIterator last,
+			const T& value, Compare& comp, std::false_type) {
+			// lower bound: equal elements of the second input stay after value
+			while (first != last) {
+				RandomAccessIterator mid = first + (last - first) / 2;
+				if (comp(*mid, value)) first = mid + 1;
+				else last = mid;
+			}
+			return first;
+		}
+		template<class RandomAccessIterator, class T, class Compare>
+		RandomAccessIterator merge_bound(RandomAccessIterator first, RandomAccessIterator last,
+			const T& value, Compare& comp, std::true_type) {
+			// upper bound: equal elements of the first input stay before value
+			while (first != last) {
+				RandomAccessIterator mid = first + (last - first) / 2;
+				if (comp(value, *mid)) last = mid;
+				else first = mid + 1;
+			}
+			return first;
+		}
+
+		template<class RandomAccessIterator1, class RandomAccessIterator2, class Compare>
+		void parallel_merge(RandomAccessIterator1 first1, RandomAccessIterator1 last1,
+			RandomAccessIterator1 first2, RandomAccessIterator1 last2,
+			RandomAccessIterator2 result, Compare& comp, ptrdiff_t grain) {
+			if ((last1 - first1) + (last2 - first2) <= grain) {
+				merge_move(first1, last1, first2, last2, result, comp);
+				return;
+			}
+			RandomAccessIterator1 cut1, cut2;
+			if (last1 - first1 >= last2 - first2) {
+				cut1 = first1 + (last1 - first1) / 2;
+				cut2 = merge_bound(first2, last2, *cut1, comp, std::false_type());
+			}
+			else {
+				cut2 = first2 + (last2 - first2) / 2;
+				cut1 = merge_bound(first1, last1, *cut2, comp, std::true_type());
+			}
+			task_group group;
+			group.spawn([=, &comp] { parallel_merge(first1, cut1, first2, cut2, result, comp, grain); });
+			parallel_merge(cut1, last1, cut2, last2, result + (cut1 - first1) + (cut2 - first2), comp, grain);
+			group.sync();
+		}
+
+		template<class RandomAccessIterator1, class RandomAccessIterator2, class Compare>
+		void parallel_merge_sort(RandomAccessIterator1 first, RandomAccessIterator1 last,
+			RandomAccessIterator2 buf, Compare& comp, bool toBuf, ptrdiff_t grain) {
+			ptrdiff_t n = last - first, half = n / 2;
+			if (n <= grain) {
+				merge_sort(first, last, buf, comp, toBuf);
+				return;
+			}
+			{
+				task_group group;
+				group.spawn([=, &comp] { parallel_merge_sort(first, first + half, buf, comp, !toBuf, grain); });
+				parallel_merge_sort(first + half, last, buf + half, comp, !toBuf, grain);
+				group.sync();
+			}
+			if (toBuf) {
+				parallel_merge(first, first + half, first + half, last, buf, comp, grain);
+			}
+			else {
+				parallel_merge(buf, buf + half, buf + half, buf + n, first, comp, grain);
+			}
+		}
+
+		template<class RandomAccessIterator, class Compare>
+		void stable_sort_policy(RandomAccessIterator first, RandomAccessIterator last, Compare& comp, std::false_type) {
+			stable_sort_aux(first, last, comp);
+		}
+		template<class RandomAccessIterator, class Compare>
+		void stable_sort_policy(RandomAccessIterator first, RandomAccessIterator last, Compare& comp, std::true_type) {
+			typedef typename iterator_traits<RandomAccessIterator>::value_type value_type;
+			ptrdiff_t n = last - first, grain = sort_grain(n, SORT_MIN_GRAIN);
+			if (n <= grain) {
+				stable_sort_aux(first, last, comp);
+				return;
+			}
+			temporary_buffer<value_type> buf(first, n);
+			parallel_merge_sort(buf.data(), buf.data() + n, first, comp, true, grain);
+		}
+	}// namespace Detail
+
+	template<class ExecutionPolicy, class RandomAccessIterator, class Compare>
+	typename Detail::enable_if_policy<ExecutionPolicy>::type
+		stable_sort(ExecutionPolicy&&, RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+		typedef Detail::runs_parallel<ExecutionPolicy, RandomAccessIterator> parallel;
+		Detail::stable_sort_policy(first, last, comp, parallel());
+	}
+	template<class ExecutionPolicy, class RandomAccessIterator>
+	typename Detail::enable_if_policy<ExecutionPolicy>::type
+		stable_sort(ExecutionPolicy&& policy, RandomAccessIterator first, RandomAccessIterator last) {
+		typedef typename iterator_traits<RandomAccessIterator>::value_type value_type;
+		tinySTL::stable_sort(std::forward<ExecutionPolicy>(policy), first, last, less<value_type>());
+	}
+} // namespace tinySTL
+
+#endif // _EXECUTION_H_
@@ -1,6 +1,9 @@
 #ifndef _FUNCTIONAL_H_
 #define _FUNCTIONAL_H_
 
+#include <cstddef>
+#include <functional>
+
 namespace tinySTL {
 
 	template<class T>
@@ -9,21 +12,39 @@ namespace tinySTL {
 		typedef T second_argument_type;
 		typedef bool result_type;
 
-		result_type operator()(const first_argument_type& x, const second_argument_type& y) {
+		result_type operator()(const first_argument_type& x, const second_argument_type& y) const {
 			return x < y;
 		}
 	};
 
-	template<class T>
+	template<class T = void>
 	struct equal_to {
 		typedef T first_argument_type;
 		typedef T second_argument_type;
 		typedef bool result_type;
 
-		result_type operator()(const first_argument_type& x, const second_argument_type& y) {
+		result_type operator()(const first_argument_type& x, const second_argument_type& y) const {
 			return x == y;
 		}
 	};
+	// compares any two types that have an ==; lets hash tables look up without building a key
+	template<>
+	struct equal_to<void> {
+		typedef void is_transparent;
+
+		template<class T, class U>
+		bool operator()(const T& x, const U& y) const {
+			return x == y;
+		}
+	};
+
+	/*
+	** The hash function of the hash containers: std::hash for now. Tables
+	** mix the result again before using it, so an identity hash such as
+	** std::hash<int> is fine.
+	*/
+	template<class Key>
+	struct hash : std::hash<Key> {};
 
 } // namespace tinySTL
 #endif // !
@@ -1,13 +1,26 @@
 #ifndef _ITERATOR_H_
 #define _ITERATOR_H_
 
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
 namespace tinySTL {
 
-	struct input_iterator_tag {};
-	struct output_iterator_tag {};
-	struct forward_iterator_tag : public input_iterator_tag {};
-	struct bidirectional_iterator_tag : public forward_iterator_tag {};
-	struct random_access_iterator_tag : public bidirectional_iterator_tag {};
+	// the standard tags themselves, so tinySTL iterators also work with <algorithm>
+	typedef std::input_iterator_tag input_iterator_tag;
+	typedef std::output_iterator_tag output_iterator_tag;
+	typedef std::forward_iterator_tag forward_iterator_tag;
+	typedef std::bidirectional_iterator_tag bidirectional_iterator_tag;
+	typedef std::random_access_iterator_tag random_access_iterator_tag;
+
+	/*
+	** Random access over one block of memory, so &*(it + n) == &*it + n.
+	** Algorithms may take such a range to its addresses with to_address and
+	** run their pointer paths (memmove, the SIMD kernels) on it. Raw pointers
+	** carry this tag; an adaptor that reorders the elements must not.
+	*/
+	struct contiguous_iterator_tag : random_access_iterator_tag {};
 
 	template<class T, class Distance> struct input_iterator
 	{
@@ -75,13 +88,53 @@ namespace tinySTL {
 	template<class T>
 	struct iterator_traits<T*>
 	{
-		typedef random_access_iterator_tag iterator_category;
+		typedef contiguous_iterator_tag    iterator_category;
 		typedef T                          value_type;
 		typedef ptrdiff_t                  difference_type;
 		typedef T* pointer;
 		typedef T& reference;
 	};
 
+	/*
+	** Iterators over a sequence of contiguous segments, such as deque's
+	** buckets, specialise this with is_segmented_iterator = true_type and
+	**   segment_iterator, local_iterator
+	**   segment(it), local(it)    the segment of it and its place inside
+	**   begin(seg), end(seg)      the bounds of a segment
+	**   compose(seg, local)       back to an iterator; local may be end(seg)
+	** so that algorithms can run plain pointer loops segment by segment.
+	*/
+	template<class Iterator>
+	struct segmented_iterator_traits {
+		typedef std::false_type is_segmented_iterator;
+	};
+
+	namespace Detail {
+		template<class Iterator, class Segmented = typename segmented_iterator_traits<Iterator>::is_segmented_iterator>
+		struct move_segmented_traits {
+			typedef std::false_type is_segmented_iterator;
+		};
+		template<class Iterator>
+		struct move_segmented_traits<Iterator, std::true_type> {
+			typedef segmented_iterator_traits<Iterator> base_traits;
+			typedef std::true_type is_segmented_iterator;
+			typedef typename base_traits::segment_iterator segment_iterator;
+			typedef std::move_iterator<typename base_traits::local_iterator> local_iterator;
+
+			static segment_iterator segment(const std::move_iterator<Iterator>& it) { return base_traits::segment(it.base()); }
+			static local_iterator local(const std::move_iterator<Iterator>& it) { return local_iterator(base_traits::local(it.base())); }
+			static local_iterator begin(segment_iterator seg) { return local_iterator(base_traits::begin(seg)); }
+			static local_iterator end(segment_iterator seg) { return local_iterator(base_traits::end(seg)); }
+			static std::move_iterator<Iterator> compose(segment_iterator seg, local_iterator local) {
+				return std::move_iterator<Iterator>(base_traits::compose(seg, local.base()));
+			}
+		};
+	}// namespace Detail
+
+	// moving out of a segmented range is segmented as well
+	template<class Iterator>
+	struct segmented_iterator_traits<std::move_iterator<Iterator> > : Detail::move_segmented_traits<Iterator> {};
+
 	template<class Iterator>
 	inline typename iterator_traits<Iterator>::iterator_category
 		iterator_category(const Iterator& It)
@@ -99,5 +152,90 @@ namespace tinySTL {
 		difference_type(const Iterator& It) {
 		return static_cast<typename iterator_traits<Iterator>::difference_type*>(0);
 	};
+
+	namespace Detail {
+		template<class T>
+		struct void_of { typedef void type; };
+
+		// output iterators without the nested typedefs are simply not contiguous
+		template<class Iterator, class = void>
+		struct contiguous_category : std::false_type {};
+		template<class Iterator>
+		struct contiguous_category<Iterator, typename void_of<typename Iterator::iterator_category>::type>
+			: std::is_convertible<typename Iterator::iterator_category, contiguous_iterator_tag> {};
+
+		// what an adaptor that does not keep the elements in memory order (reverse_iterator) may claim
+		template<class Category>
+		struct without_contiguous { typedef Category type; };
+		template<>
+		struct without_contiguous<contiguous_iterator_tag> { typedef random_access_iterator_tag type; };
+	}// namespace Detail
+
+	template<class Iterator>
+	struct is_contiguous_iterator : Detail::contiguous_category<Iterator> {};
+	template<class T>
+	struct is_contiguous_iterator<T*> : std::true_type {};
+
+	// the address of the element a contiguous iterator refers to
+	template<class T>
+	inline T *to_address(T *p) { return p; }
+	template<class Iterator>
+	inline auto to_address(const Iterator& it) -> decltype(tinySTL::to_address(it.operator->())) {
+		return tinySTL::to_address(it.operator->());
+	}
+
+	//********** [distance] / [advance] ********************
+	namespace Detail {
+		template<class InputIterator>
+		typename iterator_traits<InputIterator>::difference_type
+			distance_aux(InputIterator first, InputIterator last, input_iterator_tag) {
+			typename iterator_traits<InputIterator>::difference_type n = 0;
+			for (; first != last; ++first) ++n;
+			return n;
+		}
+		template<class RandomAccessIterator>
+		typename iterator_traits<RandomAccessIterator>::difference_type
+			distance_aux(RandomAccessIterator first, RandomAccessIterator last, random_access_iterator_tag) {
+			return last - first;
+		}
+
+		template<class InputIterator, class Distance>
+		void advance_aux(InputIterator& it, Distance n, input_iterator_tag) {
+			for (; n > 0; --n) ++it;
+		}
+		template<class BidirectionalIterator, class Distance>
+		void advance_aux(BidirectionalIterator& it, Distance n, bidirectional_iterator_tag) {
+			if (n >= 0) {
+				for (; n > 0; --n) ++it;
+			}
+			else {
+				for (; n < 0; ++n) --it;
+			}
+		}
+		template<class RandomAccessIterator, class Distance>
+		void advance_aux(RandomAccessIterator& it, Distance n, random_access_iterator_tag) {
+			it += n;
+		}
+	}// namespace Detail
+
+	template<class InputIterator>
+	inline typename iterator_traits<InputIterator>::difference_type
+		distance(InputIterator first, InputIterator last) {
+		return Detail::distance_aux(first, last, typename iterator_traits<InputIterator>::iterator_category());
+	}
+	template<class InputIterator, class Distance>
+	inline void advance(InputIterator& it, Distance n) {
+		Detail::advance_aux(it, n, typename iterator_traits<InputIterator>::iterator_category());
+	}
+	template<class InputIterator>
+	inline InputIterator next(InputIterator it, typename iterator_traits<InputIterator>::difference_type n = 1) {
+		tinySTL::advance(it, n);
+		return it;
+	}
+	template<class BidirectionalIterator>
+	inline BidirectionalIterator prev(BidirectionalIterator it, typename iterator_traits<BidirectionalIterator>::difference_type n = 1) {
+		tinySTL::advance(it, -n);
+		return it;
+	}
 }
 #endif // !_ITERATOR_H_
@@ -0,0 +1,415 @@
+#ifndef _LOCK_FREE_QUEUE_H_
+#define _LOCK_FREE_QUEUE_H_
+
+#include "Allocator.h"
+#include "AllocatorTraits.h"
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace tinySTL {
+
+	namespace Detail {
+		enum ECacheLine{ CACHE_LINE = 64 };
+
+		// smallest power of two >= n, and at least 2
+		inline size_t ring_capacity(size_t n) {
+			size_t cap = 2;
+			while (cap < n) cap <<= 1;
+			return cap;
+		}
+	}// namespace Detail
+
+	/*
+	** Bounded single-producer/single-consumer ring. One thread may push while
+	** one other thread pops; indices only grow and are masked into the ring.
+	** The producer and the consumer each own a cache line holding their index
+	** and a cached copy of the other side's index, so neither touches the
+	** other's line until its cached view says the ring is full (or empty).
+	** The try_* calls never block: they return false (or the number of
+	** elements moved) when there is no room or nothing to take.
+	** If constructing an element throws, nothing is pushed; if moving one out
+	** throws, that element and the ones after it stay in the queue.
+	*/
+	template<class T, class Alloc = allocator<T> >
+	class spsc_queue : private Detail::alloc_holder<Alloc> {
+		public:
+			typedef T value_type;
+			typedef size_t size_type;
+			typedef Alloc allocator_type;
+		private:
+			typedef allocator_traits<Alloc> dataTraits;
+			typedef Detail::alloc_holder<Alloc> holder;
+		private:
+			T *buf_;
+			size_t mask_;
+			char pad0_[Detail::CACHE_LINE];
+			std::atomic<size_t> head_;	// next slot to pop, written by the consumer
+			size_t tailCache_;			// consumer's last view of tail_
+			char pad1_[Detail::CACHE_LINE];
+			std::atomic<size_t> tail_;	// next slot to push, written by the producer
+			size_t headCache_;			// producer's last view of head_
+			char pad2_[Detail::CACHE_LINE];
+		public:
+			explicit spsc_queue(size_type capacity, const allocator_type& alloc = allocator_type());
+			spsc_queue(const spsc_queue&) = delete;
+			spsc_queue& operator = (const spsc_queue&) = delete;
+			~spsc_queue();
+
+			// producer side
+			bool try_push(const value_type& value) { return try_emplace(value); }
+			bool try_push(value_type&& value) { return try_emplace(std::move(value)); }
+			template<class... Args>
+			bool try_emplace(Args&&... args);
+			template<class InputIterator>
+			size_type try_push_n(InputIterator first, size_type n);
+
+			// consumer side
+			bool try_pop(value_type& value);
+			template<class OutputIterator>
+			size_type try_pop_n(OutputIterator out, size_type n);
+
+			// exact only when called from one of the two sides while the other is idle
+			size_type size() const;
+			bool empty() const { return size() == 0; }
+			size_type capacity() const { return mask_ + 1; }
+			allocator_type get_allocator() const { return this->get_alloc(); }
+		private:
+			size_type freeSlots(size_t tail, size_type n);
+			size_type readySlots(size_t head, size_type n);
+	};
+
+	template<class T, class Alloc>
+	spsc_queue<T, Alloc>::spsc_queue(size_type capacity, const allocator_type& alloc)
+		:holder(alloc), buf_(0), mask_(Detail::ring_capacity(capacity) - 1),
+		head_(0), tailCache_(0), tail_(0), headCache_(0) {
+		buf_ = dataTraits::allocate(this->get_alloc(), mask_ + 1);
+	}
+	template<class T, class Alloc>
+	spsc_queue<T, Alloc>::~spsc_queue() {
+		size_t tail = tail_.load(std::memory_order_relaxed);
+		for (size_t i = head_.load(std::memory_order_relaxed); i != tail; ++i) {
+			dataTraits::destroy(this->get_alloc(), buf_ + (i & mask_));
+		}
+		dataTraits::deallocate(this->get_alloc(), buf_, mask_ + 1);
+	}
+	// how many of n slots from tail are free; reloads head_ only when the cached view is short
+	template<class T, class Alloc>
+	typename spsc_queue<T, Alloc>::size_type spsc_queue<T, Alloc>::freeSlots(size_t tail, size_type n) {
+		size_t room = capacity() - (tail - headCache_);
+		if (room < n) {
+			headCache_ = head_.load(std::memory_order_acquire);
+			room = capacity() - (tail - headCache_);
+		}
+		return room < n ? room : n;
+	}
+	template<class T, class Alloc>
+	typename spsc_queue<T, Alloc>::size_type spsc_queue<T, Alloc>::readySlots(size_t head, size_type n) {
+		size_t ready = tailCache_ - head;
+		if (ready < n) {
+			tailCache_ = tail_.load(std::memory_order_acquire);
+			ready = tailCache_ - head;
+		}
+		return ready < n ? ready : n;
+	}
+	template<class T, class Alloc>
+	template<class... Args>
+	bool spsc_queue<T, Alloc>::try_emplace(Args&&... args) {
+		size_t tail = tail_.load(std::memory_order_relaxed);
+		if (freeSlots(tail, 1) == 0) return false;
+		dataTraits::construct(this->get_alloc(), buf_ + (tail & mask_), std::forward<Args>(args)...);
+		tail_.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+	// pushes up to n elements from first and publishes them with one store
+	template<class T, class Alloc>
+	template<class InputIterator>
+	typename spsc_queue<T, Alloc>::size_type spsc_queue<T, Alloc>::try_push_n(InputIterator first, size_type n) {
+		size_t tail = tail_.load(std::memory_order_relaxed);
+		n = freeSlots(tail, n);
+		size_type i = 0;
+		try {
+			for (; i != n; ++i, ++first) {
+				dataTraits::construct(this->get_alloc(), buf_ + ((tail + i) & mask_), *first);
+			}
+		}
+		catch (...) {
+			while (i != 0) {
+				--i;
+				dataTraits::destroy(this->get_alloc(), buf_ + ((tail + i) & mask_));
+			}
+			throw;
+		}
+		tail_.store(tail + n, std::memory_order_release);
+		return n;
+	}
+	template<class T, class Alloc>
+	bool spsc_queue<T, Alloc>::try_pop(value_type& value) {
+		size_t head = head_.load(std::memory_order_relaxed);
+		if (readySlots(head, 1) == 0) return false;
+		T *p = buf_ + (head & mask_);
+		value = std::move(*p);
+		dataTraits::destroy(this->get_alloc(), p);
+		head_.store(head + 1, std::memory_order_release);
+		return true;
+	}
+	// pops up to n elements into out; if an assignment throws, the ones already taken stay taken
+	template<class T, class Alloc>
+	template<class OutputIterator>
+	typename spsc_queue<T, Alloc>::size_type spsc_queue<T, Alloc>::try_pop_n(OutputIterator out, size_type n) {
+		size_t head = head_.load(std::memory_order_relaxed);
+		n = readySlots(head, n);
+		size_type i = 0;
+		try {
+			for (; i != n; ++i, ++out) {
+				T *p = buf_ + ((head + i) & mask_);
+				*out = std::move(*p);
+				dataTraits::destroy(this->get_alloc(), p);
+			}
+		}
+		catch (...) {
+			head_.store(head + i, std::memory_order_release);
+			throw;
+		}
+		head_.store(head + n, std::memory_order_release);
+		return n;
+	}
+	template<class T, class Alloc>
+	typename spsc_queue<T, Alloc>::size_type spsc_queue<T, Alloc>::size() const {
+		size_t head = head_.load(std::memory_order_acquire);
+		size_t tail = tail_.load(std::memory_order_acquire);
+		return tail - head <= capacity() ? tail - head : 0;
+	}
+
+	/*
+	** Bounded multi-producer/multi-consumer ring with a sequence number per
+	** slot (D. Vyukov's design). A slot at position pos is free for the
+	** producer of pos when its sequence equals pos, and holds an element for
+	** the consumer of pos when it equals pos + 1; the consumer then sets it to
+	** pos + capacity for the next lap. Producers and consumers only contend on
+	** a CAS of their own index, each on its own cache line.
+	** try_push_n/try_pop_n claim a whole run of ready slots with one CAS; if
+	** writing to the output iterator of try_pop_n throws, the elements left in
+	** the claimed run are destroyed.
+	** Once a slot is claimed it must be published, so elements need a
+	** noexcept move constructor and move assignment; try_emplace builds the
+	** element before claiming a slot when its constructor may throw.
+	*/
+	template<class T, class Alloc = allocator<T> >
+	class mpmc_queue : private Detail::alloc_holder<Alloc> {
+		public:
+			typedef T value_type;
+			typedef size_t size_type;
+			typedef Alloc allocator_type;
+		private:
+			struct slot {
+				std::atomic<size_t> seq;
+				typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+				T *data() { return reinterpret_cast<T *>(&storage); }
+			};
+			typedef allocator_traits<Alloc> dataTraits;
+			typedef typename dataTraits::template rebind_alloc<slot> slotAllocator;
+			typedef allocator_traits<slotAllocator> slotTraits;
+			typedef Detail::alloc_holder<Alloc> holder;
+
+			static_assert(std::is_nothrow_move_constructible<T>::value && std::is_nothrow_move_assignable<T>::value,
+				"mpmc_queue needs elements with noexcept move construction and assignment");
+		private:
+			slot *slots_;
+			size_t mask_;
+			char pad0_[Detail::CACHE_LINE];
+			std::atomic<size_t> enqueuePos_;
+			char pad1_[Detail::CACHE_LINE];
+			std::atomic<size_t> dequeuePos_;
+			char pad2_[Detail::CACHE_LINE];
+		public:
+			explicit mpmc_queue(size_type capacity, const allocator_type& alloc = allocator_type());
+			mpmc_queue(const mpmc_queue&) = delete;
+			mpmc_queue& operator = (const mpmc_queue&) = delete;
+			~mpmc_queue();
+
+			bool try_push(const value_type& value) { return try_emplace(value); }
+			bool try_push(value_type&& value) { return try_emplace(std::move(value)); }
+			template<class... Args>
+			bool try_emplace(Args&&... args);
+			template<class InputIterator>
+			size_type try_push_n(InputIterator first, size_type n);
+
+			bool try_pop(value_type& value);
+			template<class OutputIterator>
+			size_type try_pop_n(OutputIterator out, size_type n);
+
+			// a snapshot; may be stale by the time it is returned
+			size_type size() const;
+			bool empty() const { return size() == 0; }
+			size_type capacity() const { return mask_ + 1; }
+			allocator_type get_allocator() const { return this->get_alloc(); }
+		private:
+			template<class... Args>
+			bool emplaceAux(std::true_type, Args&&... args);
+			template<class... Args>
+			bool emplaceAux(std::false_type, Args&&... args);
+			template<class InputIterator>
+			size_type pushAux(InputIterator first, size_type n, std::true_type);
+			template<class InputIterator>
+			size_type pushAux(InputIterator first, size_type n, std::false_type);
+			size_t claim(std::atomic<size_t>& pos, size_t lag, size_type n, size_type& claimed);
+	};
+
+	template<class T, class Alloc>
+	mpmc_queue<T, Alloc>::mpmc_queue(size_type capacity, const allocator_type& alloc)
+		:holder(alloc), slots_(0), mask_(Detail::ring_capacity(capacity) - 1), enqueuePos_(0), dequeuePos_(0) {
+		slotAllocator slotAlloc(this->get_alloc());
+		slots_ = slotTraits::allocate(slotAlloc, mask_ + 1);
+		for (size_t i = 0; i != mask_ + 1; ++i) {
+			new (&slots_[i].seq) std::atomic<size_t>(i);
+		}
+	}
+	template<class T, class Alloc>
+	mpmc_queue<T, Alloc>::~mpmc_queue() {
+		size_t tail = enqueuePos_.load(std::memory_order_relaxed);
+		for (size_t i = dequeuePos_.load(std::memory_order_relaxed); i != tail; ++i) {
+			dataTraits::destroy(this->get_alloc(), slots_[i & mask_].data());
+		}
+		slotAllocator slotAlloc(this->get_alloc());
+		slotTraits::deallocate(slotAlloc, slots_, mask_ + 1);
+	}
+	/*
+	** Claims up to n consecutive positions from pos whose slots have sequence
+	** position + lag (0 for producers, 1 for consumers). Returns the first
+	** position and sets claimed, which is 0 when the ring is full (or empty).
+	*/
+	template<class T, class Alloc>
+	size_t mpmc_queue<T, Alloc>::claim(std::atomic<size_t>& pos, size_t lag, size_type n, size_type& claimed) {
+		size_t first = pos.load(std::memory_order_relaxed);
+		for (;;) {
+			size_type k = 0;
+			for (; k != n; ++k) {
+				size_t seq = slots_[(first + k) & mask_].seq.load(std::memory_order_acquire);
+				if (seq != first + k + lag) break;
+			}
+			if (k == 0) {
+				// behind means another thread took first already: look again; otherwise full/empty
+				size_t seq = slots_[first & mask_].seq.load(std::memory_order_acquire);
+				if (static_cast<ptrdiff_t>(seq - (first + lag)) < 0) {
+					claimed = 0;
+					return first;
+				}
+				first = pos.load(std::memory_order_relaxed);
+				continue;
+			}
+			if (pos.compare_exchange_weak(first, first + k, std::memory_order_relaxed)) {
+				claimed = k;
+				return first;
+			}
+		}
+	}
+	template<class T, class Alloc>
+	template<class... Args>
+	bool mpmc_queue<T, Alloc>::try_emplace(Args&&... args) {
+		return emplaceAux(typename std::is_nothrow_constructible<T, Args&&...>::type(), std::forward<Args>(args)...);
+	}
+	template<class T, class Alloc>
+	template<class... Args>
+	bool mpmc_queue<T, Alloc>::emplaceAux(std::true_type, Args&&... args) {
+		size_type claimed;
+		size_t pos = claim(enqueuePos_, 0, 1, claimed);
+		if (claimed == 0) return false;
+		slot& s = slots_[pos & mask_];
+		dataTraits::construct(this->get_alloc(), s.data(), std::forward<Args>(args)...);
+		s.seq.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+	template<class T, class Alloc>
+	template<class... Args>
+	bool mpmc_queue<T, Alloc>::emplaceAux(std::false_type, Args&&... args) {
+		T value(std::forward<Args>(args)...);
+		return emplaceAux(std::true_type(), std::move(value));
+	}
+	template<class T, class Alloc>
+	template<class InputIterator>
+	typename mpmc_queue<T, Alloc>::size_type mpmc_queue<T, Alloc>::try_push_n(InputIterator first, size_type n) {
+		typedef typename std::is_nothrow_constructible<T, decltype(*first)>::type nothrow_copy;
+		return pushAux(first, n, nothrow_copy());
+	}
+	template<class T, class Alloc>
+	template<class InputIterator>
+	typename mpmc_queue<T, Alloc>::size_type mpmc_queue<T, Alloc>::pushAux(InputIterator first, size_type n, std::true_type) {
+		size_type pushed = 0;
+		while (pushed != n) {
+			size_type claimed;
+			size_t pos = claim(enqueuePos_, 0, n - pushed, claimed);
+			if (claimed == 0) break;
+			for (size_type i = 0; i != claimed; ++i, ++first) {
+				slot& s = slots_[(pos + i) & mask_];
+				dataTraits::construct(this->get_alloc(), s.data(), *first);
+				s.seq.store(pos + i + 1, std::memory_order_release);
+			}
+			pushed += claimed;
+		}
+		return pushed;
+	}
+	// a copy that may throw is made before its slot is claimed, so runs cannot be claimed at once
+	template<class T, class Alloc>
+	template<class InputIterator>
+	typename mpmc_queue<T, Alloc>::size_type mpmc_queue<T, Alloc>::pushAux(InputIterator first, size_type n, std::false_type) {
+		size_type pushed = 0;
+		for (; pushed != n; ++pushed, ++first) {
+			if (!emplaceAux(std::false_type(), *first)) break;
+		}
+		return pushed;
+	}
+	template<class T, class Alloc>
+	bool mpmc_queue<T, Alloc>::try_pop(value_type& value) {
+		size_type claimed;
+		size_t pos = claim(dequeuePos_, 1, 1, claimed);
+		if (claimed == 0) return false;
+		slot& s = slots_[pos & mask_];
+		value = std::move(*s.data());
+		dataTraits::destroy(this->get_alloc(), s.data());
+		s.seq.store(pos + mask_ + 1, std::memory_order_release);
+		return true;
+	}
+	template<class T, class Alloc>
+	template<class OutputIterator>
+	typename mpmc_queue<T, Alloc>::size_type mpmc_queue<T, Alloc>::try_pop_n(OutputIterator out, size_type n) {
+		size_type popped = 0;
+		while (popped != n) {
+			size_type claimed;
+			size_t pos = claim(dequeuePos_, 1, n - popped, claimed);
+			if (claimed == 0) break;
+			size_type i = 0;
+			try {
+				for (; i != claimed; ++i, ++out) {
+					slot& s = slots_[(pos + i) & mask_];
+					*out = std::move(*s.data());
+					dataTraits::destroy(this->get_alloc(), s.data());
+					s.seq.store(pos + i + mask_ + 1, std::memory_order_release);
+				}
+			}
+			catch (...) {
+				// the claimed slots have to be handed back, so the rest of the run is dropped
+				for (; i != claimed; ++i) {
+					slot& s = slots_[(pos + i) & mask_];
+					dataTraits::destroy(this->get_alloc(), s.data());
+					s.seq.store(pos + i + mask_ + 1, std::memory_order_release);
+				}
+				throw;
+			}
+			popped += claimed;
+		}
+		return popped;
+	}
+	template<class T, class Alloc>
+	typename mpmc_queue<T, Alloc>::size_type mpmc_queue<T, Alloc>::size() const {
+		size_t head = dequeuePos_.load(std::memory_order_acquire);
+		size_t tail = enqueuePos_.load(std::memory_order_acquire);
+		return tail - head <= capacity() ? tail - head : 0;
+	}
+} // namespace tinySTL
+
+#endif // _LOCK_FREE_QUEUE_H_
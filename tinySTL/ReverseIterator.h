@@ -8,11 +8,11 @@ namespace tinySTL {
 	class reverse_iterator_t {
 	public:
 		typedef Iterator iterator_type;
-		typedef typename iterator_traits<Iterator>::iterator_category iterator_category;
+		typedef typename Detail::without_contiguous<typename iterator_traits<Iterator>::iterator_category>::type iterator_category;
 		typedef typename iterator_traits<Iterator>::value_type value_type;
 		typedef typename iterator_traits<Iterator>::difference_type difference_type;
 		typedef typename iterator_traits<Iterator>::pointer pointer;
-		typedef const poiner const_pointer;
+		typedef const pointer const_pointer;
 		typedef typename iterator_traits<Iterator>::reference reference;
 		typedef const reference const_reference;
 
@@ -22,27 +22,30 @@ namespace tinySTL {
 
 	public:
 		// Constructor, copy, destructor
-		reverse_iterator_t() : base_(0), cur_(0) {}
+		reverse_iterator_t() : base_(), cur_() {}
 
 		explicit reverse_iterator_t(const iterator_type& it) : base_(it) {
 			auto temp = it;
 			cur_ = --temp;
 		}
 
-		templatte<class Iter>
-			reverse_iterator_t(const reverse_iterator_t<Iter>& rev_it) {
-			base_ = (iterator_type)rev_it.base_;
+		template<class Iter>
+		reverse_iterator_t(const reverse_iterator_t<Iter>& rev_it) {
+			base_ = (iterator_type)rev_it.base();
 			auto temp = base_;
 			cur_ = --temp;
 		};
 
 		// other methods
-		iterator_type base() { return base_; }
+		iterator_type base() const { return base_; }
 		reference operator*() { return *cur_; }
 		const_reference operator*() const { return *cur_; }
 		pointer operator->() {
 			return &(operator*());
 		}
+		const_pointer operator->() const {
+			return &(operator*());
+		}
 		reverse_iterator_t& operator++() {
 			--base_;
 			--cur_;
@@ -64,7 +67,7 @@ namespace tinySTL {
 			return temp;
 		}
 
-		reference operator[] (difference_type n) {
+		reference operator[] (difference_type n) const {
 			return base()[-n - 1];
 		}
 		reverse_iterator_t operator + (difference_type n) const;
@@ -88,40 +91,37 @@ namespace tinySTL {
 			difference_type absN = n >= 0 ? n : -n;
 			if ((right && n >= 0) || (!right && n < 0)) {
 				for (i = 0; i < absN; ++i) {
-					it = it + 1;
+					++it;
 				}
 			}
 			else if ((right && n < 0) || (!right && n >= 0)) {
 				for (i = 0; i < absN; ++i) {
-					it = it - 1;
+					--it;
 				}
 			}
 			return it;
 		}
 	public:
-		template<class Iterator>
-		friend bool operator == (const reverse_iterator_t<Iterator>& lhs, const reverse_iterator_t<Iterator>& rhs);
-
-		template<class Iterator>
-		friend bool operator != (const reverse_iterator_t<Iterator>& lhs, const reverse_iterator_t<Iterator>& rhs);
+		template<class Iter>
+		friend bool operator == (const reverse_iterator_t<Iter>& lhs, const reverse_iterator_t<Iter>& rhs);
 
-		template<class Iterator>
-		friend bool operator < (const reverse_iterator_t<Iterator>& lhs, const reverse_iterator_t<Iterator>& rhs);
+		template<class Iter>
+		friend bool operator != (const reverse_iterator_t<Iter>& lhs, const reverse_iterator_t<Iter>& rhs);
 
-		template<class Iterator>
-		friend bool operator > (const reverse_iterator_t<Iterator>& lhs, const reverse_iterator_t<Iterator>& rhs);
+		template<class Iter>
+		friend bool operator < (const reverse_iterator_t<Iter>& lhs, const reverse_iterator_t<Iter>& rhs);
 
-		template<class Iterator>
-		friend bool operator <= (const reverse_iterator_t<Iterator>& lhs, const reverse_iterator_t<Iterator>& rhs);
+		template<class Iter>
+		friend bool operator > (const reverse_iterator_t<Iter>& lhs, const reverse_iterator_t<Iter>& rhs);
 
-		template<class Iterator>
-		friend bool operator >= (const reverse_iterator_t<Iterator>& lhs, const reverse_iterator_t<Iterator>& rhs);
+		template<class Iter>
+		friend bool operator <= (const reverse_iterator_t<Iter>& lhs, const reverse_iterator_t<Iter>& rhs);
 
-		template<class Iterator>
-		friend difference_type operator - (const reverse_iterator_t<Iterator>& lhs, const reverse_iterator_t<Iterator>& rhs);
+		template<class Iter>
+		friend bool operator >= (const reverse_iterator_t<Iter>& lhs, const reverse_iterator_t<Iter>& rhs);
 
-		template<class Iterator>
-		friend reverse_iterator_t<Iterator> operator + (difference_type n, const reverse_iterator_t<Iterator>& it);
+		template<class Iter>
+		friend typename reverse_iterator_t<Iter>::difference_type operator - (const reverse_iterator_t<Iter>& lhs, const reverse_iterator_t<Iter>& rhs);
 	}; // class reverse_iterator_t
 
 	template<class Iterator>
@@ -136,17 +136,20 @@ namespace tinySTL {
 		cur_ = advanceNStep(cur_, n, true, iterator_category());
 		return *this;
 	}
-	reverse_iterator_t<Iterator> revers_iterator_t<Iterator>::operator + (difference_type n) const {
+	template<class Iterator>
+	reverse_iterator_t<Iterator> reverse_iterator_t<Iterator>::operator + (difference_type n) const {
 		reverse_iterator_t temp = *this;
 		temp += n;
 		return temp;
 	}
+	template<class Iterator>
 	reverse_iterator_t<Iterator> reverse_iterator_t<Iterator>::operator - (difference_type n) const {
 		reverse_iterator_t temp = *this;
 		temp -= n;
 		return temp;
 	}
 
+	// a reverse iterator is ahead of another when its cur_ is behind
 	template<class Iterator>
 	bool operator == (const reverse_iterator_t<Iterator>& lhs, const reverse_iterator_t<Iterator>& rhs) {
 		return lhs.cur_ == rhs.cur_;
@@ -157,42 +160,29 @@ namespace tinySTL {
 	}
 	template<class Iterator>
 	bool operator < (const reverse_iterator_t<Iterator>& lhs, const reverse_iterator_t<Iterator>& rhs) {
-		return lhs.cur_ < rhs.cur_;
+		return rhs.cur_ < lhs.cur_;
 	}
 	template<class Iterator>
 	bool operator > (const reverse_iterator_t<Iterator>& lhs, const reverse_iterator_t<Iterator>& rhs) {
-		return lhs.cur_ > rhs.cur_;
+		return rhs.cur_ > lhs.cur_;
 	}
 	template<class Iterator>
 	bool operator <= (const reverse_iterator_t<Iterator>& lhs, const reverse_iterator_t<Iterator>& rhs) {
-		return lhs.cur_ <= rhs.cur_;
+		return rhs.cur_ <= lhs.cur_;
 	}
 	template<class Iterator>
 	bool operator >= (const reverse_iterator_t<Iterator>& lhs, const reverse_iterator_t<Iterator>& rhs) {
-		return lhs.cur_ >= rhs.cur_;
+		return rhs.cur_ >= lhs.cur_;
 	}
 
 	template<class Iterator>
 	typename reverse_iterator_t<Iterator>::difference_type operator - (const reverse_iterator_t<Iterator>& lhs, const reverse_iterator_t<Iterator>& rhs) {
-		return lhs.cur_ - rhs.cur_;
+		return rhs.cur_ - lhs.cur_;
 	}
 	template<class Iterator>
-	reverse_iterator_t<Iterator> operator + (difference_type n, const reverse_iterator_t<Iterator>& it) {
+	reverse_iterator_t<Iterator> operator + (typename reverse_iterator_t<Iterator>::difference_type n, const reverse_iterator_t<Iterator>& it) {
 		return it + n;
 	}
 } // namespace tinySTL
 
-#endif // !
-
-
-
-
-
-
-
-
-
-
-
-
-
+#endif // _REVERSE_ITERATOR_H_
@@ -0,0 +1,346 @@
+#ifndef _SIMD_H_
+#define _SIMD_H_
+
+#include <cstddef>
+#include <type_traits>
+
+/*
+** TINYSTL_SSE2 is on wherever SSE2 is part of the target (every x64
+** build). AVX2 code is compiled in whenever the compiler can emit it and
+** is only run after simd_level() has found it on the CPU. Either can be
+** turned off by defining it to 0.
+*/
+#ifndef TINYSTL_SSE2
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TINYSTL_SSE2 1
+#else
+#define TINYSTL_SSE2 0
+#endif
+#endif
+#ifndef TINYSTL_AVX2
+#if TINYSTL_SSE2 && (defined(__GNUC__) || (defined(_MSC_VER) && _MSC_VER >= 1800))
+#define TINYSTL_AVX2 1
+#else
+#define TINYSTL_AVX2 0
+#endif
+#endif
+
+#if TINYSTL_SSE2
+#include <emmintrin.h>
+#endif
+#if TINYSTL_AVX2
+#include <immintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// gcc and clang only emit AVX2 instructions in functions marked for it; MSVC always can
+#if TINYSTL_AVX2 && defined(__GNUC__)
+#define TINYSTL_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TINYSTL_TARGET_AVX2
+#endif
+
+namespace tinySTL {
+	namespace Detail {
+		inline unsigned count_trailing_zeros(unsigned long long x) {
+#if defined(_MSC_VER) && defined(_WIN64)
+			unsigned long index;
+			_BitScanForward64(&index, x);
+			return index;
+#elif defined(_MSC_VER)
+			unsigned long index;
+			if (_BitScanForward(&index, static_cast<unsigned long>(x))) return index;
+			_BitScanForward(&index, static_cast<unsigned long>(x >> 32));
+			return index + 32;
+#else
+			return __builtin_ctzll(x);
+#endif
+		}
+
+		// POPCNT is not part of SSE2, so count the bits by hand
+		inline unsigned popcount32(unsigned x) {
+			x = x - ((x >> 1) & 0x55555555u);
+			x = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+			x = (x + (x >> 4)) & 0x0F0F0F0Fu;
+			return (x * 0x01010101u) >> 24;
+		}
+
+		enum ESimdLevel{ SIMD_NONE, SIMD_SSE2, SIMD_AVX2 };
+
+		inline int detect_simd_level() {
+#if TINYSTL_AVX2 && defined(_MSC_VER)
+			int info[4];
+			__cpuid(info, 0);
+			if (info[0] >= 7) {
+				__cpuid(info, 1);
+				// the OS must save the ymm registers too (OSXSAVE, then XCR0 bits 1 and 2)
+				const bool avx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0;
+				if (avx && (_xgetbv(0) & 6) == 6) {
+					__cpuidex(info, 7, 0);
+					if (info[1] & (1 << 5)) return SIMD_AVX2;
+				}
+			}
+#elif TINYSTL_AVX2
+			__builtin_cpu_init();
+			if (__builtin_cpu_supports("avx2")) return SIMD_AVX2;
+#endif
+			return TINYSTL_SSE2 ? SIMD_SSE2 : SIMD_NONE;
+		}
+		// asks the CPU once per process
+		inline int simd_level() {
+			static const int level = detect_simd_level();
+			return level;
+		}
+
+		// lane tags: the width of an integer lane, or the floating type of the lane
+		template<size_t Bytes>
+		struct int_lane {};
+		template<class F>
+		struct float_lane {};
+
+		template<class T, bool = std::is_integral<T>::value>
+		struct simd_lane {
+			typedef float_lane<T> type;
+		};
+		template<class T>
+		struct simd_lane<T, true> {
+			typedef int_lane<sizeof(T)> type;
+		};
+
+		// what the kernels take: integers of 1, 2, 4 or 8 bytes, float and double
+		template<class T, class U = typename std::remove_cv<T>::type>
+		struct simd_element : std::integral_constant<bool, TINYSTL_SSE2 && !std::is_volatile<T>::value
+			&& ((std::is_integral<U>::value && (sizeof(U) == 1 || sizeof(U) == 2 || sizeof(U) == 4 || sizeof(U) == 8))
+			|| std::is_same<U, float>::value || std::is_same<U, double>::value)> {};
+
+		template<class T>
+		size_t scalar_find(const T *p, size_t n, T value) {
+			size_t i = 0;
+			for (; i != n; ++i) {
+				if (p[i] == value) break;
+			}
+			return i;
+		}
+		template<class T>
+		size_t scalar_count(const T *p, size_t n, T value) {
+			size_t count = 0;
+			for (size_t i = 0; i != n; ++i) {
+				count += p[i] == value;
+			}
+			return count;
+		}
+		template<class T>
+		size_t scalar_mismatch(const T *a, const T *b, size_t n) {
+			size_t i = 0;
+			for (; i != n; ++i) {
+				if (!(a[i] == b[i])) break;
+			}
+			return i;
+		}
+		template<class T>
+		void scalar_fill(T *p, size_t n, T value) {
+			for (size_t i = 0; i != n; ++i) {
+				p[i] = value;
+			}
+		}
+		// the smallest (Max: largest) of n != 0 elements
+		template<class T, bool Max>
+		T scalar_extreme(const T *p, size_t n) {
+			T best = p[0];
+			for (size_t i = 1; i != n; ++i) {
+				if (Max ? best < p[i] : p[i] < best) best = p[i];
+			}
+			return best;
+		}
+
+#if TINYSTL_SSE2
+		// whole 16 byte registers; float lanes travel as integer vectors and are cast for the compare
+		struct sse2_ops {
+			typedef __m128i vec;
+			enum EBytes{ BYTES = 16 };
+
+			static unsigned full_mask() { return 0xFFFFu; }
+			static vec load(const void *p) { return _mm_loadu_si128(static_cast<const __m128i *>(p)); }
+			static void store(void *p, vec v) { _mm_storeu_si128(static_cast<__m128i *>(p), v); }
+			// one bit per byte: the top bit of each
+			static unsigned mask(vec v) { return static_cast<unsigned>(_mm_movemask_epi8(v)); }
+			// m ? a : b, lane by lane
+			static vec select(vec m, vec a, vec b) { return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b)); }
+			static vec bit_xor(vec a, vec b) { return _mm_xor_si128(a, b); }
+
+			template<class T>
+			static vec splat(T x, int_lane<1>) { return _mm_set1_epi8(static_cast<char>(x)); }
+			template<class T>
+			static vec splat(T x, int_lane<2>) { return _mm_set1_epi16(static_cast<short>(x)); }
+			template<class T>
+			static vec splat(T x, int_lane<4>) { return _mm_set1_epi32(static_cast<int>(x)); }
+			template<class T>
+			static vec splat(T x, int_lane<8>) { return _mm_set1_epi64x(static_cast<long long>(x)); }
+			static vec splat(float x, float_lane<float>) { return _mm_castps_si128(_mm_set1_ps(x)); }
+			static vec splat(double x, float_lane<double>) { return _mm_castpd_si128(_mm_set1_pd(x)); }
+
+			static vec eq(vec a, vec b, int_lane<1>) { return _mm_cmpeq_epi8(a, b); }
+			static vec eq(vec a, vec b, int_lane<2>) { return _mm_cmpeq_epi16(a, b); }
+			static vec eq(vec a, vec b, int_lane<4>) { return _mm_cmpeq_epi32(a, b); }
+			// no 64 bit compare before SSE4.1: both halves must match
+			static vec eq(vec a, vec b, int_lane<8>) {
+				vec e = _mm_cmpeq_epi32(a, b);
+				return _mm_and_si128(e, _mm_shuffle_epi32(e, _MM_SHUFFLE(2, 3, 0, 1)));
+			}
+			static vec eq(vec a, vec b, float_lane<float>) {
+				return _mm_castps_si128(_mm_cmpeq_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b)));
+			}
+			static vec eq(vec a, vec b, float_lane<double>) {
+				return _mm_castpd_si128(_mm_cmpeq_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b)));
+			}
+
+			// signed a > b
+			static vec gt(vec a, vec b, int_lane<1>) { return _mm_cmpgt_epi8(a, b); }
+			static vec gt(vec a, vec b, int_lane<2>) { return _mm_cmpgt_epi16(a, b); }
+			static vec gt(vec a, vec b, int_lane<4>) { return _mm_cmpgt_epi32(a, b); }
+			// the high halves decide, signed; if they are equal the low halves do, unsigned
+			static vec gt(vec a, vec b, int_lane<8>) {
+				const vec bias = _mm_set1_epi32(static_cast<int>(0x80000000u));
+				vec high = _mm_cmpgt_epi32(a, b);
+				vec same = _mm_cmpeq_epi32(a, b);
+				vec low = _mm_cmpgt_epi32(_mm_xor_si128(a, bias), _mm_xor_si128(b, bias));
+				vec r = _mm_or_si128(high, _mm_and_si128(same, _mm_shuffle_epi32(low, _MM_SHUFFLE(2, 2, 0, 0))));
+				return _mm_shuffle_epi32(r, _MM_SHUFFLE(3, 3, 1, 1));
+			}
+		};
+#endif
+#if TINYSTL_AVX2
+		struct avx2_ops {
+			typedef __m256i vec;
+			enum EBytes{ BYTES = 32 };
+
+			TINYSTL_TARGET_AVX2 static unsigned full_mask() { return 0xFFFFFFFFu; }
+			TINYSTL_TARGET_AVX2 static vec load(const void *p) { return _mm256_loadu_si256(static_cast<const __m256i *>(p)); }
+			TINYSTL_TARGET_AVX2 static void store(void *p, vec v) { _mm256_storeu_si256(static_cast<__m256i *>(p), v); }
+			TINYSTL_TARGET_AVX2 static unsigned mask(vec v) { return static_cast<unsigned>(_mm256_movemask_epi8(v)); }
+			TINYSTL_TARGET_AVX2 static vec select(vec m, vec a, vec b) { return _mm256_blendv_epi8(b, a, m); }
+			TINYSTL_TARGET_AVX2 static vec bit_xor(vec a, vec b) { return _mm256_xor_si256(a, b); }
+
+			template<class T>
+			TINYSTL_TARGET_AVX2 static vec splat(T x, int_lane<1>) { return _mm256_set1_epi8(static_cast<char>(x)); }
+			template<class T>
+			TINYSTL_TARGET_AVX2 static vec splat(T x, int_lane<2>) { return _mm256_set1_epi16(static_cast<short>(x)); }
+			template<class T>
+			TINYSTL_TARGET_AVX2 static vec splat(T x, int_lane<4>) { return _mm256_set1_epi32(static_cast<int>(x)); }
+			template<class T>
+			TINYSTL_TARGET_AVX2 static vec splat(T x, int_lane<8>) { return _mm256_set1_epi64x(static_cast<long long>(x)); }
+			TINYSTL_TARGET_AVX2 static vec splat(float x, float_lane<float>) { return _mm256_castps_si256(_mm256_set1_ps(x)); }
+			TINYSTL_TARGET_AVX2 static vec splat(double x, float_lane<double>) { return _mm256_castpd_si256(_mm256_set1_pd(x)); }
+
+			TINYSTL_TARGET_AVX2 static vec eq(vec a, vec b, int_lane<1>) { return _mm256_cmpeq_epi8(a, b); }
+			TINYSTL_TARGET_AVX2 static vec eq(vec a, vec b, int_lane<2>) { return _mm256_cmpeq_epi16(a, b); }
+			TINYSTL_TARGET_AVX2 static vec eq(vec a, vec b, int_lane<4>) { return _mm256_cmpeq_epi32(a, b); }
+			TINYSTL_TARGET_AVX2 static vec eq(vec a, vec b, int_lane<8>) { return _mm256_cmpeq_epi64(a, b); }
+			TINYSTL_TARGET_AVX2 static vec eq(vec a, vec b, float_lane<float>) {
+				return _mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _CMP_EQ_OQ));
+			}
+			TINYSTL_TARGET_AVX2 static vec eq(vec a, vec b, float_lane<double>) {
+				return _mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b), _CMP_EQ_OQ));
+			}
+
+			TINYSTL_TARGET_AVX2 static vec gt(vec a, vec b, int_lane<1>) { return _mm256_cmpgt_epi8(a, b); }
+			TINYSTL_TARGET_AVX2 static vec gt(vec a, vec b, int_lane<2>) { return _mm256_cmpgt_epi16(a, b); }
+			TINYSTL_TARGET_AVX2 static vec gt(vec a, vec b, int_lane<4>) { return _mm256_cmpgt_epi32(a, b); }
+			TINYSTL_TARGET_AVX2 static vec gt(vec a, vec b, int_lane<8>) { return _mm256_cmpgt_epi64(a, b); }
+		};
+#endif
+	}// namespace Detail
+}// namespace tinySTL
+
+#if TINYSTL_SSE2
+#define TINYSTL_SIMD_NS simd_sse2
+#define TINYSTL_SIMD_OPS sse2_ops
+#define TINYSTL_SIMD_TARGET
+#include "SimdKernels.h"
+#undef TINYSTL_SIMD_NS
+#undef TINYSTL_SIMD_OPS
+#undef TINYSTL_SIMD_TARGET
+#endif
+#if TINYSTL_AVX2
+#define TINYSTL_SIMD_NS simd_avx2
+#define TINYSTL_SIMD_OPS avx2_ops
+#define TINYSTL_SIMD_TARGET TINYSTL_TARGET_AVX2
+#include "SimdKernels.h"
+#undef TINYSTL_SIMD_NS
+#undef TINYSTL_SIMD_OPS
+#undef TINYSTL_SIMD_TARGET
+#endif
+
+namespace tinySTL {
+	namespace Detail {
+		/*
+		** The entry points: the widest kernel the CPU runs. T is one of the
+		** simd_element types without cv; without SSE2 they are plain loops.
+		*/
+		// index of the first element equal to value, n if none
+		template<class T>
+		size_t simd_find(const T *p, size_t n, T value) {
+#if TINYSTL_AVX2
+			if (simd_level() == SIMD_AVX2) return simd_avx2::find_index(p, n, value);
+#endif
+#if TINYSTL_SSE2
+			return simd_sse2::find_index(p, n, value);
+#else
+			return scalar_find(p, n, value);
+#endif
+		}
+		template<class T>
+		size_t simd_count(const T *p, size_t n, T value) {
+#if TINYSTL_AVX2
+			if (simd_level() == SIMD_AVX2) return simd_avx2::count_equal(p, n, value);
+#endif
+#if TINYSTL_SSE2
+			return simd_sse2::count_equal(p, n, value);
+#else
+			return scalar_count(p, n, value);
+#endif
+		}
+		// index of the first i with !(a[i] == b[i]), n if none
+		template<class T>
+		size_t simd_mismatch(const T *a, const T *b, size_t n) {
+#if TINYSTL_AVX2
+			if (simd_level() == SIMD_AVX2) return simd_avx2::mismatch_index(a, b, n);
+#endif
+#if TINYSTL_SSE2
+			return simd_sse2::mismatch_index(a, b, n);
+#else
+			return scalar_mismatch(a, b, n);
+#endif
+		}
+		template<class T>
+		void simd_fill(T *p, size_t n, T value) {
+#if TINYSTL_AVX2
+			if (simd_level() == SIMD_AVX2) {
+				simd_avx2::fill_value(p, n, value);
+				return;
+			}
+#endif
+#if TINYSTL_SSE2
+			simd_sse2::fill_value(p, n, value);
+#else
+			scalar_fill(p, n, value);
+#endif
+		}
+		// index of the first smallest (Max: largest) of n != 0 integers
+		template<class T, bool Max>
+		size_t simd_extreme(const T *p, size_t n) {
+#if TINYSTL_AVX2
+			if (simd_level() == SIMD_AVX2) return simd_avx2::extreme_index<T, Max>(p, n);
+#endif
+#if TINYSTL_SSE2
+			return simd_sse2::extreme_index<T, Max>(p, n);
+#else
+			return scalar_find(p, n, scalar_extreme<T, Max>(p, n));
+#endif
+		}
+	}// namespace Detail
+}// namespace tinySTL
+
+#endif // _SIMD_H_
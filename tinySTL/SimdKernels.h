@@ -0,0 +1,126 @@
+// No include guard: Simd.h includes this once per instruction set, with
+//   TINYSTL_SIMD_NS      the namespace of this copy of the kernels
+//   TINYSTL_SIMD_OPS     the vector operations they are written in
+//   TINYSTL_SIMD_TARGET  what the compiler needs to emit those operations
+
+namespace tinySTL {
+	namespace Detail {
+		namespace TINYSTL_SIMD_NS {
+			typedef TINYSTL_SIMD_OPS ops;
+
+			/*
+			** Each kernel walks whole vectors and then finishes with one vector
+			** that ends at the last element and overlaps the ones already seen,
+			** so only ranges shorter than a vector take the scalar loop.
+			*/
+			template<class T>
+			TINYSTL_SIMD_TARGET size_t find_index(const T *p, size_t n, T value) {
+				typedef typename simd_lane<T>::type lane;
+				const size_t step = ops::BYTES / sizeof(T);
+				if (n < step) return scalar_find(p, n, value);
+				const typename ops::vec v = ops::splat(value, lane());
+				size_t i = 0;
+				for (; i + step <= n; i += step) {
+					unsigned m = ops::mask(ops::eq(ops::load(p + i), v, lane()));
+					if (m != 0) return i + count_trailing_zeros(m) / sizeof(T);
+				}
+				if (i != n) {
+					// nothing before i matched, so the first match in the last vector is the answer
+					i = n - step;
+					unsigned m = ops::mask(ops::eq(ops::load(p + i), v, lane()));
+					if (m != 0) return i + count_trailing_zeros(m) / sizeof(T);
+				}
+				return n;
+			}
+
+			template<class T>
+			TINYSTL_SIMD_TARGET size_t count_equal(const T *p, size_t n, T value) {
+				typedef typename simd_lane<T>::type lane;
+				const size_t step = ops::BYTES / sizeof(T);
+				if (n < step) return scalar_count(p, n, value);
+				const typename ops::vec v = ops::splat(value, lane());
+				size_t bits = 0, i = 0;
+				for (; i + step <= n; i += step) {
+					bits += popcount32(ops::mask(ops::eq(ops::load(p + i), v, lane())));
+				}
+				if (i != n) {
+					// the last vector less the elements already counted
+					unsigned m = ops::mask(ops::eq(ops::load(p + n - step), v, lane()));
+					bits += popcount32(m >> ((i - (n - step)) * sizeof(T)));
+				}
+				return bits / sizeof(T);
+			}
+
+			template<class T>
+			TINYSTL_SIMD_TARGET size_t mismatch_index(const T *a, const T *b, size_t n) {
+				typedef typename simd_lane<T>::type lane;
+				const size_t step = ops::BYTES / sizeof(T);
+				if (n < step) return scalar_mismatch(a, b, n);
+				const unsigned full = ops::full_mask();
+				size_t i = 0;
+				for (; i + step <= n; i += step) {
+					unsigned m = ops::mask(ops::eq(ops::load(a + i), ops::load(b + i), lane()));
+					if (m != full) return i + count_trailing_zeros(~m) / sizeof(T);
+				}
+				if (i != n) {
+					i = n - step;
+					unsigned m = ops::mask(ops::eq(ops::load(a + i), ops::load(b + i), lane()));
+					if (m != full) return i + count_trailing_zeros(~m) / sizeof(T);
+				}
+				return n;
+			}
+
+			template<class T>
+			TINYSTL_SIMD_TARGET void fill_value(T *p, size_t n, T value) {
+				typedef typename simd_lane<T>::type lane;
+				const size_t step = ops::BYTES / sizeof(T);
+				if (n < step) {
+					scalar_fill(p, n, value);
+					return;
+				}
+				const typename ops::vec v = ops::splat(value, lane());
+				size_t i = 0;
+				for (; i + step <= n; i += step) {
+					ops::store(p + i, v);
+				}
+				if (i != n) {
+					ops::store(p + n - step, v);
+				}
+			}
+
+			// b is better than a: smaller, or larger for Max; unsigned lanes are compared with their top bits flipped
+			template<class Lane>
+			TINYSTL_SIMD_TARGET typename ops::vec better(typename ops::vec a, typename ops::vec b, typename ops::vec bias, std::false_type) {
+				return ops::gt(ops::bit_xor(a, bias), ops::bit_xor(b, bias), Lane());
+			}
+			template<class Lane>
+			TINYSTL_SIMD_TARGET typename ops::vec better(typename ops::vec a, typename ops::vec b, typename ops::vec bias, std::true_type) {
+				return ops::gt(ops::bit_xor(b, bias), ops::bit_xor(a, bias), Lane());
+			}
+
+			// first the value, lane by lane, then the first place it occurs; n != 0, T integral
+			template<class T, bool Max>
+			TINYSTL_SIMD_TARGET size_t extreme_index(const T *p, size_t n) {
+				typedef typename simd_lane<T>::type lane;
+				typedef std::integral_constant<bool, Max> is_max;
+				const size_t step = ops::BYTES / sizeof(T);
+				if (n < step) return scalar_find(p, n, scalar_extreme<T, Max>(p, n));
+				const unsigned long long sign = std::is_signed<T>::value ? 0 : 1ull << (8 * sizeof(T) - 1);
+				const typename ops::vec bias = ops::splat(sign, lane());
+				typename ops::vec best = ops::load(p);
+				size_t i = step;
+				for (; i + step <= n; i += step) {
+					typename ops::vec x = ops::load(p + i);
+					best = ops::select(better<lane>(best, x, bias, is_max()), x, best);
+				}
+				if (i != n) {
+					typename ops::vec x = ops::load(p + n - step);
+					best = ops::select(better<lane>(best, x, bias, is_max()), x, best);
+				}
+				T lanes[ops::BYTES / sizeof(T)];
+				ops::store(lanes, best);
+				return find_index(p, n, scalar_extreme<T, Max>(lanes, step));
+			}
+		}// namespace TINYSTL_SIMD_NS
+	}// namespace Detail
+}// namespace tinySTL
@@ -0,0 +1,30 @@
+#include "Test.h"
+#include "../Allocator.h"
+
+namespace tinySTL {
+	namespace Test {
+		namespace {
+			// a zero-byte request is the smallest class, not index SIZE_MAX
+			void testZeroBytes() {
+				typedef alloc::size_class_type classes;
+				TINYSTL_CHECK(classes::index(0) == 0);
+				for (size_t bytes = 1; bytes <= classes::SMALL_BYTES; ++bytes) {
+					TINYSTL_CHECK(classes::index(bytes) == (bytes + classes::ALIGN - 1) / classes::ALIGN - 1);
+				}
+				void *p = alloc::allocate(0);
+				TINYSTL_CHECK(p != 0);
+				alloc::deallocate(p, 0);
+				TINYSTL_CHECK(alloc::allocate(1) == p);
+				alloc::deallocate(p, 1);
+
+				int *q = allocator<int>::allocate(0);
+				TINYSTL_CHECK(q == 0);
+				allocator<int>::deallocate(q, 0);
+			}
+		}
+
+		void testAlloc() {
+			testZeroBytes();
+		}
+	}// namespace Test
+}
@@ -0,0 +1,39 @@
+#include "Test.h"
+#include "../BTree.h"
+
+namespace tinySTL {
+	namespace Test {
+		namespace {
+			// ascending inserts split on the append path, which must leave every internal node a key
+			void testAppendThenEraseTail() {
+				btree_set<int> s;
+				for (int i = 0; i < 1121; ++i) s.insert(i);
+				s.erase(1120);
+				TINYSTL_CHECK(s.size() == 1120);
+				for (int i = 1119; i >= 0; --i) {
+					TINYSTL_CHECK(*--s.end() == i);
+					s.erase(--s.end());
+				}
+				TINYSTL_CHECK(s.empty());
+			}
+			void testBulkLoadThenEraseRange() {
+				const int n = 100000;
+				btree_map<int, int> m;
+				for (int i = 0; i < n; ++i) m.insert(make_pair(i, -i));
+				btree_map<int, int> copy(m);
+				copy.erase(copy.find(n / 3), copy.end());
+				TINYSTL_CHECK(copy.size() == static_cast<size_t>(n / 3));
+				for (int i = 0; i < n / 3; i += 2) copy.erase(i);
+				TINYSTL_CHECK(copy.size() == static_cast<size_t>(n / 3 / 2));
+				TINYSTL_CHECK(copy.find(1)->second == -1 && copy.find(2) == copy.end());
+				m.erase(m.begin(), m.end());
+				TINYSTL_CHECK(m.empty());
+			}
+		}
+
+		void testBTree() {
+			testAppendThenEraseTail();
+			testBulkLoadThenEraseRange();
+		}
+	}// namespace Test
+}
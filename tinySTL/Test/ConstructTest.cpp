@@ -0,0 +1,88 @@
+#include "Test.h"
+#include "../Construct.h"
+#include "../Deque.h"
+#include "../UninitializedFunctions.h"
+
+#include <iterator>
+#include <string>
+#include <type_traits>
+
+namespace tinySTL {
+	namespace Test {
+		namespace {
+			int destroyed = 0;
+
+			struct counted {
+				~counted() { ++destroyed; }
+			};
+
+			// a range of ints that cannot be walked: destroy compiles only if it never tries
+			struct untouchable_iterator {
+				typedef forward_iterator_tag iterator_category;
+				typedef int value_type;
+				typedef ptrdiff_t difference_type;
+				typedef int *pointer;
+				typedef int& reference;
+				untouchable_iterator& operator++() = delete;
+				int& operator*() const = delete;
+				bool operator==(const untouchable_iterator&) const = delete;
+				bool operator!=(const untouchable_iterator&) const = delete;
+			};
+
+			// the dispatch asks the element type, whatever iterates over it
+			static_assert(std::is_same<range_destructor_traits<int*>::has_trivial_destructor, _true_type>::value, "");
+			static_assert(std::is_same<range_destructor_traits<const double*>::has_trivial_destructor, _true_type>::value, "");
+			static_assert(std::is_same<range_destructor_traits<deque<int>::iterator>::has_trivial_destructor, _true_type>::value, "");
+			static_assert(std::is_same<range_destructor_traits<untouchable_iterator>::has_trivial_destructor, _true_type>::value, "");
+			static_assert(std::is_same<range_destructor_traits<counted*>::has_trivial_destructor, _false_type>::value, "");
+			static_assert(std::is_same<range_destructor_traits<std::string*>::has_trivial_destructor, _false_type>::value, "");
+			static_assert(std::is_same<range_destructor_traits<deque<std::string>::iterator>::has_trivial_destructor, _false_type>::value, "");
+
+			// copying is trivial, moving is not: only the copies may be a memmove
+			struct move_marks {
+				int v;
+				explicit move_marks(int x) : v(x) {}
+				move_marks(const move_marks&) = default;
+				move_marks(move_marks&& o) noexcept : v(o.v) { o.v = -1; }
+			};
+			struct no_move {
+				no_move(const no_move&) = default;
+				no_move(no_move&&) = delete;
+			};
+
+			static_assert(Detail::is_memmove_range<const move_marks*, move_marks*>::value, "");
+			static_assert(Detail::is_memmove_range<move_marks*, move_marks*>::value, "");
+			static_assert(!Detail::is_memmove_range<std::move_iterator<move_marks*>, move_marks*>::value, "");
+			static_assert(!Detail::is_memmove_range<std::move_iterator<no_move*>, no_move*>::value, "");
+			static_assert(Detail::is_memmove_range<std::move_iterator<int*>, int*>::value, "");
+
+			void testTrivialRangeIsNothing() {
+				tinySTL::destroy(untouchable_iterator(), untouchable_iterator());
+			}
+			void testPointerRangeRunsDestructors() {
+				std::aligned_storage<sizeof(counted), alignof(counted)>::type buf[5];
+				counted *p = reinterpret_cast<counted*>(buf);
+				for (int i = 0; i != 5; ++i) new (static_cast<void*>(p + i)) counted();
+				destroyed = 0;
+				tinySTL::destroy(p, p + 5);
+				TINYSTL_CHECK(destroyed == 5);
+			}
+			void testMoveRunsMoveConstructor() {
+				move_marks src[2] = { move_marks(1), move_marks(2) };
+				std::aligned_storage<sizeof(move_marks), alignof(move_marks)>::type buf[2];
+				move_marks *dst = reinterpret_cast<move_marks*>(buf);
+				tinySTL::uninitialized_copy(std::make_move_iterator(src), std::make_move_iterator(src + 2), dst);
+				TINYSTL_CHECK(dst[0].v == 1 && dst[1].v == 2);
+				TINYSTL_CHECK(src[0].v == -1 && src[1].v == -1);
+				tinySTL::uninitialized_copy(static_cast<const move_marks*>(dst), static_cast<const move_marks*>(dst + 2), src);
+				TINYSTL_CHECK(src[0].v == 1 && src[1].v == 2 && dst[0].v == 1);
+			}
+		}
+
+		void testConstruct() {
+			testTrivialRangeIsNothing();
+			testPointerRangeRunsDestructors();
+			testMoveRunsMoveConstructor();
+		}
+	}// namespace Test
+}
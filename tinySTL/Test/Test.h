@@ -0,0 +1,20 @@
+#ifndef _TEST_H_
+#define _TEST_H_
+
+#include <cstdio>
+#include <cstdlib>
+
+// unlike assert, still checked in release builds
+#define TINYSTL_CHECK(expr) \
+	((expr) ? (void)0 : (fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr), abort()))
+
+namespace tinySTL {
+	namespace Test {
+		void testAlloc();
+		void testBTree();
+		void testConstruct();
+		void testUnorderedMap();
+	}// namespace Test
+}
+
+#endif // !_TEST_H_
@@ -0,0 +1,109 @@
+#include "Test.h"
+#include "../UnorderedMap.h"
+
+#include <new>
+#include <stdexcept>
+#include <string>
+
+namespace tinySTL {
+	namespace Test {
+		namespace {
+			size_t liveBytes = 0;
+			bool hashThrows = false;
+
+			template<class T>
+			struct counting_allocator {
+				typedef T value_type;
+				counting_allocator() {}
+				template<class U>
+				counting_allocator(const counting_allocator<U>&) {}
+				T *allocate(size_t n) {
+					liveBytes += n * sizeof(T);
+					return static_cast<T*>(::operator new(n * sizeof(T)));
+				}
+				void deallocate(T *p, size_t n) {
+					liveBytes -= n * sizeof(T);
+					::operator delete(p);
+				}
+				bool operator==(const counting_allocator&) const { return true; }
+				bool operator!=(const counting_allocator&) const { return false; }
+			};
+			struct throwing_hash {
+				size_t operator()(int key) const {
+					if (hashThrows) throw std::runtime_error("hash");
+					return static_cast<size_t>(key);
+				}
+			};
+
+			// rehash(0) of an empty table gives up its slots instead of asking for none
+			void testRehashEmptyToZero() {
+				unordered_map<int, int> m;
+				for (int i = 0; i < 100; ++i) m[i] = i;
+				m.clear();
+				m.rehash(0);
+				TINYSTL_CHECK(m.find(12345678) == m.end());
+				m[5] = 6;
+				TINYSTL_CHECK(m.size() == 1 && m[5] == 6);
+				m.erase(5);
+				m.rehash(0);
+				m.rehash(0);
+				TINYSTL_CHECK(m.empty() && m.begin() == m.end());
+			}
+			// a hash that throws while the table grows leaves it as it was, and frees what the growth allocated
+			void testResizeHashThrows() {
+				typedef unordered_map<int, int, throwing_hash, equal_to<int>, counting_allocator<pair<const int, int> > > map_type;
+				{
+					map_type m;
+					for (int i = 0; i < 100; ++i) m[i] = i;
+					const size_t before = liveBytes;
+					hashThrows = true;
+					bool threw = false;
+					try {
+						m.rehash(4096);
+					}
+					catch (const std::runtime_error&) {
+						threw = true;
+					}
+					hashThrows = false;
+					TINYSTL_CHECK(threw && liveBytes == before);
+					TINYSTL_CHECK(m.size() == 100 && m.find(42)->second == 42);
+				}
+				TINYSTL_CHECK(liveBytes == 0);
+			}
+
+			struct string_hash {
+				typedef void is_transparent;
+				size_t operator()(const std::string& s) const { return (*this)(s.c_str()); }
+				size_t operator()(const char *s) const {
+					size_t h = 14695981039346656037ull;
+					for (; *s; ++s) h = (h ^ static_cast<unsigned char>(*s)) * 1099511628211ull;
+					return h;
+				}
+			};
+			struct string_equal {
+				typedef void is_transparent;
+				bool operator()(const std::string& a, const std::string& b) const { return a == b; }
+				bool operator()(const std::string& a, const char *b) const { return a == b; }
+				bool operator()(const char *a, const std::string& b) const { return b == a; }
+			};
+			// with transparent lookup, erase of an iterator is still erase(const_iterator)
+			void testTransparentEraseIterator() {
+				typedef unordered_map<std::string, int, string_hash, string_equal> map_type;
+				map_type m;
+				m["one"] = 1;
+				m["two"] = 2;
+				m["three"] = 3;
+				map_type::iterator next = m.erase(m.find("two"));
+				(void)next;
+				m.erase(static_cast<const map_type&>(m).find("one"));
+				TINYSTL_CHECK(m.size() == 1 && m.erase("three") == 1 && m.empty());
+			}
+		}
+
+		void testUnorderedMap() {
+			testRehashEmptyToZero();
+			testResizeHashThrows();
+			testTransparentEraseIterator();
+		}
+	}// namespace Test
+}
@@ -0,0 +1,517 @@
+#ifndef _THREAD_POOL_H_
+#define _THREAD_POOL_H_
+
+#include "Alloc.h"
+#include "Deque.h"
+#include "LockFreeQueue.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace tinySTL {
+
+	class thread_pool;
+
+	namespace Detail {
+		/*
+		** A queued task. Frames come from the alloc pool, whose thread caches
+		** make spawning a task a free-list pop rather than a malloc; the
+		** thread that runs a frame frees it. Functions aligned beyond the
+		** pool's blocks get their frames from operator new.
+		*/
+		struct task_frame {
+			void (*invoke)(task_frame *frame);
+		};
+
+		template<class Function>
+		struct task_frame_of : task_frame {
+			typedef std::integral_constant<bool,
+				alignof(Function) <= size_t(alloc::size_class_type::ALIGN)> pooled;
+
+			Function f;
+
+			explicit task_frame_of(Function&& fn) :f(std::move(fn)) { invoke = &run; }
+
+			static task_frame *make(Function&& fn) {
+				void *p = allocate(pooled());
+				try {
+					return ::new (p) task_frame_of(std::move(fn));
+				}
+				catch (...) {
+					deallocate(p, pooled());
+					throw;
+				}
+			}
+			// the pool has nowhere to report a throw from f: the frame is freed, then the program ends
+			static void run(task_frame *frame) {
+				task_frame_of *self = static_cast<task_frame_of*>(frame);
+				try {
+					self->f();
+				}
+				catch (...) {
+					destroy(self);
+					std::terminate();
+				}
+				destroy(self);
+			}
+			static void destroy(task_frame_of *self) {
+				self->~task_frame_of();
+				deallocate(self, pooled());
+			}
+			static void *allocate(std::true_type) { return alloc::allocate(sizeof(task_frame_of)); }
+			static void *allocate(std::false_type) { return ::operator new(sizeof(task_frame_of)); }
+			static void deallocate(void *p, std::true_type) { alloc::deallocate(p, sizeof(task_frame_of)); }
+			static void deallocate(void *p, std::false_type) { ::operator delete(p); }
+		};
+
+		/*
+		** Chase-Lev deque of task frames, in the C11 form of Le, Pop, Cohen and
+		** Zappa Nardelli. The owner pushes and takes at the bottom without a
+		** lock; thieves take from the top with one CAS, and the owner only
+		** races them for the last task. A full ring is replaced by one twice
+		** as large; the old rings stay until the deque dies, since a thief
+		** may still be reading one.
+		*/
+		class work_deque {
+			private:
+				struct ring {
+					ptrdiff_t mask;
+					std::atomic<task_frame*> *slots;
+					ring *older;
+
+					ring(ptrdiff_t capacity, ring *old)
+						:mask(capacity - 1), slots(new std::atomic<task_frame*>[capacity]), older(old) {}
+					~ring() { delete[] slots; }
+					task_frame *get(ptrdiff_t i) const { return slots[i & mask].load(std::memory_order_relaxed); }
+					void put(ptrdiff_t i, task_frame *task) { slots[i & mask].store(task, std::memory_order_relaxed); }
+				};
+				enum EInitialRing{ INITIAL_RING = 64 };
+
+				// thieves write top_, the owner bottom_: one cache line each
+				std::atomic<ptrdiff_t> top_;
+				char pad0_[CACHE_LINE];
+				std::atomic<ptrdiff_t> bottom_;
+				std::atomic<ring*> ring_;
+				char pad1_[CACHE_LINE];
+			public:
+				work_deque() :top_(0), bottom_(0), ring_(new ring(INITIAL_RING, 0)) {}
+				work_deque(const work_deque&) = delete;
+				work_deque& operator = (const work_deque&) = delete;
+				~work_deque();
+
+				// owner only
+				void push(task_frame *task);
+				task_frame *take();
+				// any thread; 0 once the deque is seen empty
+				task_frame *steal();
+				// a snapshot that may be stale by the time it is used
+				bool empty() const {
+					return bottom_.load(std::memory_order_relaxed) <= top_.load(std::memory_order_relaxed);
+				}
+		};
+
+		inline work_deque::~work_deque() {
+			for (ring *r = ring_.load(std::memory_order_relaxed); r != 0;) {
+				ring *older = r->older;
+				delete r;
+				r = older;
+			}
+		}
+		inline void work_deque::push(task_frame *task) {
+			ptrdiff_t b = bottom_.load(std::memory_order_relaxed);
+			ptrdiff_t t = top_.load(std::memory_order_acquire);
+			ring *r = ring_.load(std::memory_order_relaxed);
+			if (b - t > r->mask) {
+				ring *bigger = new ring(2 * (r->mask + 1), r);
+				for (ptrdiff_t i = t; i != b; ++i) {
+					bigger->put(i, r->get(i));
+				}
+				ring_.store(bigger, std::memory_order_release);
+				r = bigger;
+			}
+			r->put(b, task);
+			// publishes the frame (and the ring) to the thieves that read bottom_
+			bottom_.store(b + 1, std::memory_order_release);
+		}
+		inline task_frame *work_deque::take() {
+			ptrdiff_t b = bottom_.load(std::memory_order_relaxed) - 1;
+			ring *r = ring_.load(std::memory_order_relaxed);
+			bottom_.store(b, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			ptrdiff_t t = top_.load(std::memory_order_relaxed);
+			if (t > b) {
+				bottom_.store(b + 1, std::memory_order_relaxed);
+				return 0;
+			}
+			task_frame *task = r->get(b);
+			if (t == b) {
+				// the last task: whoever moves top_ past it has it
+				if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+					task = 0;
+				}
+				bottom_.store(b + 1, std::memory_order_relaxed);
+			}
+			return task;
+		}
+		inline task_frame *work_deque::steal() {
+			for (;;) {
+				ptrdiff_t t = top_.load(std::memory_order_acquire);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				ptrdiff_t b = bottom_.load(std::memory_order_acquire);
+				if (t >= b) return 0;
+				task_frame *task = ring_.load(std::memory_order_acquire)->get(t);
+				if (top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+					return task;
+				}
+			}
+		}
+
+		// the pool the calling thread works for, and its place there
+		struct pool_thread {
+			const thread_pool *pool;
+			size_t index;
+		};
+		inline pool_thread& current_pool_thread() {
+			static thread_local pool_thread current = { 0, 0 };
+			return current;
+		}
+
+		// xorshift, one state per thread, for picking whom to steal from
+		inline size_t pool_random() {
+			static thread_local size_t state = std::hash<std::thread::id>()(std::this_thread::get_id()) | 1;
+			state ^= state << 13;
+			state ^= state >> 7;
+			state ^= state << 17;
+			return state;
+		}
+	}// namespace Detail
+
+	/*
+	** A fixed set of worker threads, each owning a Chase-Lev deque. A task
+	** submitted by a worker goes to the bottom of its own deque and the
+	** worker takes its newest task first, whose data is still in its cache;
+	** an idle worker steals the oldest task of a victim picked at random,
+	** the one most likely to stand for a large piece of work. Tasks from
+	** threads outside the pool go to a shared deque under a lock, which
+	** they use the same way: newest first for them, oldest for workers.
+	** A worker that finds nothing yields for a while, then sleeps until a
+	** task is submitted; submitting only touches the lock when one sleeps.
+	** A task that throws ends the program through std::terminate once its
+	** frame is freed; task_group catches for the tasks it runs.
+	*/
+	class thread_pool {
+		public:
+			explicit thread_pool(size_t threads = default_threads());
+			thread_pool(const thread_pool&) = delete;
+			thread_pool& operator = (const thread_pool&) = delete;
+			// runs the tasks still queued, then joins the workers
+			~thread_pool();
+
+			size_t size() const { return count_; }
+
+			template<class Function>
+			void submit(Function&& f);
+			// runs one queued task, if any, on the calling thread; for threads waiting on their tasks
+			bool run_one();
+			// nothing the calling thread queued is still waiting: the pool has taken it all
+			bool local_empty() const;
+
+			// the pool the parallel algorithms use, started on first use
+			static thread_pool& shared();
+			// one thread fewer than the hardware has: the thread that waits on a task_group works too
+			static size_t default_threads();
+		private:
+			enum ESpinRounds{ SPIN_ROUNDS = 64 };
+
+			Detail::work_deque *deques_;
+			std::thread *threads_;
+			size_t count_;
+			std::mutex injectLock_;
+			deque<Detail::task_frame*> injected_;
+			std::atomic<size_t> injectedCount_;
+			// workers asleep, and how many times they have been woken
+			std::atomic<size_t> sleepers_;
+			std::atomic<size_t> epoch_;
+			std::atomic<bool> stop_;
+			std::mutex sleepLock_;
+			std::condition_variable wake_;
+		private:
+			// this thread's deque in the pool, or count_ when it is not one of its workers
+			size_t self() const;
+			void push(Detail::task_frame *task);
+			Detail::task_frame *take(size_t self);
+			Detail::task_frame *takeInjected(bool newest);
+			void notify();
+			void work(size_t index);
+			void shutdown();
+	};
+
+	inline thread_pool::thread_pool(size_t threads)
+		:deques_(0), threads_(0), count_(threads != 0 ? threads : 1),
+		injectedCount_(0), sleepers_(0), epoch_(0), stop_(false) {
+		deques_ = new Detail::work_deque[count_];
+		threads_ = new std::thread[count_];
+		try {
+			for (size_t i = 0; i != count_; ++i) {
+				threads_[i] = std::thread(&thread_pool::work, this, i);
+			}
+		}
+		catch (...) {
+			shutdown();
+			throw;
+		}
+	}
+	inline thread_pool::~thread_pool() {
+		shutdown();
+	}
+	inline void thread_pool::shutdown() {
+		{
+			std::lock_guard<std::mutex> guard(sleepLock_);
+			stop_.store(true);
+		}
+		wake_.notify_all();
+		for (size_t i = 0; i != count_; ++i) {
+			if (threads_[i].joinable()) threads_[i].join();
+		}
+		delete[] threads_;
+		delete[] deques_;
+	}
+
+	inline size_t thread_pool::default_threads() {
+		size_t n = std::thread::hardware_concurrency();
+		return n > 1 ? n - 1 : 1;
+	}
+	inline thread_pool& thread_pool::shared() {
+		static thread_pool pool;
+		return pool;
+	}
+
+	inline size_t thread_pool::self() const {
+		const Detail::pool_thread& current = Detail::current_pool_thread();
+		return current.pool == this ? current.index : count_;
+	}
+	inline bool thread_pool::local_empty() const {
+		size_t index = self();
+		return index != count_ ? deques_[index].empty() : injectedCount_.load(std::memory_order_relaxed) == 0;
+	}
+
+	template<class Function>
+	void thread_pool::submit(Function&& f) {
+		typedef typename std::decay<Function>::type function_type;
+		push(Detail::task_frame_of<function_type>::make(function_type(std::forward<Function>(f))));
+	}
+	inline void thread_pool::push(Detail::task_frame *task) {
+		size_t index = self();
+		if (index != count_) {
+			deques_[index].push(task);
+		}
+		else {
+			std::lock_guard<std::mutex> guard(injectLock_);
+			injected_.push_back(task);
+			injectedCount_.fetch_add(1);
+		}
+		notify();
+	}
+	inline void thread_pool::notify() {
+		// pairs with the fence of a sleeper's last take() after it counted itself: one of the two sees the other
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (sleepers_.load(std::memory_order_relaxed) != 0) {
+			{
+				std::lock_guard<std::mutex> guard(sleepLock_);
+				epoch_.fetch_add(1);
+			}
+			wake_.notify_one();
+		}
+	}
+
+	inline Detail::task_frame *thread_pool::take(size_t self) {
+		Detail::task_frame *task = 0;
+		// own tasks first, newest first; outside threads treat the shared deque as theirs
+		if (self != count_) {
+			if ((task = deques_[self].take()) != 0) return task;
+		}
+		else if ((task = takeInjected(true)) != 0) {
+			return task;
+		}
+		size_t start = Detail::pool_random() % count_;
+		for (size_t i = 0; i != count_; ++i) {
+			size_t victim = start + i < count_ ? start + i : start + i - count_;
+			if (victim != self && (task = deques_[victim].steal()) != 0) return task;
+		}
+		return self != count_ ? takeInjected(false) : 0;
+	}
+	inline Detail::task_frame *thread_pool::takeInjected(bool newest) {
+		if (injectedCount_.load() == 0) return 0;
+		std::lock_guard<std::mutex> guard(injectLock_);
+		if (injected_.empty()) return 0;
+		Detail::task_frame *task = 0;
+		if (newest) {
+			task = injected_.back();
+			injected_.pop_back();
+		}
+		else {
+			task = injected_.front();
+			injected_.pop_front();
+		}
+		injectedCount_.fetch_sub(1);
+		return task;
+	}
+
+	inline bool thread_pool::run_one() {
+		Detail::task_frame *task = take(self());
+		if (task == 0) return false;
+		task->invoke(task);
+		return true;
+	}
+
+	inline void thread_pool::work(size_t index) {
+		Detail::pool_thread& current = Detail::current_pool_thread();
+		current.pool = this;
+		current.index = index;
+		for (size_t idle = 0;;) {
+			Detail::task_frame *task = take(index);
+			if (task != 0) {
+				task->invoke(task);
+				idle = 0;
+				continue;
+			}
+			if (stop_.load()) break;
+			if (++idle < SPIN_ROUNDS) {
+				std::this_thread::yield();
+				continue;
+			}
+			idle = 0;
+			// a submit after the epoch is read either shows up in this take or moves the epoch on
+			size_t epoch = epoch_.load();
+			sleepers_.fetch_add(1);
+			task = take(index);
+			if (task == 0) {
+				std::unique_lock<std::mutex> guard(sleepLock_);
+				wake_.wait(guard, [this, epoch] { return epoch_.load() != epoch || stop_.load(); });
+			}
+			sleepers_.fetch_sub(1);
+			if (task != 0) task->invoke(task);
+		}
+	}
+
+	/*
+	** Fork/join on a pool: spawn() queues a task and sync() returns once
+	** all the tasks spawned through the group have finished. A thread in
+	** sync() runs queued tasks, of this group or any other, rather than
+	** block, so tasks may spawn groups of their own and sync on them.
+	** The first exception a task throws is rethrown by sync(); the other
+	** tasks still run. The destructor syncs too, but does not rethrow.
+	*/
+	class task_group {
+		private:
+			thread_pool& pool_;
+			std::atomic<size_t> pending_;
+			std::mutex errorLock_;
+			std::exception_ptr error_;
+		public:
+			explicit task_group(thread_pool& pool = thread_pool::shared()) :pool_(pool), pending_(0) {}
+			task_group(const task_group&) = delete;
+			task_group& operator = (const task_group&) = delete;
+			~task_group() { join(); }
+
+			thread_pool& pool() const { return pool_; }
+
+			template<class Function>
+			void spawn(Function&& f);
+			void sync();
+		private:
+			void join();
+			void fail();
+	};
+
+	template<class Function>
+	void task_group::spawn(Function&& f) {
+		typedef typename std::decay<Function>::type function_type;
+		pending_.fetch_add(1, std::memory_order_relaxed);
+		try {
+			pool_.submit([this, f = function_type(std::forward<Function>(f))]() mutable {
+				try {
+					f();
+				}
+				catch (...) {
+					fail();
+				}
+				// the last touch of the group: sync() may return and destroy it right after
+				pending_.fetch_sub(1, std::memory_order_release);
+			});
+		}
+		catch (...) {
+			pending_.fetch_sub(1, std::memory_order_relaxed);
+			throw;
+		}
+	}
+	inline void task_group::fail() {
+		std::lock_guard<std::mutex> guard(errorLock_);
+		if (!error_) error_ = std::current_exception();
+	}
+	inline void task_group::join() {
+		while (pending_.load(std::memory_order_acquire) != 0) {
+			if (!pool_.run_one()) std::this_thread::yield();
+		}
+	}
+	inline void task_group::sync() {
+		join();
+		if (error_) {
+			std::exception_ptr error = error_;
+			error_ = nullptr;
+			std::rethrow_exception(error);
+		}
+	}
+
+	/*
+	** f(begin, end) on pieces that together cover [first, last), a range of
+	** integers or random access iterators. The range is split lazily: a
+	** thread cuts grain elements at a time off the front of its range and
+	** hands half of the rest to the pool only when nothing it queued before
+	** is still waiting, that is when the pool has taken its earlier work.
+	** A busy pool thus gets a few large tasks and an idle one many small
+	** ones. grain 0 starts from n / (64 * threads). f is shared by the
+	** threads; the first exception it throws is rethrown at the end.
+	*/
+	namespace Detail {
+		template<class Index, class Function>
+		void parallel_for_range(Index first, Index last, ptrdiff_t grain, const Function& f, task_group& group) {
+			while (ptrdiff_t(last - first) > grain) {
+				if (ptrdiff_t(last - first) >= 2 * grain && group.pool().local_empty()) {
+					Index mid = first + (last - first) / 2;
+					group.spawn([mid, last, grain, &f, &group] { parallel_for_range(mid, last, grain, f, group); });
+					last = mid;
+				}
+				else {
+					Index end = first;
+					end += grain;
+					f(first, end);
+					first = end;
+				}
+			}
+			if (first != last) f(first, last);
+		}
+	}// namespace Detail
+
+	template<class Index, class Function>
+	void parallel_for(Index first, Index last, const Function& f, size_t grain = 0,
+		thread_pool& pool = thread_pool::shared()) {
+		ptrdiff_t n = last - first;
+		if (n <= 0) return;
+		if (grain == 0) grain = size_t(n) / (64 * (pool.size() + 1));
+		if (grain == 0) grain = 1;
+		task_group group(pool);
+		Detail::parallel_for_range(first, last, ptrdiff_t(grain), f, group);
+		group.sync();
+	}
+} // namespace tinySTL
+
+#endif // _THREAD_POOL_H_
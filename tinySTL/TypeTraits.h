@@ -1,6 +1,8 @@
 #ifndef _TYPE_TRAITS_H_
 #define _TYPE_TRAITS_H_
 
+#include <type_traits>
+
 namespace tinySTL {
 
 	namespace {
@@ -21,256 +23,40 @@ namespace tinySTL {
 	struct _true_type {};
 	struct _false_type {};
 
-	/* */
+	/*
+	** Derived from the compiler's own knowledge (<type_traits>), so user
+	** structs get the same fast paths as builtins. A type can still
+	** specialise _type_traits to override the answer.
+	*/
 	template<class T>
 	struct _type_traits
 	{
-		typedef _false_type		has_trivial_default_constructor;		// default constructor is not trivial
-		typedef _false_type		has_trivial_copy_constructor;			// copy constructor is not trivial
-		typedef _false_type		has_trivial_assignment_operator;	// assignment operator is not trivial
-		typedef _false_type		has_trivial_destructor;					// destructor is not trivial
-		typedef _false_type		is_POD_type;									// not POD type
-	};
-
-	template<>
-	struct _type_traits<bool>
-	{
-		typedef _true_type		has_trivial_default_constructor;
-		typedef _true_type		has_trivial_copy_constructor;
-		typedef _true_type		has_trivial_assignment_operator;
-		typedef _true_type		has_trivial_destructor;
-		typedef _true_type		is_POD_type;
-	};
-
-	template<>
-	struct _type_traits<char>
-	{
-		typedef _true_type		has_trivial_default_constructor;
-		typedef _true_type		has_trivial_copy_constructor;
-		typedef _true_type		has_trivial_assignment_operator;
-		typedef _true_type		has_trivial_destructor;
-		typedef _true_type		is_POD_type;
-	};
-
-	template<>
-	struct _type_traits<unsigned char>
-	{
-		typedef _true_type		has_trivial_default_constructor;
-		typedef _true_type		has_trivial_copy_constructor;
-		typedef _true_type		has_trivial_assignment_operator;
-		typedef _true_type		has_trivial_destructor;
-		typedef _true_type		is_POD_type;
-	};
-
-	template<>
-	struct _type_traits<signed char>
-	{
-		typedef _true_type		has_trivial_default_constructor;
-		typedef _true_type		has_trivial_copy_constructor;
-		typedef _true_type		has_trivial_assignment_operator;
-		typedef _true_type		has_trivial_destructor;
-		typedef _true_type		is_POD_type;
-	};
-
-	template<>
-	struct _type_traits<wchar_t>
-	{
-		typedef _true_type		has_trivial_default_constructor;
-		typedef _true_type		has_trivial_copy_constructor;
-		typedef _true_type		has_trivial_assignment_operator;
-		typedef _true_type		has_trivial_destructor;
-		typedef _true_type		is_POD_type;
-	};
-
-	template<>
-	struct _type_traits<short>
-	{
-		typedef _true_type		has_trivial_default_constructor;
-		typedef _true_type		has_trivial_copy_constructor;
-		typedef _true_type		has_trivial_assignment_operator;
-		typedef _true_type		has_trivial_destructor;
-		typedef _true_type		is_POD_type;
-	};
-
-	template<>
-	struct _type_traits<unsigned short>
-	{
-		typedef _true_type		has_trivial_default_constructor;
-		typedef _true_type		has_trivial_copy_constructor;
-		typedef _true_type		has_trivial_assignment_operator;
-		typedef _true_type		has_trivial_destructor;
-		typedef _true_type		is_POD_type;
-	};
-
-	template<>
-	struct _type_traits<int>
-	{
-		typedef _true_type		has_trivial_default_constructor;
-		typedef _true_type		has_trivial_copy_constructor;
-		typedef _true_type		has_trivial_assignment_operator;
-		typedef _true_type		has_trivial_destructor;
-		typedef _true_type		is_POD_type;
-	};
-
-	template<>
-	struct _type_traits<unsigned int>
-	{
-		typedef _true_type		has_trivial_default_constructor;
-		typedef _true_type		has_trivial_copy_constructor;
-		typedef _true_type		has_trivial_assignment_operator;
-		typedef _true_type		has_trivial_destructor;
-		typedef _true_type		is_POD_type;
-	};
-
-	template<>
-	struct _type_traits<long>
-	{
-		typedef _true_type		has_trivial_default_constructor;
-		typedef _true_type		has_trivial_copy_constructor;
-		typedef _true_type		has_trivial_assignment_operator;
-		typedef _true_type		has_trivial_destructor;
-		typedef _true_type		is_POD_type;
-	};
-
-	template<>
-	struct _type_traits<unsigned long>
-	{
-		typedef _true_type		has_trivial_default_constructor;
-		typedef _true_type		has_trivial_copy_constructor;
-		typedef _true_type		has_trivial_assignment_operator;
-		typedef _true_type		has_trivial_destructor;
-		typedef _true_type		is_POD_type;
-	};
-
-	template<>
-	struct _type_traits<long long>
-	{
-		typedef _true_type		has_trivial_default_constructor;
-		typedef _true_type		has_trivial_copy_constructor;
-		typedef _true_type		has_trivial_assignment_operator;
-		typedef _true_type		has_trivial_destructor;
-		typedef _true_type		is_POD_type;
-	};
-
-	template<>
-	struct _type_traits<unsigned long long>
-	{
-		typedef _true_type		has_trivial_default_constructor;
-		typedef _true_type		has_trivial_copy_constructor;
-		typedef _true_type		has_trivial_assignment_operator;
-		typedef _true_type		has_trivial_destructor;
-		typedef _true_type		is_POD_type;
-	};
-
-	template<>
-	struct _type_traits<float>
-	{
-		typedef _true_type		has_trivial_default_constructor;
-		typedef _true_type		has_trivial_copy_constructor;
-		typedef _true_type		has_trivial_assignment_operator;
-		typedef _true_type		has_trivial_destructor;
-		typedef _true_type		is_POD_type;
-	};
-
-	template<>
-	struct _type_traits<double>
-	{
-		typedef _true_type		has_trivial_default_constructor;
-		typedef _true_type		has_trivial_copy_constructor;
-		typedef _true_type		has_trivial_assignment_operator;
-		typedef _true_type		has_trivial_destructor;
-		typedef _true_type		is_POD_type;
-	};
-
-	template<>
-	struct _type_traits<long double>
-	{
-		typedef _true_type		has_trivial_default_constructor;
-		typedef _true_type		has_trivial_copy_constructor;
-		typedef _true_type		has_trivial_assignment_operator;
-		typedef _true_type		has_trivial_destructor;
-		typedef _true_type		is_POD_type;
-	};
-
+		typedef typename IfThenElse<std::is_trivially_default_constructible<T>::value, _true_type, _false_type>::result	has_trivial_default_constructor;
+		typedef typename IfThenElse<std::is_trivially_copy_constructible<T>::value, _true_type, _false_type>::result	has_trivial_copy_constructor;
+		typedef typename IfThenElse<std::is_trivially_copy_assignable<T>::value, _true_type, _false_type>::result		has_trivial_assignment_operator;
+		typedef typename IfThenElse<std::is_trivially_destructible<T>::value, _true_type, _false_type>::result		has_trivial_destructor;
+		typedef typename IfThenElse<std::is_trivial<T>::value && std::is_standard_layout<T>::value, _true_type, _false_type>::result	is_POD_type;
+	};
+
+	/*
+	** Whether moving a T to new memory and destroying the source can be done
+	** with memcpy/memmove/realloc instead. True for trivially copyable types;
+	** specialise it for types that are not trivially copyable but whose
+	** objects do not depend on their own address, e.g.
+	**     template<> struct is_trivially_relocatable<my_handle> : std::true_type {};
+	** Only types with no pointer into their own object qualify, such as an
+	** owning pointer or a heap-only vector. Types that point into themselves
+	** do not: a small buffer (libstdc++'s std::string keeps one), a list head.
+	*/
 	template<class T>
-	struct _type_traits<T*>
-	{
-		typedef _true_type		has_trivial_default_constructor;
-		typedef _true_type		has_trivial_copy_constructor;
-		typedef _true_type		has_trivial_assignment_operator;
-		typedef _true_type		has_trivial_destructor;
-		typedef _false_type		is_POD_type;
-	};
-
-	template<class T>
-	struct _type_traits<const T*>
-	{
-		typedef _true_type		has_trivial_default_constructor;
-		typedef _true_type		has_trivial_copy_constructor;
-		typedef _true_type		has_trivial_assignment_operator;
-		typedef _true_type		has_trivial_destructor;
-		typedef _false_type		is_POD_type;
-	};
-
-	template<>
-	struct _type_traits<char*>
-	{
-		typedef _true_type		has_trivial_default_constructor;
-		typedef _true_type		has_trivial_copy_constructor;
-		typedef _true_type		has_trivial_assignment_operator;
-		typedef _true_type		has_trivial_destructor;
-		typedef _false_type		is_POD_type;
-	};
-
-	template<>
-	struct _type_traits<unsigned char*>
-	{
-		typedef _true_type		has_trivial_default_constructor;
-		typedef _true_type		has_trivial_copy_constructor;
-		typedef _true_type		has_trivial_assignment_operator;
-		typedef _true_type		has_trivial_destructor;
-		typedef _false_type		is_POD_type;
-	};
-
-	template<>
-	struct _type_traits<signed char*>
-	{
-		typedef _true_type		has_trivial_default_constructor;
-		typedef _true_type		has_trivial_copy_constructor;
-		typedef _true_type		has_trivial_assignment_operator;
-		typedef _true_type		has_trivial_destructor;
-		typedef _false_type		is_POD_type;
-	};
-
-	template<>
-	struct _type_traits<const char*>
-	{
-		typedef _true_type		has_trivial_default_constructor;
-		typedef _true_type		has_trivial_copy_constructor;
-		typedef _true_type		has_trivial_assignment_operator;
-		typedef _true_type		has_trivial_destructor;
-		typedef _false_type		is_POD_type;
-	};
-
-	template<>
-	struct _type_traits<const unsigned char*>
-	{
-		typedef _true_type		has_trivial_default_constructor;
-		typedef _true_type		has_trivial_copy_constructor;
-		typedef _true_type		has_trivial_assignment_operator;
-		typedef _true_type		has_trivial_destructor;
-		typedef _false_type		is_POD_type;
-	};
-
-	template<>
-	struct _type_traits<const signed char*>
-	{
-		typedef _true_type		has_trivial_default_constructor;
-		typedef _true_type		has_trivial_copy_constructor;
-		typedef _true_type		has_trivial_assignment_operator;
-		typedef _true_type		has_trivial_destructor;
-		typedef _false_type		is_POD_type;
-	};
+	struct is_trivially_relocatable : std::integral_constant<bool, std::is_trivially_copyable<T>::value> {};
+
+	template<class T1, class T2>
+	struct pair;
+	// pair has its own assignment, so it is never trivially copyable, but it relocates as its members do
+	template<class T1, class T2>
+	struct is_trivially_relocatable<pair<T1, T2> > : std::integral_constant<bool,
+		is_trivially_relocatable<T1>::value && is_trivially_relocatable<T2>::value> {};
 
 } // namespace tinySTL
 #endif // _TYPE_TRAITS_H_
\ No newline at end of file
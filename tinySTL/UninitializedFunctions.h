@@ -0,0 +1,406 @@
+#ifndef _UNINITIALIZED_FUNCTIONS_H_
+#define _UNINITIALIZED_FUNCTIONS_H_
+
+#include "Algorithm.h"
+#include "AllocatorTraits.h"
+#include "Construct.h"
+#include "Iterator.h"
+#include "TypeTraits.h"
+
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace tinySTL {
+
+	/*
+	** Construct elements in raw memory. Every function either constructs the
+	** whole destination or, when a constructor throws, destroys what it built
+	** and rethrows, leaving the destination raw again.
+	** The fast paths only apply to raw pointer ranges of one element type:
+	** copies and moves become one memmove when the constructor they call (copy
+	** from T& or const T&, move from T&&) is trivial, and fills whose value is
+	** a single repeated byte become memset.
+	** Segmented ranges (deque) are split so each piece is a pointer range.
+	*/
+	template<class T>
+	class allocator;
+
+	namespace Detail {
+		// constructing [first, last) into result is a memmove: the constructor *first selects is trivial
+		template<class InputIterator, class ForwardIterator>
+		struct is_memmove_range : std::false_type {};
+		template<class T>
+		struct is_memmove_range<T*, T*> : std::is_trivially_constructible<T, T&> {};
+		template<class T>
+		struct is_memmove_range<const T*, T*> : std::is_trivially_constructible<T, const T&> {};
+		template<class T>
+		struct is_memmove_range<std::move_iterator<T*>, T*> : std::is_trivially_constructible<T, T&&> {};
+
+		template<class T>
+		inline const T *raw_pointer(const T *p) { return p; }
+		template<class T>
+		inline const T *raw_pointer(std::move_iterator<T*> it) { return it.base(); }
+
+		template<class Iterator>
+		struct value_type_of {
+			typedef typename std::remove_cv<typename iterator_traits<Iterator>::value_type>::type type;
+		};
+	}// namespace Detail
+
+	//********** [uninitialized_copy] ********************
+	template<class InputIterator, class ForwardIterator>
+	ForwardIterator uninitialized_copy(InputIterator first, InputIterator last, ForwardIterator result);
+
+	namespace Detail {
+		template<class InputIterator, class ForwardIterator>
+		ForwardIterator uninit_copy_flat(InputIterator first, InputIterator last, ForwardIterator result, std::true_type) {
+			size_t n = last - first;
+			if (n != 0) memmove(static_cast<void*>(result), raw_pointer(first), n * sizeof(*result));
+			return result + n;
+		}
+		template<class InputIterator, class ForwardIterator>
+		ForwardIterator uninit_copy_flat(InputIterator first, InputIterator last, ForwardIterator result, std::false_type) {
+			typedef typename value_type_of<ForwardIterator>::type T;
+			ForwardIterator cur = result;
+			try {
+				for (; first != last; ++first, ++cur) {
+					::new (static_cast<void*>(&*cur)) T(*first);
+				}
+			}
+			catch (...) {
+				tinySTL::destroy(result, cur);
+				throw;
+			}
+			return cur;
+		}
+		template<class InputIterator, class ForwardIterator>
+		ForwardIterator uninit_copy_out(InputIterator first, InputIterator last, ForwardIterator result, std::false_type) {
+			return uninit_copy_flat(first, last, result, is_memmove_range<InputIterator, ForwardIterator>());
+		}
+		// a segmented destination is cut at its segment ends
+		template<class RandomAccessIterator, class SegmentedIterator>
+		SegmentedIterator uninit_copy_out(RandomAccessIterator first, RandomAccessIterator last, SegmentedIterator result, std::true_type) {
+			typedef segmented_iterator_traits<SegmentedIterator> traits;
+			typename traits::segment_iterator seg = traits::segment(result);
+			typename traits::local_iterator local = traits::local(result);
+			try {
+				while (first != last) {
+					if (local == traits::end(seg)) {
+						++seg;
+						local = traits::begin(seg);
+					}
+					ptrdiff_t n = last - first, room = traits::end(seg) - local;
+					if (room < n) n = room;
+					local = tinySTL::uninitialized_copy(first, first + n, local);
+					first += n;
+				}
+			}
+			catch (...) {
+				tinySTL::destroy(result, traits::compose(seg, local));
+				throw;
+			}
+			return traits::compose(seg, local);
+		}
+		template<class InputIterator, class ForwardIterator>
+		ForwardIterator uninit_copy_in(InputIterator first, InputIterator last, ForwardIterator result, std::false_type) {
+			typedef typename std::integral_constant<bool,
+				segmented_iterator_traits<ForwardIterator>::is_segmented_iterator::value &&
+				std::is_convertible<typename iterator_traits<InputIterator>::iterator_category, random_access_iterator_tag>::value> split;
+			return uninit_copy_out(first, last, result, split());
+		}
+		template<class SegmentedIterator, class ForwardIterator>
+		ForwardIterator uninit_copy_in(SegmentedIterator first, SegmentedIterator last, ForwardIterator result, std::true_type) {
+			typedef segmented_iterator_traits<SegmentedIterator> traits;
+			typename traits::segment_iterator sfirst = traits::segment(first), slast = traits::segment(last);
+			if (sfirst == slast) {
+				return tinySTL::uninitialized_copy(traits::local(first), traits::local(last), result);
+			}
+			ForwardIterator cur = result;
+			try {
+				cur = tinySTL::uninitialized_copy(traits::local(first), traits::end(sfirst), cur);
+				for (++sfirst; sfirst != slast; ++sfirst) {
+					cur = tinySTL::uninitialized_copy(traits::begin(sfirst), traits::end(sfirst), cur);
+				}
+				cur = tinySTL::uninitialized_copy(traits::begin(slast), traits::local(last), cur);
+			}
+			catch (...) {
+				tinySTL::destroy(result, cur);
+				throw;
+			}
+			return cur;
+		}
+	}// namespace Detail
+
+	template<class InputIterator, class ForwardIterator>
+	ForwardIterator uninitialized_copy(InputIterator first, InputIterator last, ForwardIterator result) {
+		typedef typename segmented_iterator_traits<InputIterator>::is_segmented_iterator segmented;
+		return Detail::uninit_copy_in(first, last, result, segmented());
+	}
+
+	//********** [uninitialized_move] ********************
+	template<class InputIterator, class ForwardIterator>
+	ForwardIterator uninitialized_move(InputIterator first, InputIterator last, ForwardIterator result) {
+		return tinySTL::uninitialized_copy(std::make_move_iterator(first), std::make_move_iterator(last), result);
+	}
+
+	//********** [uninitialized_relocate] ****************
+	/*
+	** Moves [first, last) to the raw memory at result and destroys the
+	** sources, which are left raw. Pointer ranges of an is_trivially_relocatable
+	** type are a memmove, so they may overlap. Otherwise the ranges must not overlap;
+	** elements are moved only if their move constructor cannot throw, so if
+	** a copy throws the sources are still intact.
+	*/
+	namespace Detail {
+		template<class T>
+		T *uninit_relocate_aux(T *first, T *last, T *result, std::true_type) {
+			size_t n = last - first;
+			if (n != 0) memmove(static_cast<void*>(result), first, n * sizeof(T));
+			return result + n;
+		}
+		template<class InputIterator, class ForwardIterator>
+		ForwardIterator uninit_relocate_aux(InputIterator first, InputIterator last, ForwardIterator result, std::false_type) {
+			typedef typename value_type_of<ForwardIterator>::type T;
+			ForwardIterator cur = result;
+			try {
+				for (InputIterator it = first; it != last; ++it, ++cur) {
+					::new (static_cast<void*>(&*cur)) T(std::move_if_noexcept(*it));
+				}
+			}
+			catch (...) {
+				tinySTL::destroy(result, cur);
+				throw;
+			}
+			tinySTL::destroy(first, last);
+			return cur;
+		}
+	}// namespace Detail
+
+	template<class InputIterator, class ForwardIterator>
+	ForwardIterator uninitialized_relocate(InputIterator first, InputIterator last, ForwardIterator result) {
+		typedef typename Detail::value_type_of<ForwardIterator>::type T;
+		typedef typename std::integral_constant<bool, std::is_same<InputIterator, T*>::value &&
+			std::is_same<ForwardIterator, T*>::value && is_trivially_relocatable<T>::value> bitwise;
+		return Detail::uninit_relocate_aux(first, last, result, bitwise());
+	}
+
+	//********** [uninitialized_fill] ********************
+	template<class ForwardIterator, class T>
+	void uninitialized_fill(ForwardIterator first, ForwardIterator last, const T& value);
+
+	namespace Detail {
+		template<class ForwardIterator, class T>
+		void uninit_fill_flat(ForwardIterator first, ForwardIterator last, const T& value, std::false_type) {
+			typedef typename value_type_of<ForwardIterator>::type U;
+			ForwardIterator cur = first;
+			try {
+				for (; cur != last; ++cur) {
+					::new (static_cast<void*>(&*cur)) U(value);
+				}
+			}
+			catch (...) {
+				tinySTL::destroy(first, cur);
+				throw;
+			}
+		}
+		// every byte of the value the same (any char, zero, all ones): memset
+		template<class U, class T>
+		void uninit_fill_flat(U *first, U *last, const T& value, std::true_type) {
+			U fill(value);
+			unsigned char bytes[sizeof(U)];
+			memcpy(bytes, &fill, sizeof(U));
+			size_t i = 1;
+			while (i != sizeof(U) && bytes[i] == bytes[0]) ++i;
+			if (i == sizeof(U)) {
+				if (first != last) memset(static_cast<void*>(first), bytes[0], (last - first) * sizeof(U));
+				return;
+			}
+			for (; first != last; ++first) {
+				::new (static_cast<void*>(first)) U(fill);
+			}
+		}
+		template<class ForwardIterator, class T>
+		void uninit_fill_aux(ForwardIterator first, ForwardIterator last, const T& value, std::false_type) {
+			typedef typename value_type_of<ForwardIterator>::type U;
+			typedef typename std::integral_constant<bool, std::is_pointer<ForwardIterator>::value &&
+				std::is_trivially_constructible<U, const U&>::value> bytewise;
+			uninit_fill_flat(first, last, value, bytewise());
+		}
+		template<class SegmentedIterator, class T>
+		void uninit_fill_aux(SegmentedIterator first, SegmentedIterator last, const T& value, std::true_type) {
+			typedef segmented_iterator_traits<SegmentedIterator> traits;
+			typename traits::segment_iterator sfirst = traits::segment(first), slast = traits::segment(last);
+			if (sfirst == slast) {
+				tinySTL::uninitialized_fill(traits::local(first), traits::local(last), value);
+				return;
+			}
+			typename traits::segment_iterator cur = sfirst;
+			try {
+				tinySTL::uninitialized_fill(traits::local(first), traits::end(cur), value);
+				for (++cur; cur != slast; ++cur) {
+					tinySTL::uninitialized_fill(traits::begin(cur), traits::end(cur), value);
+				}
+				tinySTL::uninitialized_fill(traits::begin(slast), traits::local(last), value);
+			}
+			catch (...) {
+				// the segment that threw cleaned up after itself
+				if (cur != sfirst) tinySTL::destroy(first, traits::compose(cur, traits::begin(cur)));
+				throw;
+			}
+		}
+	}// namespace Detail
+
+	template<class ForwardIterator, class T>
+	void uninitialized_fill(ForwardIterator first, ForwardIterator last, const T& value) {
+		typedef typename segmented_iterator_traits<ForwardIterator>::is_segmented_iterator segmented;
+		Detail::uninit_fill_aux(first, last, value, segmented());
+	}
+
+	//********** [uninitialized_fill_n] ******************
+	namespace Detail {
+		template<class ForwardIterator, class Size, class T>
+		ForwardIterator uninit_fill_n_aux(ForwardIterator first, Size n, const T& value, random_access_iterator_tag) {
+			ForwardIterator last = first + n;
+			tinySTL::uninitialized_fill(first, last, value);
+			return last;
+		}
+		template<class ForwardIterator, class Size, class T>
+		ForwardIterator uninit_fill_n_aux(ForwardIterator first, Size n, const T& value, forward_iterator_tag) {
+			typedef typename value_type_of<ForwardIterator>::type U;
+			ForwardIterator cur = first;
+			try {
+				for (; n > 0; --n, ++cur) {
+					::new (static_cast<void*>(&*cur)) U(value);
+				}
+			}
+			catch (...) {
+				tinySTL::destroy(first, cur);
+				throw;
+			}
+			return cur;
+		}
+	}// namespace Detail
+
+	template<class ForwardIterator, class Size, class T>
+	inline ForwardIterator uninitialized_fill_n(ForwardIterator first, Size n, const T& value) {
+		return Detail::uninit_fill_n_aux(first, n, value, typename iterator_traits<ForwardIterator>::iterator_category());
+	}
+
+	//********** [allocator-aware versions] **************
+	/*
+	** Containers construct through their allocator. When allocator_traits
+	** would end in placement new anyway (allocator<T>, or an allocator
+	** without construct/destroy) the functions above are used; otherwise
+	** every element goes through allocator_traits::construct.
+	*/
+	template<class InputIterator, class ForwardIterator, class Alloc>
+	ForwardIterator uninitialized_copy_a(InputIterator first, InputIterator last, ForwardIterator result, Alloc& alloc);
+	template<class InputIterator, class ForwardIterator, class Alloc>
+	ForwardIterator uninitialized_move_a(InputIterator first, InputIterator last, ForwardIterator result, Alloc& alloc);
+
+	namespace Detail {
+		template<class Alloc, class Arg>
+		struct uses_placement_new : std::integral_constant<bool,
+			!has_construct<Alloc, typename Alloc::value_type, Arg>::value && !has_destroy<Alloc, typename Alloc::value_type>::value> {};
+		template<class T, class Arg>
+		struct uses_placement_new<allocator<T>, Arg> : std::true_type {};
+
+		template<class ForwardIterator, class Alloc>
+		void destroy_constructed_a(ForwardIterator first, ForwardIterator last, Alloc& alloc) {
+			for (; first != last; ++first) {
+				allocator_traits<Alloc>::destroy(alloc, &*first);
+			}
+		}
+		template<class InputIterator, class ForwardIterator, class Alloc>
+		ForwardIterator uninit_copy_a(InputIterator first, InputIterator last, ForwardIterator result, Alloc&, std::true_type) {
+			return tinySTL::uninitialized_copy(first, last, result);
+		}
+		template<class InputIterator, class ForwardIterator, class Alloc>
+		ForwardIterator uninit_copy_a(InputIterator first, InputIterator last, ForwardIterator result, Alloc& alloc, std::false_type) {
+			ForwardIterator cur = result;
+			try {
+				for (; first != last; ++first, ++cur) {
+					allocator_traits<Alloc>::construct(alloc, &*cur, *first);
+				}
+			}
+			catch (...) {
+				destroy_constructed_a(result, cur, alloc);
+				throw;
+			}
+			return cur;
+		}
+		template<class T, class Alloc>
+		T *uninit_move_if_noexcept_a(T *first, T *last, T *result, Alloc& alloc, std::true_type) {
+			return tinySTL::uninitialized_move_a(first, last, result, alloc);
+		}
+		template<class T, class Alloc>
+		T *uninit_move_if_noexcept_a(T *first, T *last, T *result, Alloc& alloc, std::false_type) {
+			return tinySTL::uninitialized_copy_a(static_cast<const T*>(first), static_cast<const T*>(last), result, alloc);
+		}
+		template<class T, class Alloc>
+		T *uninit_relocate_a(T *first, T *last, T *result, Alloc&, std::true_type) {
+			return tinySTL::uninitialized_relocate(first, last, result);
+		}
+		template<class T, class Alloc>
+		T *uninit_relocate_a(T *first, T *last, T *result, Alloc& alloc, std::false_type) {
+			T *cur = result;
+			try {
+				for (T *it = first; it != last; ++it, ++cur) {
+					allocator_traits<Alloc>::construct(alloc, cur, std::move_if_noexcept(*it));
+				}
+			}
+			catch (...) {
+				destroy_constructed_a(result, cur, alloc);
+				throw;
+			}
+			destroy_constructed_a(first, last, alloc);
+			return cur;
+		}
+		template<class ForwardIterator, class T, class Alloc>
+		void uninit_fill_a(ForwardIterator first, ForwardIterator last, const T& value, Alloc&, std::true_type) {
+			tinySTL::uninitialized_fill(first, last, value);
+		}
+		template<class ForwardIterator, class T, class Alloc>
+		void uninit_fill_a(ForwardIterator first, ForwardIterator last, const T& value, Alloc& alloc, std::false_type) {
+			ForwardIterator cur = first;
+			try {
+				for (; cur != last; ++cur) {
+					allocator_traits<Alloc>::construct(alloc, &*cur, value);
+				}
+			}
+			catch (...) {
+				destroy_constructed_a(first, cur, alloc);
+				throw;
+			}
+		}
+	}// namespace Detail
+
+	template<class InputIterator, class ForwardIterator, class Alloc>
+	ForwardIterator uninitialized_copy_a(InputIterator first, InputIterator last, ForwardIterator result, Alloc& alloc) {
+		typedef typename iterator_traits<InputIterator>::reference reference;
+		return Detail::uninit_copy_a(first, last, result, alloc, Detail::uses_placement_new<Alloc, reference>());
+	}
+	template<class InputIterator, class ForwardIterator, class Alloc>
+	ForwardIterator uninitialized_move_a(InputIterator first, InputIterator last, ForwardIterator result, Alloc& alloc) {
+		return tinySTL::uninitialized_copy_a(std::make_move_iterator(first), std::make_move_iterator(last), result, alloc);
+	}
+	// moves only if that cannot throw, so the sources survive a failed copy
+	template<class T, class Alloc>
+	T *uninitialized_move_if_noexcept_a(T *first, T *last, T *result, Alloc& alloc) {
+		return Detail::uninit_move_if_noexcept_a(first, last, result, alloc, std::integral_constant<bool,
+			std::is_nothrow_move_constructible<T>::value || !std::is_copy_constructible<T>::value>());
+	}
+	template<class T, class Alloc>
+	T *uninitialized_relocate_a(T *first, T *last, T *result, Alloc& alloc) {
+		return Detail::uninit_relocate_a(first, last, result, alloc, Detail::uses_placement_new<Alloc, T&&>());
+	}
+	template<class ForwardIterator, class T, class Alloc>
+	void uninitialized_fill_a(ForwardIterator first, ForwardIterator last, const T& value, Alloc& alloc) {
+		Detail::uninit_fill_a(first, last, value, alloc, Detail::uses_placement_new<Alloc, const T&>());
+	}
+} // namespace tinySTL
+
+#endif // _UNINITIALIZED_FUNCTIONS_H_
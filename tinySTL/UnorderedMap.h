@@ -0,0 +1,861 @@
+#ifndef _UNORDERED_MAP_H_
+#define _UNORDERED_MAP_H_
+
+#include "Allocator.h"
+#include "AllocatorTraits.h"
+#include "Functional.h"
+#include "Iterator.h"
+#include "Simd.h"
+#include "TypeTraits.h"
+#include "UninitializedFunctions.h"
+#include "Utility.h"
+
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace tinySTL {
+	namespace Detail {
+		/*
+		** One control byte per slot, kept apart from the slots so that a probe
+		** reads a whole group of them with one load and only touches the
+		** slots whose byte matches: EMPTY, or the low 7 bits (h2) of the hash of
+		** a full slot. A SENTINEL follows the last slot and a group of EMPTY bytes
+		** follows it, so a group load never reads past the array.
+		*/
+		typedef signed char ctrl_t;
+		enum ECtrl{ CTRL_EMPTY = -128, CTRL_SENTINEL = -1 };
+
+		// one bit per control byte of a group, 1 << Shift bits apart, lowest slot first
+		template<class T, unsigned Shift>
+		class ctrl_mask {
+			private:
+				T mask_;
+			public:
+				explicit ctrl_mask(T mask) :mask_(mask) {}
+				bool any() const { return mask_ != 0; }
+				size_t lowest() const { return count_trailing_zeros(mask_) >> Shift; }
+				void drop_lowest() { mask_ &= mask_ - 1; }
+				// the bits for the slots before the first one of other
+				ctrl_mask before(const ctrl_mask& other) const {
+					return ctrl_mask(other.mask_ ? mask_ & ((other.mask_ & (~other.mask_ + 1)) - 1) : mask_);
+				}
+		};
+
+#if TINYSTL_SSE2
+		class ctrl_group {
+			private:
+				__m128i ctrl_;
+			public:
+				enum EWidth{ WIDTH = 16 };
+				typedef ctrl_mask<unsigned, 0> mask_type;
+
+				explicit ctrl_group(const ctrl_t *p) :ctrl_(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p))) {}
+				mask_type match(ctrl_t h2) const {
+					return mask_type(static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl_))));
+				}
+				mask_type match_empty() const { return mask_type(match_empty_bits()); }
+				// full slots and the sentinel
+				mask_type match_non_empty() const { return mask_type(~match_empty_bits() & 0xFFFFu); }
+			private:
+				unsigned match_empty_bits() const {
+					return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(CTRL_EMPTY)), ctrl_)));
+				}
+		};
+#else
+		// eight bytes in a word; a byte matches when its top bit ends up set
+		class ctrl_group {
+			private:
+				unsigned long long ctrl_;
+				static unsigned long long lsbs() { return 0x0101010101010101ull; }
+				static unsigned long long msbs() { return 0x8080808080808080ull; }
+			public:
+				enum EWidth{ WIDTH = 8 };
+				typedef ctrl_mask<unsigned long long, 3> mask_type;
+
+				explicit ctrl_group(const ctrl_t *p) { memcpy(&ctrl_, p, sizeof(ctrl_)); }
+				// may report a byte above a real match, which the key comparison rejects
+				mask_type match(ctrl_t h2) const {
+					unsigned long long x = ctrl_ ^ (lsbs() * static_cast<unsigned char>(h2));
+					return mask_type((x - lsbs()) & ~x & msbs());
+				}
+				// exact: no other control byte value can borrow into a false EMPTY
+				mask_type match_empty() const { return match(static_cast<ctrl_t>(CTRL_EMPTY)); }
+				mask_type match_non_empty() const {
+					unsigned long long x = ctrl_ ^ (lsbs() * 0x80u);
+					return mask_type(~((x - lsbs()) & ~x & msbs()) & msbs());
+				}
+		};
+#endif
+
+		// a group of EMPTY bytes behind a SENTINEL: the control array of a table with no slots
+		inline ctrl_t *empty_ctrl() {
+			static const ctrl_t group[1 + 16] = {
+				CTRL_SENTINEL, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY,
+				CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY
+			};
+			return const_cast<ctrl_t *>(group);
+		}
+
+		// std::hash of an integer is often the integer itself: spread it over all the bits
+		inline size_t mix_hash(size_t h) {
+			unsigned long long m = static_cast<unsigned long long>(h) * 0x9E3779B97F4A7C15ull;
+			return static_cast<size_t>(m ^ (m >> 32));
+		}
+
+		template<class Hash, class KeyEqual, class = void>
+		struct is_transparent_lookup : std::false_type {};
+		template<class Hash, class KeyEqual>
+		struct is_transparent_lookup<Hash, KeyEqual,
+			typename voider<typename Hash::is_transparent, typename KeyEqual::is_transparent>::type> : std::true_type {};
+
+		template<class Key, class T, class Hash, class KeyEqual, class Alloc>
+		class hash_table;
+
+		// walks the control bytes a group at a time, so long runs of empty slots cost one load each
+		template<class Value, class Slot>
+		class hash_iter : public iterator<forward_iterator_tag, typename std::remove_const<Value>::type, ptrdiff_t, Value*, Value&> {
+			private:
+				template<class K, class T, class H, class E, class A>
+				friend class hash_table;
+				template<class V, class S>
+				friend class hash_iter;
+			public:
+				typedef typename std::remove_const<Value>::type value_type;
+				typedef ptrdiff_t difference_type;
+				typedef Value* pointer;
+				typedef Value& reference;
+			private:
+				ctrl_t *ctrl_;
+				Slot *slot_;
+			public:
+				hash_iter() :ctrl_(0), slot_(0) {}
+				// iterator -> const_iterator
+				template<class V, class = typename std::enable_if<std::is_convertible<V*, Value*>::value>::type>
+				hash_iter(const hash_iter<V, Slot>& it) :ctrl_(it.ctrl_), slot_(it.slot_) {}
+
+				reference operator *() const { return *reinterpret_cast<Value*>(slot_); }
+				pointer operator ->() const { return reinterpret_cast<Value*>(slot_); }
+				hash_iter& operator ++() {
+					++ctrl_;
+					++slot_;
+					skipEmpty();
+					return *this;
+				}
+				hash_iter operator ++(int) {
+					hash_iter temp = *this;
+					++*this;
+					return temp;
+				}
+				friend bool operator ==(const hash_iter& it1, const hash_iter& it2) { return it1.ctrl_ == it2.ctrl_; }
+				friend bool operator !=(const hash_iter& it1, const hash_iter& it2) { return it1.ctrl_ != it2.ctrl_; }
+			private:
+				hash_iter(ctrl_t *ctrl, Slot *slot) :ctrl_(ctrl), slot_(slot) {}
+				// stops at a full slot or at the sentinel
+				void skipEmpty() {
+					for (;;) {
+						typename ctrl_group::mask_type full = ctrl_group(ctrl_).match_non_empty();
+						if (full.any()) {
+							size_t n = full.lowest();
+							ctrl_ += n;
+							slot_ += n;
+							return;
+						}
+						ctrl_ += ctrl_group::WIDTH;
+						slot_ += ctrl_group::WIDTH;
+					}
+				}
+		};
+
+		/*
+		** Open addressing with linear probing that never wraps around: a key
+		** hashing to home slot i sits in the first free slot at or after i, and
+		** every slot in between is full. The homes are the first capacity_
+		** slots; overflow_ more slots behind them take the runs that spill over
+		** the end. A lookup loads the control bytes from the home slot a group
+		** at a time, compares keys only where h2 matches, and stops at the
+		** first EMPTY byte.
+		**
+		** Erase leaves no tombstone: the elements after the hole are moved
+		** back into it as far as their home allows (backward shift), so lookups
+		** never wade through deleted slots. Elements only ever move towards the
+		** front, which keeps erase-while-iterating correct, but an erase moves
+		** other elements and so invalidates references to them.
+		**
+		** Slots hold pair<Key, T> so that they can be moved; they are handed out
+		** as pair<const Key, T>.
+		*/
+		template<class Key, class T, class Hash, class KeyEqual, class Alloc>
+		class hash_table : private alloc_holder<Alloc> {
+			public:
+				typedef Key key_type;
+				typedef T mapped_type;
+				typedef pair<const Key, T> value_type;
+				typedef size_t size_type;
+				typedef ptrdiff_t difference_type;
+				typedef Hash hasher;
+				typedef KeyEqual key_equal;
+				typedef Alloc allocator_type;
+				typedef value_type& reference;
+				typedef const value_type& const_reference;
+				typedef value_type* pointer;
+				typedef const value_type* const_pointer;
+			private:
+				typedef pair<Key, T> slot_type;
+			public:
+				typedef hash_iter<value_type, slot_type> iterator;
+				typedef hash_iter<const value_type, slot_type> const_iterator;
+			private:
+				typedef allocator_traits<Alloc> dataTraits;
+				typedef typename dataTraits::template rebind_alloc<slot_type> slotAllocator;
+				typedef allocator_traits<slotAllocator> slotTraits;
+				typedef typename dataTraits::template rebind_alloc<ctrl_t> ctrlAllocator;
+				typedef allocator_traits<ctrlAllocator> ctrlTraits;
+				typedef typename dataTraits::template rebind_alloc<size_t> indexAllocator;
+				typedef allocator_traits<indexAllocator> indexTraits;
+				typedef alloc_holder<Alloc> holder;
+				typedef typename is_transparent_lookup<Hash, KeyEqual>::type transparent;
+				enum ECapacity{ MIN_CAPACITY = 16, WIDTH = ctrl_group::WIDTH };
+			private:
+				ctrl_t *ctrl_;
+				slot_type *slots_;
+				size_t mask_;		// capacity_ - 1, home slot = (hash >> 7) & mask_
+				size_t capacity_;	// a power of two, or 0 with no slots at all
+				size_t overflow_;
+				size_t size_;
+				Hash hash_;
+				KeyEqual eq_;
+			public:
+				hash_table() :holder(), ctrl_(empty_ctrl()), slots_(0), mask_(0), capacity_(0), overflow_(0), size_(0), hash_(), eq_() {}
+				explicit hash_table(size_type bucket_count, const Hash& hash = Hash(), const KeyEqual& eq = KeyEqual(),
+					const allocator_type& alloc = allocator_type());
+				template<class InputIterator>
+				hash_table(InputIterator first, InputIterator last, size_type bucket_count = 0, const Hash& hash = Hash(),
+					const KeyEqual& eq = KeyEqual(), const allocator_type& alloc = allocator_type());
+				hash_table(std::initializer_list<value_type> list, size_type bucket_count = 0, const Hash& hash = Hash(),
+					const KeyEqual& eq = KeyEqual(), const allocator_type& alloc = allocator_type());
+				explicit hash_table(const allocator_type& alloc);
+				hash_table(const hash_table& other);
+				hash_table(hash_table&& other);
+				~hash_table();
+
+				hash_table& operator = (const hash_table& other);
+				hash_table& operator = (hash_table&& other);
+
+				iterator begin() { return beginAt<iterator>(); }
+				const_iterator begin() const { return beginAt<const_iterator>(); }
+				iterator end() { return iterator(ctrl_ + slotCount(), slots_ + slotCount()); }
+				const_iterator end() const { return const_iterator(ctrl_ + slotCount(), slots_ + slotCount()); }
+				const_iterator cbegin() const { return begin(); }
+				const_iterator cend() const { return end(); }
+
+				allocator_type get_allocator() const { return this->get_alloc(); }
+				hasher hash_function() const { return hash_; }
+				key_equal key_eq() const { return eq_; }
+			public:
+				size_type size() const { return size_; }
+				bool empty() const { return size_ == 0; }
+				size_type max_size() const { return slotTraits::max_size(slotAllocator(this->get_alloc())); }
+
+				// home slots, and how full they may get before the table doubles
+				size_type bucket_count() const { return capacity_; }
+				float load_factor() const { return capacity_ ? float(size_) / capacity_ : 0.0f; }
+				float max_load_factor() const { return 0.75f; }
+				void reserve(size_type n);
+				void rehash(size_type n);
+
+				pair<iterator, bool> insert(const value_type& value) { return emplace(value); }
+				pair<iterator, bool> insert(value_type&& value) { return emplace(std::move(value)); }
+				template<class InputIterator>
+				void insert(InputIterator first, InputIterator last);
+				void insert(std::initializer_list<value_type> list) { insert(list.begin(), list.end()); }
+				template<class... Args>
+				pair<iterator, bool> emplace(Args&&... args);
+				// builds the element only if key is not there yet
+				template<class... Args>
+				pair<iterator, bool> try_emplace(const key_type& key, Args&&... args) { return tryEmplace(key, std::forward<Args>(args)...); }
+				template<class... Args>
+				pair<iterator, bool> try_emplace(key_type&& key, Args&&... args) { return tryEmplace(std::move(key), std::forward<Args>(args)...); }
+				mapped_type& operator [](const key_type& key) { return tryEmplace(key).first->second; }
+				mapped_type& operator [](key_type&& key) { return tryEmplace(std::move(key)).first->second; }
+				mapped_type& at(const key_type& key);
+				const mapped_type& at(const key_type& key) const;
+
+				iterator erase(const_iterator pos);
+				iterator erase(const_iterator first, const_iterator last);
+				size_type erase(const key_type& key) { return eraseKey(key); }
+				void clear();
+				void swap(hash_table& other);
+
+				/*
+				** With Hash::is_transparent and KeyEqual::is_transparent the lookups
+				** take any K that both accept, so that e.g. a const char* finds a
+				** std::string key without building one.
+				*/
+				iterator find(const key_type& key) { return iteratorAt<iterator>(findIndex(key)); }
+				const_iterator find(const key_type& key) const { return iteratorAt<const_iterator>(findIndex(key)); }
+				size_type count(const key_type& key) const { return findIndex(key) != npos() ? 1 : 0; }
+				bool contains(const key_type& key) const { return findIndex(key) != npos(); }
+				pair<iterator, iterator> equal_range(const key_type& key) { return rangeAt<iterator>(findIndex(key)); }
+				pair<const_iterator, const_iterator> equal_range(const key_type& key) const { return rangeAt<const_iterator>(findIndex(key)); }
+
+				template<class K, class = typename std::enable_if<transparent::value, K>::type>
+				iterator find(const K& key) { return iteratorAt<iterator>(findIndex(key)); }
+				template<class K, class = typename std::enable_if<transparent::value, K>::type>
+				const_iterator find(const K& key) const { return iteratorAt<const_iterator>(findIndex(key)); }
+				template<class K, class = typename std::enable_if<transparent::value, K>::type>
+				size_type count(const K& key) const { return findIndex(key) != npos() ? 1 : 0; }
+				template<class K, class = typename std::enable_if<transparent::value, K>::type>
+				bool contains(const K& key) const { return findIndex(key) != npos(); }
+				template<class K, class = typename std::enable_if<transparent::value, K>::type>
+				pair<iterator, iterator> equal_range(const K& key) { return rangeAt<iterator>(findIndex(key)); }
+				template<class K, class = typename std::enable_if<transparent::value, K>::type>
+				pair<const_iterator, const_iterator> equal_range(const K& key) const { return rangeAt<const_iterator>(findIndex(key)); }
+				// never for iterators, which must reach erase(const_iterator)
+				template<class K, class = typename std::enable_if<transparent::value
+					&& !std::is_convertible<K, iterator>::value && !std::is_convertible<K, const_iterator>::value, K>::type>
+				size_type erase(const K& key) { return eraseKey(key); }
+			private:
+				static size_t npos() { return size_t(-1); }
+				size_t slotCount() const { return capacity_ + overflow_; }
+				size_t maxLoad() const { return capacity_ - capacity_ / 4; }
+				static size_t capacityFor(size_t n);
+				template<class K>
+				size_t hashOf(const K& key) const { return mix_hash(hash_(key)); }
+				size_t home(size_t hash) const { return (hash >> 7) & mask_; }
+				static ctrl_t h2(size_t hash) { return static_cast<ctrl_t>(hash & 0x7F); }
+				template<class Iterator>
+				Iterator iteratorAt(size_t index) const {
+					return index == npos() ? Iterator(ctrl_ + slotCount(), slots_ + slotCount()) : Iterator(ctrl_ + index, slots_ + index);
+				}
+				template<class Iterator>
+				Iterator beginAt() const {
+					Iterator it(ctrl_, slots_);
+					it.skipEmpty();
+					return it;
+				}
+				template<class Iterator>
+				pair<Iterator, Iterator> rangeAt(size_t index) const {
+					if (index == npos()) return pair<Iterator, Iterator>(iteratorAt<Iterator>(index), iteratorAt<Iterator>(index));
+					return pair<Iterator, Iterator>(Iterator(ctrl_ + index, slots_ + index), Iterator(ctrl_ + index + 1, slots_ + index + 1));
+				}
+				template<class K>
+				size_t findIndex(const K& key) const;
+				template<class K>
+				size_t probe(const K& key, size_t hash, bool& found) const;
+				size_t firstEmpty(const ctrl_t *ctrl, size_t pos) const;
+				size_t prepareInsert(size_t hash);
+				template<class K, class... Args>
+				pair<iterator, bool> tryEmplace(K&& key, Args&&... args);
+				template<class K>
+				size_type eraseKey(const K& key);
+				void eraseAt(size_t index);
+				void relocateSlot(slot_type *dst, slot_type *src);
+				void resize(size_t capacity, size_t overflow);
+				void destroySlots();
+				void freeArrays(ctrl_t *ctrl, slot_type *slots, size_t slotCount);
+				void copyFrom(const hash_table& other);
+				void swapData(hash_table& other);
+		};
+
+		template<class Key, class T, class Hash, class KeyEqual, class Alloc>
+		hash_table<Key, T, Hash, KeyEqual, Alloc>::hash_table(size_type bucket_count, const Hash& hash, const KeyEqual& eq,
+			const allocator_type& alloc)
+			:holder(alloc), ctrl_(empty_ctrl()), slots_(0), mask_(0), capacity_(0), overflow_(0), size_(0), hash_(hash), eq_(eq) {
+			rehash(bucket_count);
+		}
+		template<class Key, class T, class Hash, class KeyEqual, class Alloc>
+		template<class InputIterator>
+		hash_table<Key, T, Hash, KeyEqual, Alloc>::hash_table(InputIterator first, InputIterator last, size_type bucket_count,
+			const Hash& hash, const KeyEqual& eq, const allocator_type& alloc)
+			:holder(alloc), ctrl_(empty_ctrl()), slots_(0), mask_(0), capacity_(0), overflow_(0), size_(0), hash_(hash), eq_(eq) {
+			try {
+				rehash(bucket_count);
+				insert(first, last);
+			}
+			catch (...) {
+				destroySlots();
+				freeArrays(ctrl_, slots_, slotCount());
+				throw;
+			}
+		}
+		template<class Key, class T, class Hash, class KeyEqual, class Alloc>
+		hash_table<Key, T, Hash, KeyEqual, Alloc>::hash_table(std::initializer_list<value_type> list, size_type bucket_count,
+			const Hash& hash, const KeyEqual& eq, const allocator_type& alloc)
+			:hash_table(list.begin(), list.end(), bucket_count, hash, eq, alloc) {}
+		template<class Key, class T, class Hash, class KeyEqual, class Alloc>
+		hash_table<Key, T, Hash, KeyEqual, Alloc>::hash_table(const allocator_type& alloc)
+			:holder(alloc), ctrl_(empty_ctrl()), slots_(0), mask_(0), capacity_(0), overflow_(0), size_(0), hash_(), eq_() {}
+		template<class Key, class T, class Hash, class KeyEqual, class Alloc>
+		hash_table<Key, T, Hash, KeyEqual, Alloc>::hash_table(const hash_table& other)
+			:holder(dataTraits::select_on_container_copy_construction(other.get_alloc())),
+			ctrl_(empty_ctrl()), slots_(0), mask_(0), capacity_(0), overflow_(0), size_(0), hash_(other.hash_), eq_(other.eq_) {
+			copyFrom(other);
+		}
+		template<class Key, class T, class Hash, class KeyEqual, class Alloc>
+		hash_table<Key, T, Hash, KeyEqual, Alloc>::hash_table(hash_table&& other)
+			:holder(other.get_alloc()), ctrl_(empty_ctrl()), slots_(0), mask_(0), capacity_(0), overflow_(0), size_(0),
+			hash_(other.hash_), eq_(other.eq_) {
+			swapData(other);
+		}
+		template<class Key, class T, class Hash, class KeyEqual, class Alloc>
+		hash_table<Key, T, Hash, KeyEqual, Alloc>::~hash_table() {
+			destroySlots();
+			freeArrays(ctrl_, slots_, slotCount());
+		}
+
+		template<class Key, class T, class Hash, class KeyEqual, class Alloc>
+		hash_table<Key, T, Hash, KeyEqual, Alloc>& hash_table<Key, T, Hash, KeyEqual, Alloc>::operator = (const hash_table& other) {
+			if (this != &other) {
+				// build the copy with the allocator this table will end up with
+				const bool propagate = dataTraits::propagate_on_container_copy_assignment::value;
+				hash_table temp(propagate ? other.get_alloc() : this->get_alloc());
+				temp.hash_ = other.hash_;
+				temp.eq_ = other.eq_;
+				temp.copyFrom(other);
+				swapData(temp);
+				if (propagate) {
+					tinySTL::swap(this->get_alloc(), temp.get_alloc());
+				}
+			}
+			return *this;
+		}
+		template<class Key, class T, class Hash, class KeyEqual, class Alloc>
+		hash_table<Key, T, Hash, KeyEqual, Alloc>& hash_table<Key, T, Hash, KeyEqual, Alloc>::operator = (hash_table&& other) {
+			if (this == &other) return *this;
+			if (dataTraits::propagate_on_container_move_assignment::value
+				|| dataTraits::is_always_equal::value || this->get_alloc() == other.get_alloc()) {
+				// take other's arrays; other gets ours and frees them with its own allocator
+				swapData(other);
+				if (dataTraits::propagate_on_container_move_assignment::value) {
+					tinySTL::swap(this->get_alloc(), other.get_alloc());
+				}
+				other.clear();
+			}
+			else {
+				// the arrays belong to another allocator: move the elements instead
+				hash_table temp(this->get_alloc());
+				temp.hash_ = other.hash_;
+				temp.eq_ = other.eq_;
+				temp.reserve(other.size());
+				for (iterator it = other.begin(); it != other.end(); ++it) {
+					temp.emplace(std::move(*reinterpret_cast<slot_type*>(&*it)));
+				}
+				swapData(temp);
+			}
+			return *this;
+		}
+
+		template<class Key, class T, class Hash, class KeyEqual, class Alloc>
+		void hash_table<Key, T, Hash, KeyEqual, Alloc>::reserve(size_type n) {
+			size_t cap = capacityFor(n);
+			if (cap > capacity_) {
+				resize(cap, cap / 8 > size_t(WIDTH) ? cap / 8 : size_t(WIDTH));
+			}
+		}
+		// at least n home slots, and room for the elements there are
+		template<class Key, class T, class Hash, class KeyEqual, class Alloc>
+		void hash_table<Key, T, Hash, KeyEqual, Alloc>::rehash(size_type n) {
+			size_t cap = capacityFor(size_);
+			if (n != 0 && cap < size_t(MIN_CAPACITY)) cap = MIN_CAPACITY;
+			if (cap == 0) {
+				// empty and nothing asked for: back to the shared control bytes of a table with no slots
+				freeArrays(ctrl_, slots_, slotCount());
+				ctrl_ = empty_ctrl();
+				slots_ = 0;
+				mask_ = 0;
+				capacity_ = 0;
+				overflow_ = 0;
+				return;
+			}
+			while (cap < n) cap <<= 1;
+			if (cap != capacity_) {
+				resize(cap, cap / 8 > size_t(WIDTH) ? cap / 8 : size_t(WIDTH));
+			}
+		}
+
+		template<class Key, class T, class Hash, class KeyEqual, class Alloc>
+		template<class InputIterator>
+		void hash_table<Key, T, Hash, KeyEqual, Alloc>::insert(InputIterator first, InputIterator last) {
+			for (; first != last; ++first) {
+				emplace(*first);
+			}
+		}
+		// the element is built first to learn its key; it is dropped if the key is already there
+		template<class Key, class T, class Hash, class KeyEqual, class Alloc>
+		template<class... Args>
+		pair<typename hash_table<Key, T, Hash, KeyEqual, Alloc>::iterator, bool>
+			hash_table<Key, T, Hash, KeyEqual, Alloc>::emplace(Args&&... args) {
+			slot_type temp(std::forward<Args>(args)...);
+			size_t hash = hashOf(temp.first);
+			bool found;
+			size_t index = probe(temp.first, hash, found);
+			if (found) return pair<iterator, bool>(iteratorAt<iterator>(index), false);
+			index = prepareInsert(hash);
+			slotAllocator alloc(this->get_alloc());
+			slotTraits::construct(alloc, slots_ + index, std::move(temp));
+			ctrl_[index] = h2(hash);
+			++size_;
+			return pair<iterator, bool>(iteratorAt<iterator>(index), true);
+		}
+		template<class Key, class T, class Hash, class KeyEqual, class Alloc>
+		template<class K, class... Args>
+		pair<typename hash_table<Key, T, Hash, KeyEqual, Alloc>::iterator, bool>
+			hash_table<Key, T, Hash, KeyEqual, Alloc>::tryEmplace(K&& key, Args&&... args) {
+			size_t hash = hashOf(key);
+			bool found;
+			size_t index = probe(key, hash, found);
+			if (found) return pair<iterator, bool>(iteratorAt<iterator>(index), false);
+			index = prepareInsert(hash);
+			slotAllocator alloc(this->get_alloc());
+			slotTraits::construct(alloc, slots_ + index, std::piecewise_construct,
+				std::forward_as_tuple(std::forward<K>(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+			ctrl_[index] = h2(hash);
+			++size_;
+			return pair<iterator, bool>(iteratorAt<iterator>(index), true);
+		}
+		template<class Key, class T, class Hash, class KeyEqual, class Alloc>
+		typename hash_table<Key, T, Hash, KeyEqual, Alloc>::mapped_type& hash_table<Key, T, Hash, KeyEqual, Alloc>::at(const key_type& key) {
+			size_t index = findIndex(key);
+			if (index == npos()) throw std::out_of_range("tinySTL::unordered_map::at");
+			return slots_[index].second;
+		}
+		template<class Key, class T, class Hash, class KeyEqual, class Alloc>
+		const typename hash_table<Key, T, Hash, KeyEqual, Alloc>::mapped_type& hash_table<Key, T, Hash, KeyEqual, Alloc>::at(const key_type& key) const {
+			size_t index = findIndex(key);
+			if (index == npos()) throw std::out_of_range("tinySTL::unordered_map::at");
+			return slots_[index].second;
+		}
+
+		// the element moved into pos, if any, has not been visited yet, so pos is the next one
+		template<class Key, class T, class Hash, class KeyEqual, class Alloc>
+		typename hash_table<Key, T, Hash, KeyEqual, Alloc>::iterator hash_table<Key, T, Hash, KeyEqual, Alloc>::erase(const_iterator pos) {
+			iterator it(pos.ctrl_, pos.slot_);
+			eraseAt(pos.ctrl_ - ctrl_);
+			it.skipEmpty();
+			return it;
+		}
+		/*
+		** Back to front: erasing a slot only moves elements behind it, so the
+		** ones of the range still to go stay where they are. What is left from
+		** first on is last's element and everything that followed it.
+		*/
+		template<class Key, class T, class Hash, class KeyEqual, class Alloc>
+		typename hash_table<Key, T, Hash, KeyEqual, Alloc>::iterator
+			hash_table<Key, T, Hash, KeyEqual, Alloc>::erase(const_iterator first, const_iterator last) {
+			const size_t from = first.ctrl_ - ctrl_;
+			for (size_t i = last.ctrl_ - ctrl_; i != from; ) {
+				if (ctrl_[--i] >= 0) eraseAt(i);
+			}
+			iterator it(first.ctrl_, first.slot_);
+			it.skipEmpty();
+			return it;
+		}
+		template<class Key, class T, class Hash, class KeyEqual, class Alloc>
+		void hash_table<Key, T, Hash, KeyEqual, Alloc>::clear() {
+			destroySlots();
+			if (capacity_ != 0) {
+				memset(ctrl_, CTRL_EMPTY, slotCount());
+			}
+			size_ = 0;
+		}
+		template<class Key, class T, class Hash, class KeyEqual, class Alloc>
+		void hash_table<Key, T, Hash, KeyEqual, Alloc>::swap(hash_table& other) {
+			swapData(other);
+			if (dataTraits::propagate_on_container_swap::value) {
+				tinySTL::swap(this->get_alloc(), other.get_alloc());
+			}
+		}
+
+		template<class Key, class T, class Hash, class KeyEqual, class Alloc>
+		size_t hash_table<Key, T, Hash, KeyEqual, Alloc>::capacityFor(size_t n) {
+			if (n == 0) return 0;
+			size_t cap = MIN_CAPACITY;
+			while (cap - cap / 4 < n) cap <<= 1;
+			return cap;
+		}
+		template<class Key, class T, class Hash, class KeyEqual, class Alloc>
+		template<class K>
+		inline size_t hash_table<Key, T, Hash, KeyEqual, Alloc>::findIndex(const K& key) const {
+			bool found;
+			size_t index = probe(key, hashOf(key), found);
+			return found ? index : npos();
+		}
+		/*
+		** The slot holding key, or else the first EMPTY slot of its run, which
+		** may lie past the last slot.
+		*/
+		template<class Key, class T, class Hash, class KeyEqual, class Alloc>
+		template<class K>
+		size_t hash_table<Key, T, Hash, KeyEqual, Alloc>::probe(const K& key, size_t hash, bool& found) const {
+			const ctrl_t tag = h2(hash);
+			size_t pos = home(hash);
+			for (;;) {
+				ctrl_group group(ctrl_ + pos);
+				typename ctrl_group::mask_type empty = group.match_empty();
+				for (typename ctrl_group::mask_type match = group.match(tag).before(empty); match.any(); match.drop_lowest()) {
+					size_t index = pos + match.lowest();
+					if (eq_(slots_[index].first, key)) {
+						found = true;
+						return index;
+					}
+				}
+				if (empty.any()) {
+					found = false;
+					return pos + empty.lowest();
+				}
+				pos += WIDTH;
+			}
+		}
+		template<class Key, class T, class Hash, class KeyEqual, class Alloc>
+		inline size_t hash_table<Key, T, Hash, KeyEqual, Alloc>::firstEmpty(const ctrl_t *ctrl, size_t pos) const {
+			for (;;) {
+				typename ctrl_group::mask_type empty = ctrl_group(ctrl + pos).match_empty();
+				if (empty.any()) return pos + empty.lowest();
+				pos += WIDTH;
+			}
+		}
+		/*
+		** A free slot for a new element with this hash, growing the table first
+		** when it is full or when the run would spill past the overflow slots.
+		** A spill in a table that is not even half full means the hashes pile
+		** up, so then only the overflow area grows.
+		*/
+		template<class Key, class T, class Hash, class KeyEqual, class Alloc>
+		size_t hash_table<Key, T, Hash, KeyEqual, Alloc>::prepareInsert(size_t hash) {
+			if (size_ + 1 > maxLoad()) {
+				reserve(size_ + 1);
+			}
+			for (;;) {
+				size_t index = firstEmpty(ctrl_, home(hash));
+				if (index < slotCount()) return index;
+				if (size_ + 1 > capacity_ / 2) {
+					resize(capacity_ * 2, overflow_);
+				}
+				else {
+					resize(capacity_, overflow_ * 2);
+				}
+			}
+		}
+		template<class Key, class T, class Hash, class KeyEqual, class Alloc>
+		template<class K>
+		typename hash_table<Key, T, Hash, KeyEqual, Alloc>::size_type hash_table<Key, T, Hash, KeyEqual, Alloc>::eraseKey(const K& key) {
+			size_t index = findIndex(key);
+			if (index == npos()) return 0;
+			eraseAt(index);
+			return 1;
+		}
+		// backward shift: pull each later element of the run into the hole if its home allows
+		template<class Key, class T, class Hash, class KeyEqual, class Alloc>
+		void hash_table<Key, T, Hash, KeyEqual, Alloc>::eraseAt(size_t index) {
+			slotAllocator alloc(this->get_alloc());
+			slotTraits::destroy(alloc, slots_ + index);
+			size_t hole = index;
+			for (size_t next = index + 1; ctrl_[next] >= 0; ++next) {
+				if (home(hashOf(slots_[next].first)) <= hole) {
+					relocateSlot(slots_ + hole, slots_ + next);
+					ctrl_[hole] = ctrl_[next];
+					hole = next;
+				}
+			}
+			ctrl_[hole] = CTRL_EMPTY;
+			--size_;
+		}
+		template<class Key, class T, class Hash, class KeyEqual, class Alloc>
+		inline void hash_table<Key, T, Hash, KeyEqual, Alloc>::relocateSlot(slot_type *dst, slot_type *src) {
+			if (is_trivially_relocatable<slot_type>::value && Detail::uses_placement_new<slotAllocator, slot_type&&>::value) {
+				memcpy(static_cast<void*>(dst), static_cast<const void*>(src), sizeof(slot_type));
+			}
+			else {
+				slotAllocator alloc(this->get_alloc());
+				slotTraits::construct(alloc, dst, std::move(*src));
+				slotTraits::destroy(alloc, src);
+			}
+		}
+		/*
+		** Move every element to new arrays of capacity + overflow slots. The
+		** new places are worked out on the control bytes alone, so if a run
+		** spills over the end the overflow grows and nothing has moved yet.
+		** Elements are moved only if that cannot throw; if a copy throws the
+		** table is left as it was.
+		*/
+		template<class Key, class T, class Hash, class KeyEqual, class Alloc>
+		void hash_table<Key, T, Hash, KeyEqual, Alloc>::resize(size_t capacity, size_t overflow) {
+			ctrlAllocator ctrlAlloc(this->get_alloc());
+			slotAllocator slotAlloc(this->get_alloc());
+			indexAllocator indexAlloc(this->get_alloc());
+			const size_t oldCount = slotCount();
+			const size_t newMask = capacity - 1;
+			ctrl_t *ctrl = 0;
+			size_t *places = size_ ? indexTraits::allocate(indexAlloc, size_) : 0;
+			size_t count;
+			try {
+				for (;;) {
+					count = capacity + overflow;
+					ctrl = ctrlTraits::allocate(ctrlAlloc, count + 1 + WIDTH);
+					memset(ctrl, CTRL_EMPTY, count + 1 + WIDTH);
+					ctrl[count] = CTRL_SENTINEL;
+					size_t k = 0, i = 0;
+					for (; i != oldCount; ++i) {
+						if (ctrl_[i] < 0) continue;
+						size_t hash = hashOf(slots_[i].first);
+						size_t index = firstEmpty(ctrl, (hash >> 7) & newMask);
+						if (index >= count) break;
+						ctrl[index] = h2(hash);
+						places[k++] = index;
+					}
+					if (i == oldCount) break;
+					ctrlTraits::deallocate(ctrlAlloc, ctrl, count + 1 + WIDTH);
+					ctrl = 0;
+					overflow *= 2;
+				}
+			}
+			catch (...) {
+				// the hash threw while placing the elements
+				if (ctrl) ctrlTraits::deallocate(ctrlAlloc, ctrl, count + 1 + WIDTH);
+				if (places) indexTraits::deallocate(indexAlloc, places, size_);
+				throw;
+			}
+			slot_type *slots = 0;
+			try {
+				slots = slotTraits::allocate(slotAlloc, count);
+			}
+			catch (...) {
+				ctrlTraits::deallocate(ctrlAlloc, ctrl, count + 1 + WIDTH);
+				if (places) indexTraits::deallocate(indexAlloc, places, size_);
+				throw;
+			}
+			size_t k = 0;
+			if (is_trivially_relocatable<slot_type>::value && Detail::uses_placement_new<slotAllocator, slot_type&&>::value) {
+				for (size_t i = 0; i != oldCount; ++i) {
+					if (ctrl_[i] >= 0) relocateSlot(slots + places[k++], slots_ + i);
+				}
+			}
+			else {
+				size_t i = 0;
+				try {
+					for (; i != oldCount; ++i) {
+						if (ctrl_[i] < 0) continue;
+						slotTraits::construct(slotAlloc, slots + places[k], std::move_if_noexcept(slots_[i]));
+						++k;
+					}
+				}
+				catch (...) {
+					for (size_t j = 0; j != k; ++j) slotTraits::destroy(slotAlloc, slots + places[j]);
+					freeArrays(ctrl, slots, count);
+					indexTraits::deallocate(indexAlloc, places, size_);
+					throw;
+				}
+				destroySlots();
+			}
+			if (places) indexTraits::deallocate(indexAlloc, places, size_);
+			freeArrays(ctrl_, slots_, oldCount);
+			ctrl_ = ctrl;
+			slots_ = slots;
+			capacity_ = capacity;
+			mask_ = newMask;
+			overflow_ = overflow;
+		}
+		template<class Key, class T, class Hash, class KeyEqual, class Alloc>
+		void hash_table<Key, T, Hash, KeyEqual, Alloc>::destroySlots() {
+			if (std::is_trivially_destructible<slot_type>::value || size_ == 0) return;
+			slotAllocator alloc(this->get_alloc());
+			const size_t count = slotCount();
+			for (size_t i = 0; i != count; ++i) {
+				if (ctrl_[i] >= 0) slotTraits::destroy(alloc, slots_ + i);
+			}
+		}
+		template<class Key, class T, class Hash, class KeyEqual, class Alloc>
+		void hash_table<Key, T, Hash, KeyEqual, Alloc>::freeArrays(ctrl_t *ctrl, slot_type *slots, size_t slotCount) {
+			if (ctrl == empty_ctrl()) return;
+			ctrlAllocator ctrlAlloc(this->get_alloc());
+			slotAllocator slotAlloc(this->get_alloc());
+			ctrlTraits::deallocate(ctrlAlloc, ctrl, slotCount + 1 + WIDTH);
+			slotTraits::deallocate(slotAlloc, slots, slotCount);
+		}
+		// same hash, same shape: every element goes to the slot it has in other
+		template<class Key, class T, class Hash, class KeyEqual, class Alloc>
+		void hash_table<Key, T, Hash, KeyEqual, Alloc>::copyFrom(const hash_table& other) {
+			if (other.size_ == 0) return;
+			ctrlAllocator ctrlAlloc(this->get_alloc());
+			slotAllocator slotAlloc(this->get_alloc());
+			const size_t count = other.slotCount();
+			ctrl_t *ctrl = ctrlTraits::allocate(ctrlAlloc, count + 1 + WIDTH);
+			slot_type *slots;
+			try {
+				slots = slotTraits::allocate(slotAlloc, count);
+			}
+			catch (...) {
+				ctrlTraits::deallocate(ctrlAlloc, ctrl, count + 1 + WIDTH);
+				throw;
+			}
+			size_t i = 0;
+			try {
+				for (; i != count; ++i) {
+					if (other.ctrl_[i] >= 0) slotTraits::construct(slotAlloc, slots + i, other.slots_[i]);
+				}
+			}
+			catch (...) {
+				for (size_t j = 0; j != i; ++j) {
+					if (other.ctrl_[j] >= 0) slotTraits::destroy(slotAlloc, slots + j);
+				}
+				freeArrays(ctrl, slots, count);
+				throw;
+			}
+			memcpy(ctrl, other.ctrl_, count + 1 + WIDTH);
+			ctrl_ = ctrl;
+			slots_ = slots;
+			mask_ = other.mask_;
+			capacity_ = other.capacity_;
+			overflow_ = other.overflow_;
+			size_ = other.size_;
+		}
+		template<class Key, class T, class Hash, class KeyEqual, class Alloc>
+		void hash_table<Key, T, Hash, KeyEqual, Alloc>::swapData(hash_table& other) {
+			tinySTL::swap(ctrl_, other.ctrl_);
+			tinySTL::swap(slots_, other.slots_);
+			tinySTL::swap(mask_, other.mask_);
+			tinySTL::swap(capacity_, other.capacity_);
+			tinySTL::swap(overflow_, other.overflow_);
+			tinySTL::swap(size_, other.size_);
+			tinySTL::swap(hash_, other.hash_);
+			tinySTL::swap(eq_, other.eq_);
+		}
+	}// namespace Detail
+
+	// class unordered_map
+	// an open-addressing hash map; see Detail::hash_table for the layout
+	template<class Key, class T, class Hash = hash<Key>, class KeyEqual = equal_to<Key>,
+		class Alloc = allocator<pair<const Key, T> > >
+	class unordered_map : public Detail::hash_table<Key, T, Hash, KeyEqual, Alloc> {
+		private:
+			typedef Detail::hash_table<Key, T, Hash, KeyEqual, Alloc> base;
+		public:
+			using base::base;
+			unordered_map() {}
+	};
+
+	template<class Key, class T, class Hash, class KeyEqual, class Alloc>
+	bool operator ==(const unordered_map<Key, T, Hash, KeyEqual, Alloc>& m1, const unordered_map<Key, T, Hash, KeyEqual, Alloc>& m2) {
+		if (m1.size() != m2.size()) return false;
+		for (typename unordered_map<Key, T, Hash, KeyEqual, Alloc>::const_iterator it = m1.begin(); it != m1.end(); ++it) {
+			typename unordered_map<Key, T, Hash, KeyEqual, Alloc>::const_iterator other = m2.find(it->first);
+			if (other == m2.end() || !(other->second == it->second)) return false;
+		}
+		return true;
+	}
+	template<class Key, class T, class Hash, class KeyEqual, class Alloc>
+	bool operator !=(const unordered_map<Key, T, Hash, KeyEqual, Alloc>& m1, const unordered_map<Key, T, Hash, KeyEqual, Alloc>& m2) {
+		return !(m1 == m2);
+	}
+	template<class Key, class T, class Hash, class KeyEqual, class Alloc>
+	void swap(unordered_map<Key, T, Hash, KeyEqual, Alloc>& m1, unordered_map<Key, T, Hash, KeyEqual, Alloc>& m2) {
+		m1.swap(m2);
+	}
+} // namespace tinySTL
+
+#endif // _UNORDERED_MAP_H_
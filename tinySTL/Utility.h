@@ -1,6 +1,11 @@
 #ifndef _UTILITY_H_
 #define _UTILITY_H_
 
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
 namespace tinySTL {
 	//******[swap]*********//
 	template<class T>
@@ -20,33 +25,61 @@ namespace tinySTL {
 			T2 second;
 		public:
 			pair() {}
+			pair(const pair&) = default;
+			pair(pair&&) = default;
 			template<class U, class V>
 			pair(const pair<U, V>& p);
+			template<class U, class V>
+			pair(pair<U, V>&& p);
 			pair(const first_type& a, const second_type& b);
+			template<class U, class V, class = typename std::enable_if<
+				std::is_constructible<T1, U&&>::value && std::is_constructible<T2, V&&>::value>::type>
+			pair(U&& a, V&& b);
+			// first and second built in place from the two argument tuples
+			template<class... Args1, class... Args2>
+			pair(std::piecewise_construct_t, std::tuple<Args1...> a, std::tuple<Args2...> b);
 			pair& operator =(const pair& p);
+			pair& operator =(pair&& p);
 			void swap(pair& p);
+		private:
+			template<class Tuple1, class Tuple2, size_t... I1, size_t... I2>
+			pair(Tuple1& a, Tuple2& b, std::index_sequence<I1...>, std::index_sequence<I2...>);
 		public:
-			template<class T1, class T2>
-			friend bool operator==(const pair<T1, T2>& p1, const pair<T1, T2>& p2);
-			template<class T1, class T2>
-			friend bool operator!=(const pair<T1, T2>& p1, const pair<T1, T2>& p2);
-			template<class T1, class T2>
-			friend bool operator<(const pair<T1, T2>& p1, const pair<T1, T2>& p2);
-			template<class T1, class T2>
-			friend bool operator>(const pair<T1, T2>& p1, const pair<T1, T2>& p2);
-			template<class T1, class T2>
-			friend bool operator<=(const pair<T1, T2>& p1, const pair<T1, T2>& p2);
-			template<class T1, class T2>
-			friend bool operator>=(const pair<T1, T2>& p1, const pair<T1, T2>& p2);
-			template<class T1, class T2>
-			friend void swap(pair<T1, T2>& p1, pair<T1, T2>& p2);
+			template<class U1, class U2>
+			friend bool operator==(const pair<U1, U2>& p1, const pair<U1, U2>& p2);
+			template<class U1, class U2>
+			friend bool operator!=(const pair<U1, U2>& p1, const pair<U1, U2>& p2);
+			template<class U1, class U2>
+			friend bool operator<(const pair<U1, U2>& p1, const pair<U1, U2>& p2);
+			template<class U1, class U2>
+			friend bool operator>(const pair<U1, U2>& p1, const pair<U1, U2>& p2);
+			template<class U1, class U2>
+			friend bool operator<=(const pair<U1, U2>& p1, const pair<U1, U2>& p2);
+			template<class U1, class U2>
+			friend bool operator>=(const pair<U1, U2>& p1, const pair<U1, U2>& p2);
+			template<class U1, class U2>
+			friend void swap(pair<U1, U2>& p1, pair<U1, U2>& p2);
 	};
 	template<class T1, class T2>
 	template<class U, class V>
 	pair<T1, T2>::pair(const pair<U, V>& p) : first(p.first), second(p.second) {}
 	template<class T1, class T2>
+	template<class U, class V>
+	pair<T1, T2>::pair(pair<U, V>&& p) : first(std::forward<U>(p.first)), second(std::forward<V>(p.second)) {}
+	template<class T1, class T2>
 	pair<T1, T2>::pair(const first_type& a, const second_type& b) : first(a), second(b) {}
 	template<class T1, class T2>
+	template<class U, class V, class>
+	pair<T1, T2>::pair(U&& a, V&& b) : first(std::forward<U>(a)), second(std::forward<V>(b)) {}
+	template<class T1, class T2>
+	template<class... Args1, class... Args2>
+	pair<T1, T2>::pair(std::piecewise_construct_t, std::tuple<Args1...> a, std::tuple<Args2...> b)
+		: pair(a, b, std::index_sequence_for<Args1...>(), std::index_sequence_for<Args2...>()) {}
+	template<class T1, class T2>
+	template<class Tuple1, class Tuple2, size_t... I1, size_t... I2>
+	pair<T1, T2>::pair(Tuple1& a, Tuple2& b, std::index_sequence<I1...>, std::index_sequence<I2...>)
+		: first(std::get<I1>(std::move(a))...), second(std::get<I2>(std::move(b))...) {}
+	template<class T1, class T2>
 	pair<T1, T2>& pair<T1, T2>::operator =(const pair<T1, T2>& p) {
 		if (this != &p) {
 			first = p.first;
@@ -55,6 +88,12 @@ namespace tinySTL {
 		return *this;
 	}
 	template<class T1, class T2>
+	pair<T1, T2>& pair<T1, T2>::operator =(pair<T1, T2>&& p) {
+		first = std::move(p.first);
+		second = std::move(p.second);
+		return *this;
+	}
+	template<class T1, class T2>
 	void pair<T1, T2>::swap(pair<T1, T2>& p) {
 		tinySTL::swap(first, p.first);
 		tinySTL::swap(second, p.second);
@@ -0,0 +1,946 @@
+#ifndef _VECTOR_H_
+#define _VECTOR_H_
+
+#include "Allocator.h"
+#include "AllocatorTraits.h"
+#include "Iterator.h"
+#include "ReverseIterator.h"
+#include "TypeTraits.h"
+#include "UninitializedFunctions.h"
+#include "Utility.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace tinySTL {
+
+	/*
+	** How a full vector grows. Blocks the pool serves (up to 4 KB) are copied
+	** on every growth, so those double; larger ones are realloced, often in
+	** place, and grow by Num / Den. The default 1.5 also keeps the sum of the
+	** blocks given up so far larger than the next one, so a first-fit heap can
+	** reuse them. Never less than the insertion needs nor than MIN_CAPACITY.
+	*/
+	template<size_t Num = 3, size_t Den = 2>
+	struct vector_growth {
+		static_assert(Den > 0 && Num > Den, "vector_growth: Num / Den must be greater than 1");
+		enum EMinCapacity{ MIN_CAPACITY = 4 };
+		enum ESmallBytes{ SMALL_BYTES = 4096 };
+
+		static size_t next_capacity(size_t capacity, size_t required, size_t elem_size) {
+			size_t grown = capacity * elem_size < size_t(SMALL_BYTES) ? 2 * capacity
+				: capacity + capacity / Den * (Num - Den) + capacity % Den * (Num - Den) / Den;
+			if (grown < capacity) grown = required;	// overflow
+			if (grown < required) grown = required;
+			return grown < size_t(MIN_CAPACITY) ? size_t(MIN_CAPACITY) : grown;
+		}
+	};
+
+	namespace Detail {
+		// the allocator, plus room for N elements inside the object itself
+		template<class T, size_t N, class Alloc>
+		class vec_storage : protected alloc_holder<Alloc> {
+			private:
+				typename std::aligned_storage<sizeof(T), alignof(T)>::type buf_[N];
+			protected:
+				vec_storage() {}
+				explicit vec_storage(const Alloc& alloc) :alloc_holder<Alloc>(alloc) {}
+				T *inlineData() { return reinterpret_cast<T*>(buf_); }
+				bool isInline(const T *p) const { return p == reinterpret_cast<const T*>(buf_); }
+		};
+		template<class T, class Alloc>
+		class vec_storage<T, 0, Alloc> : protected alloc_holder<Alloc> {
+			protected:
+				vec_storage() {}
+				explicit vec_storage(const Alloc& alloc) :alloc_holder<Alloc>(alloc) {}
+				T *inlineData() { return 0; }
+				bool isInline(const T *) const { return false; }
+		};
+
+		/*
+		** vector and small_vector. [start_, finish_) holds the elements and
+		** [finish_, endOfStorage_) is raw. The storage is either the N slots
+		** inside the object (always at first when N > 0) or a block from the
+		** allocator; with N == 0 an empty vector allocates nothing.
+		**
+		** Elements that are is_trivially_relocatable are moved around with
+		** memmove: growth goes through allocator_traits::reallocate, which for
+		** allocator<T> resizes the block in place or reallocs it, and insert
+		** and erase shift the tail with one memmove. This is only done when
+		** the allocator would construct with placement new anyway. Other types
+		** are moved if their move constructor cannot throw and copied otherwise,
+		** so a throwing reallocation leaves the vector as it was.
+		*/
+		template<class T, size_t N, class Alloc, class Growth>
+		class vec_impl : private vec_storage<T, N, Alloc> {
+			public:
+				typedef T value_type;
+				typedef T* iterator;
+				typedef const T* const_iterator;
+				typedef reverse_iterator_t<iterator> reverse_iterator;
+				typedef reverse_iterator_t<const_iterator> const_reverse_iterator;
+				typedef T& reference;
+				typedef const T& const_reference;
+				typedef T* pointer;
+				typedef const T* const_pointer;
+				typedef size_t size_type;
+				typedef ptrdiff_t difference_type;
+				typedef Alloc allocator_type;
+			private:
+				typedef Alloc dataAllocator;
+				typedef allocator_traits<dataAllocator> dataTraits;
+				typedef vec_storage<T, N, Alloc> storage;
+				typedef std::integral_constant<bool, is_trivially_relocatable<T>::value &&
+					uses_placement_new<Alloc, T&&>::value> relocatable;
+			private:
+				T *start_;
+				T *finish_;
+				T *endOfStorage_;
+			public:
+				vec_impl() :storage(), start_(this->inlineData()), finish_(start_), endOfStorage_(start_ + N) {}
+				explicit vec_impl(const allocator_type& alloc)
+					:storage(alloc), start_(this->inlineData()), finish_(start_), endOfStorage_(start_ + N) {}
+				explicit vec_impl(size_type n, const allocator_type& alloc = allocator_type());
+				vec_impl(size_type n, const value_type& value, const allocator_type& alloc = allocator_type());
+				template<class InputIterator>
+				vec_impl(InputIterator first, InputIterator last, const allocator_type& alloc = allocator_type());
+				vec_impl(std::initializer_list<T> list, const allocator_type& alloc = allocator_type());
+				vec_impl(const vec_impl& other);
+				vec_impl(const vec_impl& other, const allocator_type& alloc);
+				vec_impl(vec_impl&& other) noexcept(N == 0 || std::is_nothrow_move_constructible<T>::value);
+				vec_impl(vec_impl&& other, const allocator_type& alloc);
+
+				~vec_impl();
+
+				vec_impl& operator = (const vec_impl& other);
+				vec_impl& operator = (vec_impl&& other);
+				vec_impl& operator = (std::initializer_list<T> list);
+
+				iterator begin() { return start_; }
+				const_iterator begin() const { return start_; }
+				iterator end() { return finish_; }
+				const_iterator end() const { return finish_; }
+				const_iterator cbegin() const { return start_; }
+				const_iterator cend() const { return finish_; }
+				reverse_iterator rbegin() { return reverse_iterator(finish_); }
+				const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+				reverse_iterator rend() { return reverse_iterator(start_); }
+				const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+				allocator_type get_allocator() const { return this->get_alloc(); }
+			public:
+				size_type size() const { return finish_ - start_; }
+				size_type capacity() const { return endOfStorage_ - start_; }
+				size_type max_size() const { return dataTraits::max_size(this->get_alloc()); }
+				bool empty() const { return start_ == finish_; }
+				// the elements are still inside the object
+				bool is_inline() const { return N != 0 && this->isInline(start_); }
+
+				T *data() { return start_; }
+				const T *data() const { return start_; }
+				reference operator[] (size_type n) { return start_[n]; }
+				const_reference operator[] (size_type n) const { return start_[n]; }
+				reference at(size_type n);
+				const_reference at(size_type n) const;
+				reference front() { return *start_; }
+				const_reference front() const { return *start_; }
+				reference back() { return finish_[-1]; }
+				const_reference back() const { return finish_[-1]; }
+
+				void reserve(size_type n);
+				void shrink_to_fit();
+				void resize(size_type n);
+				void resize(size_type n, const value_type& value);
+
+				void push_back(const value_type& value) { emplace_back(value); }
+				void push_back(value_type&& value) { emplace_back(std::move(value)); }
+				template<class... Args>
+				void emplace_back(Args&&... args);
+				// the caller guarantees size() < capacity(), e.g. after reserve
+				void unchecked_push_back(const value_type& value) { unchecked_emplace_back(value); }
+				void unchecked_push_back(value_type&& value) { unchecked_emplace_back(std::move(value)); }
+				template<class... Args>
+				void unchecked_emplace_back(Args&&... args);
+				void pop_back();
+
+				iterator insert(const_iterator pos, const value_type& value) { return emplace(pos, value); }
+				iterator insert(const_iterator pos, value_type&& value) { return emplace(pos, std::move(value)); }
+				iterator insert(const_iterator pos, size_type n, const value_type& value);
+				template<class InputIterator>
+				iterator insert(const_iterator pos, InputIterator first, InputIterator last);
+				iterator insert(const_iterator pos, std::initializer_list<T> list) { return insert(pos, list.begin(), list.end()); }
+				template<class... Args>
+				iterator emplace(const_iterator pos, Args&&... args);
+				iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+				iterator erase(const_iterator first, const_iterator last);
+				void clear();
+				void swap(vec_impl& other);
+
+				void assign(size_type n, const value_type& value);
+				template<class InputIterator>
+				void assign(InputIterator first, InputIterator last);
+				void assign(std::initializer_list<T> list) { assign(list.begin(), list.end()); }
+			private:
+				bool onHeap() const { return start_ != 0 && !this->isInline(start_); }
+				size_type recommend(size_type required) const;
+				void freeStorage();
+				void resetStorage();
+				void adopt(T *p, size_type n, size_type cap);
+				void allocateFor(size_type n);
+				void reallocateTo(size_type cap);
+				void destroyRange(T *first, T *last);
+				void relocateAround(T *p, size_type cap, size_type index, size_type n);
+				void stealFrom(vec_impl& other);
+				void swapData(vec_impl& other);
+				void swapInline(vec_impl& other);
+				void defaultAppend(size_type n);
+				void vec_aux(size_type n, const value_type& value, std::true_type);
+				template<class InputIterator>
+				void vec_aux(InputIterator first, InputIterator last, std::false_type);
+				template<class InputIterator>
+				void range_init(InputIterator first, InputIterator last, input_iterator_tag);
+				template<class ForwardIterator>
+				void range_init(ForwardIterator first, ForwardIterator last, forward_iterator_tag);
+				template<class... Args>
+				void emplace_back_aux(Args&&... args);
+				template<class... Args>
+				void realloc_insert(size_type index, Args&&... args);
+				void insert_one(T *pos, value_type&& value, std::true_type);
+				void insert_one(T *pos, value_type&& value, std::false_type);
+				void fill_insert(size_type index, size_type n, const value_type& value);
+				void insert_aux(size_type index, size_type n, const value_type& value, std::true_type);
+				template<class InputIterator>
+				void insert_aux(size_type index, InputIterator first, InputIterator last, std::false_type);
+				template<class InputIterator>
+				void range_insert(size_type index, InputIterator first, InputIterator last, input_iterator_tag);
+				template<class ForwardIterator>
+				void range_insert(size_type index, ForwardIterator first, ForwardIterator last, forward_iterator_tag);
+				void erase_aux(T *first, T *last, std::true_type);
+				void erase_aux(T *first, T *last, std::false_type);
+				void assign_aux(size_type n, const value_type& value, std::true_type);
+				template<class InputIterator>
+				void assign_aux(InputIterator first, InputIterator last, std::false_type);
+				template<class InputIterator>
+				void assign_range(InputIterator first, InputIterator last, input_iterator_tag);
+				template<class ForwardIterator>
+				void assign_range(ForwardIterator first, ForwardIterator last, forward_iterator_tag);
+		};// class vec_impl
+
+		template<class T, size_t N, class Alloc, class Growth>
+		vec_impl<T, N, Alloc, Growth>::vec_impl(size_type n, const allocator_type& alloc)
+			:storage(alloc), start_(this->inlineData()), finish_(start_), endOfStorage_(start_ + N) {
+			try {
+				defaultAppend(n);
+			}
+			catch (...) {
+				freeStorage();
+				throw;
+			}
+		}
+		template<class T, size_t N, class Alloc, class Growth>
+		vec_impl<T, N, Alloc, Growth>::vec_impl(size_type n, const value_type& value, const allocator_type& alloc)
+			:storage(alloc), start_(this->inlineData()), finish_(start_), endOfStorage_(start_ + N) {
+			vec_aux(n, value, std::true_type());
+		}
+		template<class T, size_t N, class Alloc, class Growth>
+		template<class InputIterator>
+		vec_impl<T, N, Alloc, Growth>::vec_impl(InputIterator first, InputIterator last, const allocator_type& alloc)
+			:storage(alloc), start_(this->inlineData()), finish_(start_), endOfStorage_(start_ + N) {
+			vec_aux(first, last, typename std::is_integral<InputIterator>::type());
+		}
+		template<class T, size_t N, class Alloc, class Growth>
+		vec_impl<T, N, Alloc, Growth>::vec_impl(std::initializer_list<T> list, const allocator_type& alloc)
+			:storage(alloc), start_(this->inlineData()), finish_(start_), endOfStorage_(start_ + N) {
+			range_init(list.begin(), list.end(), forward_iterator_tag());
+		}
+		template<class T, size_t N, class Alloc, class Growth>
+		vec_impl<T, N, Alloc, Growth>::vec_impl(const vec_impl& other)
+			:storage(dataTraits::select_on_container_copy_construction(other.get_alloc())),
+			start_(this->inlineData()), finish_(start_), endOfStorage_(start_ + N) {
+			range_init(other.begin(), other.end(), forward_iterator_tag());
+		}
+		template<class T, size_t N, class Alloc, class Growth>
+		vec_impl<T, N, Alloc, Growth>::vec_impl(const vec_impl& other, const allocator_type& alloc)
+			:storage(alloc), start_(this->inlineData()), finish_(start_), endOfStorage_(start_ + N) {
+			range_init(other.begin(), other.end(), forward_iterator_tag());
+		}
+		template<class T, size_t N, class Alloc, class Growth>
+		vec_impl<T, N, Alloc, Growth>::vec_impl(vec_impl&& other) noexcept(N == 0 || std::is_nothrow_move_constructible<T>::value)
+			:storage(other.get_alloc()), start_(this->inlineData()), finish_(start_), endOfStorage_(start_ + N) {
+			stealFrom(other);
+		}
+		template<class T, size_t N, class Alloc, class Growth>
+		vec_impl<T, N, Alloc, Growth>::vec_impl(vec_impl&& other, const allocator_type& alloc)
+			:storage(alloc), start_(this->inlineData()), finish_(start_), endOfStorage_(start_ + N) {
+			if (dataTraits::is_always_equal::value || this->get_alloc() == other.get_alloc()) {
+				stealFrom(other);
+			}
+			else {
+				// the block belongs to another allocator: move the elements instead
+				range_init(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()), forward_iterator_tag());
+			}
+		}
+		template<class T, size_t N, class Alloc, class Growth>
+		vec_impl<T, N, Alloc, Growth>::~vec_impl() {
+			destroyRange(start_, finish_);
+			freeStorage();
+		}
+
+		template<class T, size_t N, class Alloc, class Growth>
+		vec_impl<T, N, Alloc, Growth>& vec_impl<T, N, Alloc, Growth>::operator = (const vec_impl& other) {
+			if (this != &other) {
+				if (dataTraits::propagate_on_container_copy_assignment::value) {
+					if (this->get_alloc() != other.get_alloc()) {
+						// our block can only go back to the allocator that gave it
+						clear();
+						freeStorage();
+						resetStorage();
+					}
+					this->get_alloc() = other.get_alloc();
+				}
+				assign(other.begin(), other.end());
+			}
+			return *this;
+		}
+		template<class T, size_t N, class Alloc, class Growth>
+		vec_impl<T, N, Alloc, Growth>& vec_impl<T, N, Alloc, Growth>::operator = (vec_impl&& other) {
+			if (this == &other) return *this;
+			if (dataTraits::propagate_on_container_move_assignment::value
+				|| dataTraits::is_always_equal::value || this->get_alloc() == other.get_alloc()) {
+				clear();
+				freeStorage();
+				resetStorage();
+				if (dataTraits::propagate_on_container_move_assignment::value) {
+					this->get_alloc() = other.get_alloc();
+				}
+				stealFrom(other);
+			}
+			else {
+				assign(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+			}
+			return *this;
+		}
+		template<class T, size_t N, class Alloc, class Growth>
+		vec_impl<T, N, Alloc, Growth>& vec_impl<T, N, Alloc, Growth>::operator = (std::initializer_list<T> list) {
+			assign(list.begin(), list.end());
+			return *this;
+		}
+
+		template<class T, size_t N, class Alloc, class Growth>
+		typename vec_impl<T, N, Alloc, Growth>::reference vec_impl<T, N, Alloc, Growth>::at(size_type n) {
+			if (n >= size()) throw std::out_of_range("tinySTL::vector::at");
+			return start_[n];
+		}
+		template<class T, size_t N, class Alloc, class Growth>
+		typename vec_impl<T, N, Alloc, Growth>::const_reference vec_impl<T, N, Alloc, Growth>::at(size_type n) const {
+			if (n >= size()) throw std::out_of_range("tinySTL::vector::at");
+			return start_[n];
+		}
+
+		template<class T, size_t N, class Alloc, class Growth>
+		void vec_impl<T, N, Alloc, Growth>::reserve(size_type n) {
+			if (n <= capacity()) return;
+			if (n > max_size()) throw std::length_error("tinySTL::vector::reserve");
+			reallocateTo(n);
+		}
+		// back into the object if the elements fit there, otherwise a block of exactly size()
+		template<class T, size_t N, class Alloc, class Growth>
+		void vec_impl<T, N, Alloc, Growth>::shrink_to_fit() {
+			if (!onHeap()) return;
+			size_type n = size();
+			if (n <= N) {
+				T *buf = this->inlineData();
+				uninitialized_relocate_a(start_, finish_, buf, this->get_alloc());
+				dataTraits::deallocate(this->get_alloc(), start_, capacity());
+				adopt(buf, n, N);
+			}
+			else if (n < capacity()) {
+				adopt(dataTraits::reallocate(this->get_alloc(), start_, capacity(), n, n), n, n);
+			}
+		}
+		template<class T, size_t N, class Alloc, class Growth>
+		void vec_impl<T, N, Alloc, Growth>::resize(size_type n) {
+			if (n < size()) {
+				erase(start_ + n, finish_);
+			}
+			else {
+				defaultAppend(n - size());
+			}
+		}
+		template<class T, size_t N, class Alloc, class Growth>
+		void vec_impl<T, N, Alloc, Growth>::resize(size_type n, const value_type& value) {
+			if (n < size()) {
+				erase(start_ + n, finish_);
+			}
+			else {
+				fill_insert(size(), n - size(), value);
+			}
+		}
+
+		template<class T, size_t N, class Alloc, class Growth>
+		template<class... Args>
+		inline void vec_impl<T, N, Alloc, Growth>::emplace_back(Args&&... args) {
+			if (finish_ != endOfStorage_) {
+				dataTraits::construct(this->get_alloc(), finish_, std::forward<Args>(args)...);
+				++finish_;
+			}
+			else {
+				emplace_back_aux(std::forward<Args>(args)...);
+			}
+		}
+		template<class T, size_t N, class Alloc, class Growth>
+		template<class... Args>
+		inline void vec_impl<T, N, Alloc, Growth>::unchecked_emplace_back(Args&&... args) {
+			assert(finish_ != endOfStorage_);
+			dataTraits::construct(this->get_alloc(), finish_, std::forward<Args>(args)...);
+			++finish_;
+		}
+		template<class T, size_t N, class Alloc, class Growth>
+		inline void vec_impl<T, N, Alloc, Growth>::pop_back() {
+			--finish_;
+			dataTraits::destroy(this->get_alloc(), finish_);
+		}
+
+		template<class T, size_t N, class Alloc, class Growth>
+		typename vec_impl<T, N, Alloc, Growth>::iterator
+			vec_impl<T, N, Alloc, Growth>::insert(const_iterator pos, size_type n, const value_type& value) {
+			size_type index = pos - start_;
+			fill_insert(index, n, value);
+			return start_ + index;
+		}
+		template<class T, size_t N, class Alloc, class Growth>
+		template<class InputIterator>
+		typename vec_impl<T, N, Alloc, Growth>::iterator
+			vec_impl<T, N, Alloc, Growth>::insert(const_iterator pos, InputIterator first, InputIterator last) {
+			size_type index = pos - start_;
+			insert_aux(index, first, last, typename std::is_integral<InputIterator>::type());
+			return start_ + index;
+		}
+		template<class T, size_t N, class Alloc, class Growth>
+		template<class... Args>
+		typename vec_impl<T, N, Alloc, Growth>::iterator vec_impl<T, N, Alloc, Growth>::emplace(const_iterator pos, Args&&... args) {
+			size_type index = pos - start_;
+			if (finish_ == endOfStorage_) {
+				realloc_insert(index, std::forward<Args>(args)...);
+			}
+			else if (pos == finish_) {
+				dataTraits::construct(this->get_alloc(), finish_, std::forward<Args>(args)...);
+				++finish_;
+			}
+			else {
+				// args may refer to an element that is about to move
+				value_type temp(std::forward<Args>(args)...);
+				insert_one(start_ + index, std::move(temp), relocatable());
+			}
+			return start_ + index;
+		}
+		template<class T, size_t N, class Alloc, class Growth>
+		typename vec_impl<T, N, Alloc, Growth>::iterator vec_impl<T, N, Alloc, Growth>::erase(const_iterator first, const_iterator last) {
+			T *pos = start_ + (first - start_);
+			if (first != last) {
+				erase_aux(pos, start_ + (last - start_), relocatable());
+			}
+			return pos;
+		}
+		template<class T, size_t N, class Alloc, class Growth>
+		void vec_impl<T, N, Alloc, Growth>::clear() {
+			destroyRange(start_, finish_);
+			finish_ = start_;
+		}
+		template<class T, size_t N, class Alloc, class Growth>
+		void vec_impl<T, N, Alloc, Growth>::swap(vec_impl& other) {
+			if (this == &other) return;
+			swapData(other);
+			if (dataTraits::propagate_on_container_swap::value) {
+				tinySTL::swap(this->get_alloc(), other.get_alloc());
+			}
+		}
+
+		template<class T, size_t N, class Alloc, class Growth>
+		void vec_impl<T, N, Alloc, Growth>::assign(size_type n, const value_type& value) {
+			assign_aux(n, value, std::true_type());
+		}
+		template<class T, size_t N, class Alloc, class Growth>
+		template<class InputIterator>
+		void vec_impl<T, N, Alloc, Growth>::assign(InputIterator first, InputIterator last) {
+			assign_aux(first, last, typename std::is_integral<InputIterator>::type());
+		}
+
+		template<class T, size_t N, class Alloc, class Growth>
+		typename vec_impl<T, N, Alloc, Growth>::size_type vec_impl<T, N, Alloc, Growth>::recommend(size_type required) const {
+			const size_type maxSize = max_size();
+			if (required > maxSize) throw std::length_error("tinySTL::vector");
+			size_type cap = Growth::next_capacity(capacity(), required, sizeof(T));
+			return cap > maxSize ? maxSize : cap;
+		}
+		template<class T, size_t N, class Alloc, class Growth>
+		inline void vec_impl<T, N, Alloc, Growth>::freeStorage() {
+			if (onHeap()) {
+				dataTraits::deallocate(this->get_alloc(), start_, capacity());
+			}
+		}
+		template<class T, size_t N, class Alloc, class Growth>
+		inline void vec_impl<T, N, Alloc, Growth>::resetStorage() {
+			start_ = finish_ = this->inlineData();
+			endOfStorage_ = start_ + N;
+		}
+		template<class T, size_t N, class Alloc, class Growth>
+		inline void vec_impl<T, N, Alloc, Growth>::adopt(T *p, size_type n, size_type cap) {
+			start_ = p;
+			finish_ = p + n;
+			endOfStorage_ = p + cap;
+		}
+		// storage for n elements of an empty vector that has none allocated yet
+		template<class T, size_t N, class Alloc, class Growth>
+		inline void vec_impl<T, N, Alloc, Growth>::allocateFor(size_type n) {
+			if (n <= N) return;
+			if (n > max_size()) throw std::length_error("tinySTL::vector");
+			adopt(dataTraits::allocate(this->get_alloc(), n), 0, n);
+		}
+		// cap >= size(); a block already on the heap is resized, so realloc can do the move
+		template<class T, size_t N, class Alloc, class Growth>
+		void vec_impl<T, N, Alloc, Growth>::reallocateTo(size_type cap) {
+			dataAllocator& alloc = this->get_alloc();
+			size_type n = size();
+			if (onHeap()) {
+				adopt(dataTraits::reallocate(alloc, start_, capacity(), cap, n), n, cap);
+				return;
+			}
+			T *p = dataTraits::allocate(alloc, cap);
+			try {
+				uninitialized_relocate_a(start_, finish_, p, alloc);
+			}
+			catch (...) {
+				dataTraits::deallocate(alloc, p, cap);
+				throw;
+			}
+			adopt(p, n, cap);
+		}
+		template<class T, size_t N, class Alloc, class Growth>
+		void vec_impl<T, N, Alloc, Growth>::destroyRange(T *first, T *last) {
+			if (std::is_trivially_destructible<T>::value) return;
+			dataAllocator& alloc = this->get_alloc();
+			for (; first != last; ++first) {
+				dataTraits::destroy(alloc, first);
+			}
+		}
+		/*
+		** p is a new block of cap elements whose [index, index + n) the caller
+		** has constructed: move the elements before pos there and the rest after
+		** them, then give up the old block. If that throws, p is freed and the
+		** vector is untouched.
+		*/
+		template<class T, size_t N, class Alloc, class Growth>
+		void vec_impl<T, N, Alloc, Growth>::relocateAround(T *p, size_type cap, size_type index, size_type n) {
+			dataAllocator& alloc = this->get_alloc();
+			T *cur = p;
+			try {
+				cur = uninitialized_move_if_noexcept_a(start_, start_ + index, p, alloc);
+				uninitialized_move_if_noexcept_a(start_ + index, finish_, p + index + n, alloc);
+			}
+			catch (...) {
+				destroy_constructed_a(p, cur, alloc);
+				destroy_constructed_a(p + index, p + index + n, alloc);
+				dataTraits::deallocate(alloc, p, cap);
+				throw;
+			}
+			size_type count = size() + n;
+			destroyRange(start_, finish_);
+			freeStorage();
+			adopt(p, count, cap);
+		}
+		// other's block if it has one, otherwise its inline elements; other is left empty
+		template<class T, size_t N, class Alloc, class Growth>
+		void vec_impl<T, N, Alloc, Growth>::stealFrom(vec_impl& other) {
+			if (other.onHeap()) {
+				adopt(other.start_, other.size(), other.capacity());
+				other.resetStorage();
+			}
+			else {
+				finish_ = uninitialized_relocate_a(other.start_, other.finish_, start_, this->get_alloc());
+				other.finish_ = other.start_;
+			}
+		}
+		template<class T, size_t N, class Alloc, class Growth>
+		void vec_impl<T, N, Alloc, Growth>::swapData(vec_impl& other) {
+			if (!is_inline() && !other.is_inline()) {
+				tinySTL::swap(start_, other.start_);
+				tinySTL::swap(finish_, other.finish_);
+				tinySTL::swap(endOfStorage_, other.endOfStorage_);
+			}
+			else if (other.is_inline()) {
+				swapInline(other);
+			}
+			else {
+				other.swapInline(*this);
+			}
+		}
+		// other's elements are inline; ours may be anywhere
+		template<class T, size_t N, class Alloc, class Growth>
+		void vec_impl<T, N, Alloc, Growth>::swapInline(vec_impl& other) {
+			dataAllocator& alloc = this->get_alloc();
+			if (!is_inline()) {
+				// our inline slots are free: other's elements go there and other takes our block
+				T *buf = this->inlineData();
+				T *last = uninitialized_relocate_a(other.start_, other.finish_, buf, alloc);
+				other.adopt(start_, size(), capacity());
+				adopt(buf, last - buf, N);
+				return;
+			}
+			vec_impl *small = this, *large = &other;
+			if (small->size() > large->size()) tinySTL::swap(small, large);
+			T *mid = std::swap_ranges(small->start_, small->finish_, large->start_);
+			small->finish_ = uninitialized_relocate_a(mid, large->finish_, small->finish_, alloc);
+			large->finish_ = mid;
+		}
+		template<class T, size_t N, class Alloc, class Growth>
+		void vec_impl<T, N, Alloc, Growth>::defaultAppend(size_type n) {
+			if (size_type(endOfStorage_ - finish_) < n) {
+				reallocateTo(recommend(size() + n));
+			}
+			dataAllocator& alloc = this->get_alloc();
+			T *cur = finish_;
+			try {
+				for (T *last = finish_ + n; cur != last; ++cur) {
+					dataTraits::construct(alloc, cur);
+				}
+			}
+			catch (...) {
+				destroy_constructed_a(finish_, cur, alloc);
+				throw;
+			}
+			finish_ = cur;
+		}
+		template<class T, size_t N, class Alloc, class Growth>
+		void vec_impl<T, N, Alloc, Growth>::vec_aux(size_type n, const value_type& value, std::true_type) {
+			allocateFor(n);
+			try {
+				uninitialized_fill_a(start_, start_ + n, value, this->get_alloc());
+			}
+			catch (...) {
+				freeStorage();
+				throw;
+			}
+			finish_ = start_ + n;
+		}
+		template<class T, size_t N, class Alloc, class Growth>
+		template<class InputIterator>
+		void vec_impl<T, N, Alloc, Growth>::vec_aux(InputIterator first, InputIterator last, std::false_type) {
+			range_init(first, last, typename iterator_traits<InputIterator>::iterator_category());
+		}
+		template<class T, size_t N, class Alloc, class Growth>
+		template<class InputIterator>
+		void vec_impl<T, N, Alloc, Growth>::range_init(InputIterator first, InputIterator last, input_iterator_tag) {
+			try {
+				for (; first != last; ++first) {
+					emplace_back(*first);
+				}
+			}
+			catch (...) {
+				destroyRange(start_, finish_);
+				freeStorage();
+				throw;
+			}
+		}
+		template<class T, size_t N, class Alloc, class Growth>
+		template<class ForwardIterator>
+		void vec_impl<T, N, Alloc, Growth>::range_init(ForwardIterator first, ForwardIterator last, forward_iterator_tag) {
+			allocateFor(tinySTL::distance(first, last));
+			try {
+				finish_ = uninitialized_copy_a(first, last, start_, this->get_alloc());
+			}
+			catch (...) {
+				freeStorage();
+				resetStorage();
+				throw;
+			}
+		}
+
+		// the vector is full
+		template<class T, size_t N, class Alloc, class Growth>
+		template<class... Args>
+		void vec_impl<T, N, Alloc, Growth>::emplace_back_aux(Args&&... args) {
+			realloc_insert(size(), std::forward<Args>(args)...);
+		}
+		/*
+		** Insert into a full vector. Relocatable elements build the new one
+		** aside (args may refer into the vector), let reallocateTo grow the
+		** block, and drop it into the gap. Anything else is built straight into
+		** a new block before the old elements are moved around it.
+		*/
+		template<class T, size_t N, class Alloc, class Growth>
+		template<class... Args>
+		void vec_impl<T, N, Alloc, Growth>::realloc_insert(size_type index, Args&&... args) {
+			size_type cap = recommend(size() + 1);
+			if (relocatable::value) {
+				value_type temp(std::forward<Args>(args)...);
+				reallocateTo(cap);
+				insert_one(start_ + index, std::move(temp), std::true_type());
+				return;
+			}
+			dataAllocator& alloc = this->get_alloc();
+			T *p = dataTraits::allocate(alloc, cap);
+			try {
+				dataTraits::construct(alloc, p + index, std::forward<Args>(args)...);
+			}
+			catch (...) {
+				dataTraits::deallocate(alloc, p, cap);
+				throw;
+			}
+			relocateAround(p, cap, index, 1);
+		}
+		// there is room for one more; shift the tail by memmove
+		template<class T, size_t N, class Alloc, class Growth>
+		void vec_impl<T, N, Alloc, Growth>::insert_one(T *pos, value_type&& value, std::true_type) {
+			size_type tail = finish_ - pos;
+			if (tail != 0) memmove(static_cast<void*>(pos + 1), pos, tail * sizeof(T));
+			try {
+				dataTraits::construct(this->get_alloc(), pos, std::move(value));
+			}
+			catch (...) {
+				if (tail != 0) memmove(static_cast<void*>(pos), pos + 1, tail * sizeof(T));
+				throw;
+			}
+			++finish_;
+		}
+		template<class T, size_t N, class Alloc, class Growth>
+		void vec_impl<T, N, Alloc, Growth>::insert_one(T *pos, value_type&& value, std::false_type) {
+			if (pos == finish_) {
+				dataTraits::construct(this->get_alloc(), finish_, std::move(value));
+				++finish_;
+				return;
+			}
+			dataTraits::construct(this->get_alloc(), finish_, std::move(finish_[-1]));
+			++finish_;
+			std::move_backward(pos, finish_ - 2, finish_ - 1);
+			*pos = std::move(value);
+		}
+		/*
+		** Multi-element inserts. With room to spare, relocatable elements open
+		** a gap with memmove (closed again if a constructor throws); other
+		** types are constructed at the end and rotated into place.
+		*/
+		template<class T, size_t N, class Alloc, class Growth>
+		void vec_impl<T, N, Alloc, Growth>::fill_insert(size_type index, size_type n, const value_type& value) {
+			if (n == 0) return;
+			dataAllocator& alloc = this->get_alloc();
+			value_type temp(value);	// value may be one of the elements
+			if (size_type(endOfStorage_ - finish_) < n) {
+				size_type cap = recommend(size() + n);
+				if (!relocatable::value) {
+					T *p = dataTraits::allocate(alloc, cap);
+					try {
+						uninitialized_fill_a(p + index, p + index + n, temp, alloc);
+					}
+					catch (...) {
+						dataTraits::deallocate(alloc, p, cap);
+						throw;
+					}
+					relocateAround(p, cap, index, n);
+					return;
+				}
+				reallocateTo(cap);
+			}
+			T *pos = start_ + index;
+			if (relocatable::value) {
+				size_type tail = finish_ - pos;
+				if (tail != 0) memmove(static_cast<void*>(pos + n), pos, tail * sizeof(T));
+				try {
+					uninitialized_fill_a(pos, pos + n, temp, alloc);
+				}
+				catch (...) {
+					if (tail != 0) memmove(static_cast<void*>(pos), pos + n, tail * sizeof(T));
+					throw;
+				}
+				finish_ += n;
+			}
+			else {
+				T *oldFinish = finish_;
+				uninitialized_fill_a(finish_, finish_ + n, temp, alloc);
+				finish_ += n;
+				std::rotate(pos, oldFinish, finish_);
+			}
+		}
+		template<class T, size_t N, class Alloc, class Growth>
+		void vec_impl<T, N, Alloc, Growth>::insert_aux(size_type index, size_type n, const value_type& value, std::true_type) {
+			fill_insert(index, n, value);
+		}
+		template<class T, size_t N, class Alloc, class Growth>
+		template<class InputIterator>
+		void vec_impl<T, N, Alloc, Growth>::insert_aux(size_type index, InputIterator first, InputIterator last, std::false_type) {
+			range_insert(index, first, last, typename iterator_traits<InputIterator>::iterator_category());
+		}
+		// single pass: append, then rotate into place
+		template<class T, size_t N, class Alloc, class Growth>
+		template<class InputIterator>
+		void vec_impl<T, N, Alloc, Growth>::range_insert(size_type index, InputIterator first, InputIterator last, input_iterator_tag) {
+			size_type oldSize = size();
+			for (; first != last; ++first) {
+				emplace_back(*first);
+			}
+			std::rotate(start_ + index, start_ + oldSize, finish_);
+		}
+		template<class T, size_t N, class Alloc, class Growth>
+		template<class ForwardIterator>
+		void vec_impl<T, N, Alloc, Growth>::range_insert(size_type index, ForwardIterator first, ForwardIterator last, forward_iterator_tag) {
+			size_type n = tinySTL::distance(first, last);
+			if (n == 0) return;
+			dataAllocator& alloc = this->get_alloc();
+			if (size_type(endOfStorage_ - finish_) < n) {
+				size_type cap = recommend(size() + n);
+				if (!relocatable::value) {
+					T *p = dataTraits::allocate(alloc, cap);
+					try {
+						uninitialized_copy_a(first, last, p + index, alloc);
+					}
+					catch (...) {
+						dataTraits::deallocate(alloc, p, cap);
+						throw;
+					}
+					relocateAround(p, cap, index, n);
+					return;
+				}
+				reallocateTo(cap);
+			}
+			T *pos = start_ + index;
+			if (relocatable::value) {
+				size_type tail = finish_ - pos;
+				if (tail != 0) memmove(static_cast<void*>(pos + n), pos, tail * sizeof(T));
+				try {
+					uninitialized_copy_a(first, last, pos, alloc);
+				}
+				catch (...) {
+					if (tail != 0) memmove(static_cast<void*>(pos), pos + n, tail * sizeof(T));
+					throw;
+				}
+				finish_ += n;
+			}
+			else {
+				T *oldFinish = finish_;
+				uninitialized_copy_a(first, last, finish_, alloc);
+				finish_ += n;
+				std::rotate(pos, oldFinish, finish_);
+			}
+		}
+		template<class T, size_t N, class Alloc, class Growth>
+		void vec_impl<T, N, Alloc, Growth>::erase_aux(T *first, T *last, std::true_type) {
+			destroyRange(first, last);
+			size_type tail = finish_ - last;
+			if (tail != 0) memmove(static_cast<void*>(first), last, tail * sizeof(T));
+			finish_ -= last - first;
+		}
+		template<class T, size_t N, class Alloc, class Growth>
+		void vec_impl<T, N, Alloc, Growth>::erase_aux(T *first, T *last, std::false_type) {
+			T *newFinish = std::move(last, finish_, first);
+			destroyRange(newFinish, finish_);
+			finish_ = newFinish;
+		}
+		template<class T, size_t N, class Alloc, class Growth>
+		void vec_impl<T, N, Alloc, Growth>::assign_aux(size_type n, const value_type& value, std::true_type) {
+			if (n > capacity()) {
+				vec_impl temp(n, value, this->get_alloc());
+				swapData(temp);
+			}
+			else if (n > size()) {
+				std::fill(start_, finish_, value);
+				uninitialized_fill_a(finish_, start_ + n, value, this->get_alloc());
+				finish_ = start_ + n;
+			}
+			else {
+				std::fill(start_, start_ + n, value);
+				erase(start_ + n, finish_);
+			}
+		}
+		template<class T, size_t N, class Alloc, class Growth>
+		template<class InputIterator>
+		void vec_impl<T, N, Alloc, Growth>::assign_aux(InputIterator first, InputIterator last, std::false_type) {
+			assign_range(first, last, typename iterator_traits<InputIterator>::iterator_category());
+		}
+		template<class T, size_t N, class Alloc, class Growth>
+		template<class InputIterator>
+		void vec_impl<T, N, Alloc, Growth>::assign_range(InputIterator first, InputIterator last, input_iterator_tag) {
+			T *cur = start_;
+			for (; first != last && cur != finish_; ++cur, ++first) {
+				*cur = *first;
+			}
+			if (first == last) {
+				erase(cur, finish_);
+			}
+			else {
+				range_insert(size(), first, last, input_iterator_tag());
+			}
+		}
+		template<class T, size_t N, class Alloc, class Growth>
+		template<class ForwardIterator>
+		void vec_impl<T, N, Alloc, Growth>::assign_range(ForwardIterator first, ForwardIterator last, forward_iterator_tag) {
+			size_type len = tinySTL::distance(first, last);
+			if (len > capacity()) {
+				// nothing to keep: free the old block before taking the new one
+				clear();
+				freeStorage();
+				resetStorage();
+				range_init(first, last, forward_iterator_tag());
+			}
+			else if (len > size()) {
+				ForwardIterator mid = first;
+				tinySTL::advance(mid, size());
+				std::copy(first, mid, start_);
+				finish_ = uninitialized_copy_a(mid, last, finish_, this->get_alloc());
+			}
+			else {
+				erase(std::copy(first, last, start_), finish_);
+			}
+		}
+	}// namespace Detail
+
+	// contiguous dynamic array; Growth decides how much a full vector grows
+	template<class T, class Alloc = allocator<T>, class Growth = vector_growth<> >
+	class vector : public Detail::vec_impl<T, 0, Alloc, Growth> {
+		private:
+			typedef Detail::vec_impl<T, 0, Alloc, Growth> base;
+		public:
+			using base::base;
+			using base::operator =;
+			vector() {}
+	};
+
+	// a vector that keeps up to N elements inside the object before it allocates
+	template<class T, size_t N, class Alloc = allocator<T>, class Growth = vector_growth<> >
+	class small_vector : public Detail::vec_impl<T, N, Alloc, Growth> {
+		private:
+			typedef Detail::vec_impl<T, N, Alloc, Growth> base;
+		public:
+			static const size_t inline_capacity = N;
+
+			using base::base;
+			using base::operator =;
+			small_vector() {}
+	};
+	template<class T, size_t N, class Alloc, class Growth>
+	const size_t small_vector<T, N, Alloc, Growth>::inline_capacity;
+
+	template<class T, size_t N, class Alloc, class Growth>
+	bool operator ==(const Detail::vec_impl<T, N, Alloc, Growth>& v1, const Detail::vec_impl<T, N, Alloc, Growth>& v2) {
+		return v1.size() == v2.size() && std::equal(v1.begin(), v1.end(), v2.begin());
+	}
+	template<class T, size_t N, class Alloc, class Growth>
+	bool operator !=(const Detail::vec_impl<T, N, Alloc, Growth>& v1, const Detail::vec_impl<T, N, Alloc, Growth>& v2) {
+		return !(v1 == v2);
+	}
+	template<class T, class Alloc, class Growth>
+	void swap(vector<T, Alloc, Growth>& v1, vector<T, Alloc, Growth>& v2) {
+		v1.swap(v2);
+	}
+	template<class T, size_t N, class Alloc, class Growth>
+	void swap(small_vector<T, N, Alloc, Growth>& v1, small_vector<T, N, Alloc, Growth>& v2) {
+		v1.swap(v2);
+	}
+} // namespace tinySTL
+
+#endif // _VECTOR_H_
@@ -1,11 +1,17 @@
 ﻿// tinySTL.cpp : 此文件包含 "main" 函数。程序执行将在此处开始并结束。
 //
 
+#include "Test/Test.h"
+
 #include <iostream>
 
 int main()
 {
-    std::cout << "Hello World!\n";
+    tinySTL::Test::testAlloc();
+    tinySTL::Test::testBTree();
+    tinySTL::Test::testConstruct();
+    tinySTL::Test::testUnorderedMap();
+    std::cout << "All tests passed.\n";
 }
 
 // 运行程序: Ctrl + F5 或调试 >“开始执行(不调试)”菜单